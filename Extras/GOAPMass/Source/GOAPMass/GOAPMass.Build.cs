@@ -0,0 +1,24 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+using UnrealBuildTool;
+
+public class GOAPMass : ModuleRules
+{
+	public GOAPMass(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"GameplayTags",
+				"GOAP",
+				"MassEntity",
+				"MassSpawner"
+			}
+			);
+	}
+}
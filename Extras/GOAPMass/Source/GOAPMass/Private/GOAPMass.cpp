@@ -0,0 +1,17 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPMass.h"
+
+#define LOCTEXT_NAMESPACE "FGOAPMassModule"
+
+void FGOAPMassModule::StartupModule()
+{
+}
+
+void FGOAPMassModule::ShutdownModule()
+{
+}
+
+#undef LOCTEXT_NAMESPACE
+	
+IMPLEMENT_MODULE(FGOAPMassModule, GOAPMass)
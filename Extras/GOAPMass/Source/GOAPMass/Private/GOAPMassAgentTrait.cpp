@@ -0,0 +1,37 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPMassAgentTrait.h"
+
+#include "GOAPMassDomain.h"
+#include "GOAPMassFragments.h"
+#include "GOAPTypes.h"
+#include "MassEntityTemplateRegistry.h"
+#include "MassEntityUtils.h"
+
+void UGOAPMassAgentTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+	if(!Domain)
+	{
+		UE_LOG(LogGOAP, Warning, TEXT("%s: GOAP agent trait has no domain."), *GetName());
+		return;
+	}
+
+	// domain is shared by all agents, so its actions are grounded once
+	if(!Domain->IsInitialized())
+	{
+		Domain->Initialize();
+	}
+
+	FGOAPMassWorldStateFragment& WorldState = BuildContext.AddFragment_GetRef<FGOAPMassWorldStateFragment>();
+	WorldState.State = Domain->GetActionsProblem().InitialState;
+	FGOAPMassGoalFragment& Goal = BuildContext.AddFragment_GetRef<FGOAPMassGoalFragment>();
+	Goal.DisabledGoals.Init(false, Domain->GetGoalsNum());
+	BuildContext.AddFragment<FGOAPMassPlanFragment>();
+	BuildContext.AddFragment<FGOAPMassMemoryFragment>();
+
+	FMassEntityManager& EntityManager = UE::Mass::Utils::GetEntityManagerChecked(World);
+	FGOAPMassDomainSharedFragment DomainFragment;
+	DomainFragment.Domain = Domain;
+	const FConstSharedStruct DomainSharedFragment = EntityManager.GetOrCreateConstSharedFragment(DomainFragment);
+	BuildContext.AddConstSharedFragment(DomainSharedFragment);
+}
@@ -0,0 +1,184 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPMassDomain.h"
+
+#include "GOAPAction.h"
+#include "GOAPHookProfiler.h"
+#include "GOAPMassFragments.h"
+#include "GOAPStats.h"
+#include "GOAPWorldStatePayloads.h"
+
+void UGOAPMassDomain::Initialize()
+{
+	LLM_SCOPE_BYTAG(GOAP);
+	check(IsInGameThread());
+
+	ActionsProblem.Reset();
+	Keys.Reset();
+	KeysIndexes.Reset();
+	Values.Reset();
+	NumericValues.Reset();
+	NumericValuesValid.Reset();
+
+	// actions are grounded once, without agent - the same way as solvers ground them for each search
+	for(int32 ActionIndex = 0; ActionIndex < Actions.Num(); ++ActionIndex)
+	{
+		UObject* Action = Actions[ActionIndex] ? Actions[ActionIndex]->GetDefaultObject() : nullptr;
+		if(!Action || !Action->Implements<UGOAPAction>())
+		{
+			UE_LOG(LogGOAP, Warning, TEXT("%s: action %d doesn't implement IGOAPAction and is ignored."), *GetName(),
+				ActionIndex);
+			continue;
+		}
+
+		FGOAPWorldStateData Effect;
+		bool bHasEffect;
+		{
+			GOAP_HOOK_SCOPE(Action, ActionEffect);
+			bHasEffect = IGOAPAction::Execute_GetActionEffectWithContextActor(Action, nullptr, nullptr, Effect);
+		}
+		if(!bHasEffect)
+			continue;
+
+		TArray<FGOAPWorldStateData> Preconditions;
+		{
+			GOAP_HOOK_SCOPE(Action, ActionPreconditions);
+			Preconditions = IGOAPAction::Execute_GetWorldStatePreconditions(Action, Effect, nullptr);
+		}
+		int32 Cost;
+		{
+			GOAP_HOOK_SCOPE(Action, ActionCost);
+			Cost = IGOAPAction::Execute_GetActionCost(Action, Effect, nullptr, TArray<FGOAPWorldStateData>());
+		}
+
+		FGOAPCoreAction& CoreAction = ActionsProblem.Actions.AddDefaulted_GetRef();
+		CoreAction.ActionIndex = ActionIndex;
+		CoreAction.Effect = FGOAPCoreFact(InternKey(Effect.WorldStateKey.WorldStateDataTag),
+			InternValue(Effect.WorldStateValue.Payload));
+		CoreAction.Cost = Cost;
+		for(const FGOAPWorldStateData& Precondition : Preconditions)
+		{
+			CoreAction.Preconditions.Add(FGOAPCoreFact(InternKey(Precondition.WorldStateKey.WorldStateDataTag),
+				InternValue(Precondition.WorldStateValue.Payload)));
+		}
+	}
+
+	// goals' conditions and scores inputs are agent's world state as well
+	for(const FGOAPMassGoalDefinition& Goal : Goals)
+	{
+		for(const FGOAPWorldStateCondition& Condition : Goal.Conditions)
+		{
+			InternKey(Condition.WorldState.WorldStateKey.WorldStateDataTag);
+		}
+		for(const FGOAPUtilityConsideration& Consideration : Goal.UtilityConsiderations)
+		{
+			InternKey(Consideration.WorldStateTag);
+		}
+	}
+
+	ActionsProblem.InitialState.Init(InternValue(nullptr), Keys.Num());
+	ActionsProblem.KeysActors.Init(0, Keys.Num());
+	CompileGoals();
+	bInitialized = true;
+}
+
+UObject* UGOAPMassDomain::GetActionObject(int32 ProblemActionIndex) const
+{
+	const int32 ActionIndex = ActionsProblem.Actions[ProblemActionIndex].ActionIndex;
+	return Actions[ActionIndex] ? Actions[ActionIndex]->GetDefaultObject() : nullptr;
+}
+
+int32 UGOAPMassDomain::GetGoalUnsatisfiedConditionsNum(int32 GoalIndex, const FGOAPCoreState& State) const
+{
+	return FGOAPPlanningProblem::GetUnsatisfiedConditionsNum(GoalsConditions[GoalIndex], Goals[GoalIndex].Junction,
+		State);
+}
+
+int32 UGOAPMassDomain::FindKey(const FGameplayTag& Tag) const
+{
+	const int32* KeyIndex = KeysIndexes.Find(Tag);
+	return KeyIndex ? *KeyIndex : INDEX_NONE;
+}
+
+bool UGOAPMassDomain::GetNumericValue(int32 ValueIndex, double& OutValue) const
+{
+	if(!NumericValuesValid.IsValidIndex(ValueIndex) || !NumericValuesValid[ValueIndex])
+		return false;
+
+	OutValue = NumericValues[ValueIndex];
+	return true;
+}
+
+bool UGOAPMassDomain::SetWorldStateValue(FGOAPMassWorldStateFragment& WorldState, const FGameplayTag& Tag,
+	UGOAPWorldStatePayload* Value)
+{
+	check(IsInGameThread());
+
+	const int32 KeyIndex = FindKey(Tag);
+	if(KeyIndex == INDEX_NONE)
+		return false;
+
+	if(WorldState.State.Num() != Keys.Num())
+	{
+		WorldState.State = ActionsProblem.InitialState;
+	}
+	WorldState.State[KeyIndex] = InternValue(Value);
+	return true;
+}
+
+int32 UGOAPMassDomain::InternKey(const FGameplayTag& Tag)
+{
+	if(const int32* KeyIndex = KeysIndexes.Find(Tag))
+		return *KeyIndex;
+
+	const int32 KeyIndex = Keys.Add(Tag);
+	KeysIndexes.Add(Tag, KeyIndex);
+	return KeyIndex;
+}
+
+int32 UGOAPMassDomain::InternValue(UGOAPWorldStatePayload* Payload)
+{
+	// values are compared by payloads, so equal values of different payload objects share index
+	const int32 ExistingIndex = Values.IndexOfByPredicate([Payload](UGOAPWorldStatePayload* Value)
+	{
+		return Value == Payload || (Value && Value->IsEqual(Payload));
+	});
+	if(ExistingIndex != INDEX_NONE)
+		return ExistingIndex;
+
+	const int32 ValueIndex = Values.Add(Payload);
+	double NumericValue = 0.0;
+	NumericValuesValid.Add(Payload && Payload->GetNumericValue(NumericValue));
+	NumericValues.Add(NumericValue);
+
+	// goals' conditions tables have to cover new value
+	if(bInitialized)
+	{
+		CompileGoals();
+	}
+	return ValueIndex;
+}
+
+void UGOAPMassDomain::CompileGoals()
+{
+	GoalsConditions.SetNum(Goals.Num());
+	for(int32 GoalIndex = 0; GoalIndex < Goals.Num(); ++GoalIndex)
+	{
+		FGOAPGoalPredicate Predicate;
+		Predicate.Compile(Goals[GoalIndex].Conditions, Goals[GoalIndex].Junction, nullptr);
+
+		TArray<FGOAPCoreCondition>& Conditions = GoalsConditions[GoalIndex];
+		Conditions.Reset();
+		for(const FGOAPGoalPredicate::FInstruction& Instruction : Predicate.Instructions)
+		{
+			FGOAPCoreCondition& Condition = Conditions.AddDefaulted_GetRef();
+			Condition.Key = FindKey(Predicate.Keys[Instruction.KeyIndex].WorldStateDataTag);
+			Condition.SatisfyingValues.Init(false, Values.Num());
+			for(int32 ValueIndex = 0; ValueIndex < Values.Num(); ++ValueIndex)
+			{
+				Condition.SatisfyingValues[ValueIndex] = FGOAPGoalPredicate::EvaluateInstruction(Instruction,
+					Values[ValueIndex]);
+			}
+		}
+	}
+}
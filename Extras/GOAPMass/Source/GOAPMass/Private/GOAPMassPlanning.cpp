@@ -0,0 +1,24 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPMassPlanning.h"
+
+EGOAPMassPlanningResult GOAPMass::FindAgentPlan(const FAgentProblem& Problem, double MaxSearchTime,
+	TArray<int32>& OutPlan)
+{
+	OutPlan.Reset();
+	if(Problem.GetUnsatisfiedConditionsNum(Problem.GetInitialState()) == 0)
+		return EGOAPMassPlanningResult::Satisfied;
+
+	FGOAPSearchCancellation Cancellation;
+	Cancellation.Deadline = FPlatformTime::Seconds() + FMath::Max(MaxSearchTime, 0.0);
+	FGOAPPlanningCore PlanningCore;
+	PlanningCore.Cancellation = &Cancellation;
+
+	FGOAPCoreSearchResult Result;
+	PlanningCore.SearchForward(Problem, Result);
+	if(Result.Plan.Num() == 0)
+		return EGOAPMassPlanningResult::Unreachable;
+
+	OutPlan = MoveTemp(Result.Plan);
+	return EGOAPMassPlanningResult::Found;
+}
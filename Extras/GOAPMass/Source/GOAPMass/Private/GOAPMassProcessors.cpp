@@ -0,0 +1,278 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPMassProcessors.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GOAPMassDomain.h"
+#include "GOAPMassFragments.h"
+#include "GOAPMassPlanning.h"
+#include "GOAPStats.h"
+#include "GOAPUtilityScoring.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+
+UGOAPMassGoalScoringProcessor::UGOAPMassGoalScoringProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::All);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Tasks;
+	// domain's tables can be changed by gameplay at any time (UGOAPMassDomain::SetWorldStateValue is game thread only)
+	bRequiresGameThreadExecution = true;
+}
+
+void UGOAPMassGoalScoringProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FGOAPMassWorldStateFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FGOAPMassGoalFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FGOAPMassPlanFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FGOAPMassDomainSharedFragment>(EMassFragmentPresence::All);
+}
+
+void UGOAPMassGoalScoringProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GOAP_GoalsScoring);
+	LLM_SCOPE_BYTAG(GOAP);
+
+	const UWorld* World = EntityManager.GetWorld();
+	const double Time = World ? World->GetTimeSeconds() : 0.0;
+
+	FGOAPUtilityScoringBatch ScoringBatch;
+	TArray<int32> BatchAgents;
+	TArray<int32> BatchGoals;
+	TArray<float> Scores;
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const UGOAPMassDomain* Domain = ChunkContext.GetConstSharedFragment<FGOAPMassDomainSharedFragment>().Domain;
+		if(!Domain || !Domain->IsInitialized())
+			return;
+
+		const TConstArrayView<FGOAPMassWorldStateFragment> WorldStates =
+			ChunkContext.GetFragmentView<FGOAPMassWorldStateFragment>();
+		const TArrayView<FGOAPMassGoalFragment> Goals = ChunkContext.GetMutableFragmentView<FGOAPMassGoalFragment>();
+		const TArrayView<FGOAPMassPlanFragment> Plans = ChunkContext.GetMutableFragmentView<FGOAPMassPlanFragment>();
+
+		// valid goals of all agents of chunk are scored in one batch
+		ScoringBatch.Reset();
+		BatchAgents.Reset();
+		BatchGoals.Reset();
+		for(int32 AgentIndex = 0; AgentIndex < ChunkContext.GetNumEntities(); ++AgentIndex)
+		{
+			FGOAPMassGoalFragment& Goal = Goals[AgentIndex];
+			if(Time < Goal.NextScoringTime)
+				continue;
+			Goal.NextScoringTime = Time + ScoringInterval;
+
+			const FGOAPCoreState& State = WorldStates[AgentIndex].State;
+			const auto InputReader = [Domain, &State](const FGameplayTag& WorldStateTag, double& OutValue)
+			{
+				const int32 KeyIndex = Domain->FindKey(WorldStateTag);
+				return State.IsValidIndex(KeyIndex) && Domain->GetNumericValue(State[KeyIndex], OutValue);
+			};
+			for(int32 GoalIndex = 0; GoalIndex < Domain->GetGoalsNum(); ++GoalIndex)
+			{
+				const bool bDisabled = Goal.DisabledGoals.IsValidIndex(GoalIndex) && Goal.DisabledGoals[GoalIndex];
+				const bool bUnreachable = GoalIndex == Goal.UnreachableGoalIndex &&
+					Time < Goal.UnreachableGoalRetryTime;
+				if(bDisabled || bUnreachable || Domain->GetGoalUnsatisfiedConditionsNum(GoalIndex, State) == 0)
+					continue;
+
+				ScoringBatch.AddGoal(Domain->GetGoal(GoalIndex).UtilityConsiderations, InputReader);
+				BatchAgents.Add(AgentIndex);
+				BatchGoals.Add(GoalIndex);
+			}
+
+			// agent without valid goals stops pursuing previous one
+			if(BatchAgents.Num() == 0 || BatchAgents.Last() != AgentIndex)
+			{
+				if(Goal.PursuedGoalIndex != INDEX_NONE)
+				{
+					Goal.PursuedGoalIndex = INDEX_NONE;
+					Plans[AgentIndex].Reset();
+				}
+			}
+		}
+		if(ScoringBatch.Num() == 0)
+			return;
+
+		ScoringBatch.Evaluate(Scores);
+
+		// batch entries of one agent are continuous, so the best goal is chosen in single pass
+		for(int32 First = 0; First < Scores.Num();)
+		{
+			const int32 AgentIndex = BatchAgents[First];
+			int32 BestGoal = INDEX_NONE;
+			float BestScore = 0.0f;
+			int32 Index = First;
+			for(; Index < Scores.Num() && BatchAgents[Index] == AgentIndex; ++Index)
+			{
+				if(Scores[Index] > BestScore)
+				{
+					BestScore = Scores[Index];
+					BestGoal = BatchGoals[Index];
+				}
+			}
+			First = Index;
+
+			FGOAPMassGoalFragment& Goal = Goals[AgentIndex];
+			if(BestGoal == Goal.PursuedGoalIndex)
+				continue;
+
+			Goal.PursuedGoalIndex = BestGoal;
+			Plans[AgentIndex].Reset();
+			if(BestGoal != INDEX_NONE)
+			{
+				ChunkContext.Defer().AddTag<FGOAPMassNeedsPlanTag>(ChunkContext.GetEntity(AgentIndex));
+			}
+		}
+	});
+}
+
+UGOAPMassPlanningProcessor::UGOAPMassPlanningProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::All);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Tasks;
+	ExecutionOrder.ExecuteAfter.Add(UGOAPMassGoalScoringProcessor::StaticClass()->GetFName());
+	bRequiresGameThreadExecution = true;
+}
+
+void UGOAPMassPlanningProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FGOAPMassWorldStateFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FGOAPMassGoalFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FGOAPMassPlanFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FGOAPMassDomainSharedFragment>(EMassFragmentPresence::All);
+	EntityQuery.AddTagRequirement<FGOAPMassNeedsPlanTag>(EMassFragmentPresence::All);
+}
+
+void UGOAPMassPlanningProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GOAP_FindPlan);
+	LLM_SCOPE_BYTAG(GOAP_Plans);
+
+	int32 RemainingPlans = MaxPlansPerFrame > 0 ? MaxPlansPerFrame : MAX_int32;
+	const UWorld* World = EntityManager.GetWorld();
+	const double Time = World ? World->GetTimeSeconds() : 0.0;
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		if(RemainingPlans <= 0)
+			return;
+
+		const UGOAPMassDomain* Domain = ChunkContext.GetConstSharedFragment<FGOAPMassDomainSharedFragment>().Domain;
+		if(!Domain || !Domain->IsInitialized())
+			return;
+
+		const TConstArrayView<FGOAPMassWorldStateFragment> WorldStates =
+			ChunkContext.GetFragmentView<FGOAPMassWorldStateFragment>();
+		const TArrayView<FGOAPMassGoalFragment> Goals = ChunkContext.GetMutableFragmentView<FGOAPMassGoalFragment>();
+		const TArrayView<FGOAPMassPlanFragment> Plans = ChunkContext.GetMutableFragmentView<FGOAPMassPlanFragment>();
+
+		const int32 AgentsNum = FMath::Min(ChunkContext.GetNumEntities(), RemainingPlans);
+		RemainingPlans -= AgentsNum;
+
+		// each search writes only its agent's fragments, domain is read only
+		ParallelFor(AgentsNum, [&](int32 AgentIndex)
+		{
+			FGOAPMassGoalFragment& Goal = Goals[AgentIndex];
+			FGOAPMassPlanFragment& Plan = Plans[AgentIndex];
+			Plan.Reset();
+			if(Goal.PursuedGoalIndex == INDEX_NONE)
+				return;
+
+			const GOAPMass::FAgentProblem Problem(Domain->GetActionsProblem(), WorldStates[AgentIndex].State,
+				Domain->GetGoalConditions(Goal.PursuedGoalIndex), Domain->GetGoal(Goal.PursuedGoalIndex).Junction);
+			const EGOAPMassPlanningResult Result = GOAPMass::FindAgentPlan(Problem, MaxSearchTime, Plan.Plan);
+			if(Result == EGOAPMassPlanningResult::Found)
+				return;
+
+			// goal scoring chooses again; goal without plan isn't chosen until UnreachableGoalRetryInterval passes,
+			// so it isn't searched again in every frame
+			if(Result == EGOAPMassPlanningResult::Unreachable)
+			{
+				Goal.UnreachableGoalIndex = Goal.PursuedGoalIndex;
+				Goal.UnreachableGoalRetryTime = Time + UnreachableGoalRetryInterval;
+			}
+			Goal.PursuedGoalIndex = INDEX_NONE;
+			Goal.NextScoringTime = 0.0;
+		});
+
+		for(int32 AgentIndex = 0; AgentIndex < AgentsNum; ++AgentIndex)
+		{
+			ChunkContext.Defer().RemoveTag<FGOAPMassNeedsPlanTag>(ChunkContext.GetEntity(AgentIndex));
+		}
+	});
+}
+
+UGOAPMassPlanSteppingProcessor::UGOAPMassPlanSteppingProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::All);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Tasks;
+	ExecutionOrder.ExecuteAfter.Add(UGOAPMassPlanningProcessor::StaticClass()->GetFName());
+	bRequiresGameThreadExecution = true;
+}
+
+void UGOAPMassPlanSteppingProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FGOAPMassWorldStateFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FGOAPMassGoalFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FGOAPMassPlanFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FGOAPMassDomainSharedFragment>(EMassFragmentPresence::All);
+	EntityQuery.AddTagRequirement<FGOAPMassNeedsPlanTag>(EMassFragmentPresence::None);
+}
+
+void UGOAPMassPlanSteppingProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GOAP_PlanExecution);
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [](FMassExecutionContext& ChunkContext)
+	{
+		const UGOAPMassDomain* Domain = ChunkContext.GetConstSharedFragment<FGOAPMassDomainSharedFragment>().Domain;
+		if(!Domain || !Domain->IsInitialized())
+			return;
+
+		const FGOAPPlanningProblem& ActionsProblem = Domain->GetActionsProblem();
+		const TConstArrayView<FGOAPMassWorldStateFragment> WorldStates =
+			ChunkContext.GetFragmentView<FGOAPMassWorldStateFragment>();
+		const TArrayView<FGOAPMassGoalFragment> Goals = ChunkContext.GetMutableFragmentView<FGOAPMassGoalFragment>();
+		const TArrayView<FGOAPMassPlanFragment> Plans = ChunkContext.GetMutableFragmentView<FGOAPMassPlanFragment>();
+
+		for(int32 AgentIndex = 0; AgentIndex < ChunkContext.GetNumEntities(); ++AgentIndex)
+		{
+			FGOAPMassGoalFragment& Goal = Goals[AgentIndex];
+			FGOAPMassPlanFragment& Plan = Plans[AgentIndex];
+			if(Goal.PursuedGoalIndex == INDEX_NONE || !Plan.HasPlan())
+				continue;
+
+			const FGOAPCoreState& State = WorldStates[AgentIndex].State;
+			if(State.Num() != ActionsProblem.InitialState.Num())
+				continue;
+
+			if(Domain->GetGoalUnsatisfiedConditionsNum(Goal.PursuedGoalIndex, State) == 0)
+			{
+				// goal is achieved - next one is chosen by goal scoring
+				Goal.PursuedGoalIndex = INDEX_NONE;
+				Goal.NextScoringTime = 0.0;
+				Plan.Reset();
+				continue;
+			}
+
+			// skip finished steps (gameplay can achieve few effects in one frame)
+			while(Plan.HasPlan() &&
+				ActionsProblem.IsFactMet(State, ActionsProblem.Actions[Plan.GetCurrentAction()].Effect))
+			{
+				++Plan.StepIndex;
+			}
+
+			if(!Plan.HasPlan() || !ActionsProblem.IsActionApplicable(State, Plan.GetCurrentAction()))
+			{
+				// plan is finished without achieving goal or world state changed - plan again
+				Plan.Reset();
+				ChunkContext.Defer().AddTag<FGOAPMassNeedsPlanTag>(ChunkContext.GetEntity(AgentIndex));
+			}
+		}
+	});
+}
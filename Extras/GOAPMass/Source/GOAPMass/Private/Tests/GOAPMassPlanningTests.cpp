@@ -0,0 +1,86 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPMassPlanning.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GOAPMassPlanningTests
+{
+	static constexpr int32 ValuesNum = 3;
+
+	/** Return condition met if given key has given value. */
+	static FGOAPCoreCondition MakeCondition(int32 Key, int32 Value)
+	{
+		FGOAPCoreCondition Condition;
+		Condition.Key = Key;
+		Condition.SatisfyingValues.Init(false, ValuesNum);
+		Condition.SatisfyingValues[Value] = true;
+		return Condition;
+	}
+
+	/**
+	 * Build actions of two keys - key 0 is switched between values 1 and 2 forever (so forward search never runs out
+	 * of nodes) and key 1 can be set to 1 only when key 0 has value 2. Nothing sets key 1 to 2.
+	 */
+	static void BuildActionsProblem(FGOAPPlanningProblem& OutProblem)
+	{
+		OutProblem.Reset();
+		OutProblem.InitialState.Init(0, 2);
+		OutProblem.KeysActors.Init(0, 2);
+
+		FGOAPCoreAction& SetOne = OutProblem.Actions.AddDefaulted_GetRef();
+		SetOne.ActionIndex = 0;
+		SetOne.Effect = FGOAPCoreFact(0, 1);
+
+		FGOAPCoreAction& SetTwo = OutProblem.Actions.AddDefaulted_GetRef();
+		SetTwo.ActionIndex = 1;
+		SetTwo.Effect = FGOAPCoreFact(0, 2);
+
+		FGOAPCoreAction& SetKey = OutProblem.Actions.AddDefaulted_GetRef();
+		SetKey.ActionIndex = 2;
+		SetKey.Effect = FGOAPCoreFact(1, 1);
+		SetKey.Preconditions.Add(FGOAPCoreFact(0, 2));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGOAPMassPlanningTest, "GOAP.Mass.Planning",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGOAPMassPlanningTest::RunTest(const FString& Parameters)
+{
+	using namespace GOAPMassPlanningTests;
+
+	FGOAPPlanningProblem ActionsProblem;
+	BuildActionsProblem(ActionsProblem);
+	const FGOAPCoreState State = ActionsProblem.InitialState;
+	const double MaxSearchTime = 0.01;
+	TArray<int32> Plan;
+
+	const TArray<FGOAPCoreCondition> ReachableConditions = { MakeCondition(1, 1) };
+	const GOAPMass::FAgentProblem ReachableProblem(ActionsProblem, State, ReachableConditions,
+		EGOAPConditionJunction::All);
+	TestTrue(TEXT("Reachable goal has plan"),
+		GOAPMass::FindAgentPlan(ReachableProblem, MaxSearchTime, Plan) == EGOAPMassPlanningResult::Found);
+	TestTrue(TEXT("Plan of reachable goal"), Plan == TArray<int32>({ 1, 2 }));
+
+	const TArray<FGOAPCoreCondition> SatisfiedConditions = { MakeCondition(1, 0) };
+	const GOAPMass::FAgentProblem SatisfiedProblem(ActionsProblem, State, SatisfiedConditions,
+		EGOAPConditionJunction::All);
+	TestTrue(TEXT("Satisfied goal"),
+		GOAPMass::FindAgentPlan(SatisfiedProblem, MaxSearchTime, Plan) == EGOAPMassPlanningResult::Satisfied);
+	TestTrue(TEXT("Satisfied goal has no plan"), Plan.Num() == 0);
+
+	// search of unreachable goal has to end within its budget (with some margin for slow machines)
+	const TArray<FGOAPCoreCondition> UnreachableConditions = { MakeCondition(1, 2) };
+	const GOAPMass::FAgentProblem UnreachableProblem(ActionsProblem, State, UnreachableConditions,
+		EGOAPConditionJunction::All);
+	const double StartTime = FPlatformTime::Seconds();
+	TestTrue(TEXT("Unreachable goal"),
+		GOAPMass::FindAgentPlan(UnreachableProblem, MaxSearchTime, Plan) == EGOAPMassPlanningResult::Unreachable);
+	TestTrue(TEXT("Unreachable goal has no plan"), Plan.Num() == 0);
+	TestTrue(TEXT("Search of unreachable goal ends in time"), FPlatformTime::Seconds() - StartTime < 1.0);
+	return true;
+}
+
+#endif
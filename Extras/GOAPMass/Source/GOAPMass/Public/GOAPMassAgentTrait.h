@@ -0,0 +1,27 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTraitBase.h"
+#include "GOAPMassAgentTrait.generated.h"
+
+class UGOAPMassDomain;
+
+/**
+ * Makes entity GOAP Mass agent - adds world state, goals, plan and memory fragments and shares Domain between all
+ * entities of the config. Agents are driven by GOAP Mass processors (goal scoring, planning and plan stepping).
+ */
+UCLASS(meta = (DisplayName = "GOAP Agent"))
+class GOAPMASS_API UGOAPMassAgentTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+
+	/** Actions and goals of agents. */
+	UPROPERTY(EditAnywhere, Category = "GOAP")
+	UGOAPMassDomain* Domain = nullptr;
+};
@@ -0,0 +1,123 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GameplayTagContainer.h"
+#include "GOAPGoalPredicate.h"
+#include "GOAPPlanningCore.h"
+#include "GOAPUtilityScoring.h"
+#include "GOAPMassDomain.generated.h"
+
+struct FGOAPMassWorldStateFragment;
+
+/**
+ * Goal of GOAP Mass agents - data only version of UGOAPGoal (conditions and utility score).
+ */
+USTRUCT(BlueprintType)
+struct GOAPMASS_API FGOAPMassGoalDefinition
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	FName Name;
+
+	/** Conditions that satisfy goal. Keys refer to agent (keys' actors are ignored). */
+	UPROPERTY(EditAnywhere)
+	TArray<FGOAPWorldStateCondition> Conditions;
+	/** Defines how Conditions are joined. */
+	UPROPERTY(EditAnywhere)
+	EGOAPConditionJunction Junction = EGOAPConditionJunction::All;
+
+	/** Inputs of goal's score (like UGOAPGoal utility scoring). Goal is valid if its score is greater than 0. */
+	UPROPERTY(EditAnywhere)
+	TArray<FGOAPUtilityConsideration> UtilityConsiderations;
+};
+
+/**
+ * Actions and goals of GOAP Mass agents. Actions are the same classes as used by UGOAPPlanner (implementing
+ * IGOAPAction); they are grounded once per domain (with null agent and context actor, so their effects and
+ * preconditions have to refer to agent's own world state) and all agents are planned by planning core against the
+ * grounded actions.
+ */
+UCLASS(BlueprintType)
+class GOAPMASS_API UGOAPMassDomain : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Ground actions and compile goals. Has to be called on game thread; it's done on first agent creation. */
+	void Initialize();
+	/** Return true if domain was initialized. */
+	FORCEINLINE bool IsInitialized() const { return bInitialized; }
+
+	/**
+	 * Return problem with grounded actions shared by all agents; its initial state contains default values (null
+	 * payloads) of all keys.
+	 */
+	FORCEINLINE const FGOAPPlanningProblem& GetActionsProblem() const { return ActionsProblem; }
+	/** Return action object (class default object) of given action of actions problem. */
+	UObject* GetActionObject(int32 ProblemActionIndex) const;
+
+	FORCEINLINE int32 GetGoalsNum() const { return Goals.Num(); }
+	FORCEINLINE const FGOAPMassGoalDefinition& GetGoal(int32 GoalIndex) const { return Goals[GoalIndex]; }
+	/** Return goal's conditions compiled against domain's keys and values. */
+	FORCEINLINE const TArray<FGOAPCoreCondition>& GetGoalConditions(int32 GoalIndex) const
+	{
+		return GoalsConditions[GoalIndex];
+	}
+	/** Return number of goal's conditions not met in given state (0 - goal is satisfied). */
+	int32 GetGoalUnsatisfiedConditionsNum(int32 GoalIndex, const FGOAPCoreState& State) const;
+
+	/** Return index of key of given tag (INDEX_NONE if none of actions and goals uses it). */
+	int32 FindKey(const FGameplayTag& Tag) const;
+	/** Return numeric value of given value index (false if value isn't numeric). */
+	bool GetNumericValue(int32 ValueIndex, double& OutValue) const;
+	/** Return value of given index. */
+	FORCEINLINE UGOAPWorldStatePayload* GetValue(int32 ValueIndex) const { return Values[ValueIndex]; }
+
+	/**
+	 * Set value of agent's world state data. New values are added to domain (game thread only). Return false if
+	 * domain has no such key.
+	 */
+	bool SetWorldStateValue(FGOAPMassWorldStateFragment& WorldState, const FGameplayTag& Tag,
+		UGOAPWorldStatePayload* Value);
+
+protected:
+
+	/** Actions classes (implementing IGOAPAction). */
+	UPROPERTY(EditAnywhere, meta = (MustImplement = "/Script/GOAP.GOAPAction"))
+	TArray<TSubclassOf<UObject>> Actions;
+
+	/** Goals of agents. */
+	UPROPERTY(EditAnywhere)
+	TArray<FGOAPMassGoalDefinition> Goals;
+
+private:
+
+	/** Return index of key of given tag, add it if needed. */
+	int32 InternKey(const FGameplayTag& Tag);
+	/** Return index of value equal to given one, add it if needed. */
+	int32 InternValue(UGOAPWorldStatePayload* Payload);
+	/** Compile goals' conditions against current values (has to be repeated when new value is added). */
+	void CompileGoals();
+
+	/** Grounded actions of all Actions (grounded action's ActionIndex is index in Actions). */
+	FGOAPPlanningProblem ActionsProblem;
+
+	/** Keys (agent's world state data tags) and values of domain. */
+	TArray<FGameplayTag> Keys;
+	TMap<FGameplayTag, int32> KeysIndexes;
+	UPROPERTY(Transient)
+	TArray<UGOAPWorldStatePayload*> Values;
+	/** Numeric value of each value (if NumericValuesValid bit is set). */
+	TArray<double> NumericValues;
+	TBitArray<> NumericValuesValid;
+
+	/** Compiled conditions of each goal. */
+	TArray<TArray<FGOAPCoreCondition>> GoalsConditions;
+
+	bool bInitialized = false;
+};
@@ -0,0 +1,101 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPPlanningCore.h"
+#include "MassEntityTypes.h"
+#include "GOAPMassFragments.generated.h"
+
+class UGOAPMassDomain;
+
+/**
+ * World state of GOAP Mass agent - value index (of agent's domain) for each domain's key. Use
+ * UGOAPMassDomain::SetWorldStateValue to change it.
+ */
+USTRUCT()
+struct GOAPMASS_API FGOAPMassWorldStateFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FGOAPCoreState State;
+};
+
+/**
+ * Goals of GOAP Mass agent (goal set is defined by agent's domain).
+ */
+USTRUCT()
+struct GOAPMASS_API FGOAPMassGoalFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** Index of domain's goal pursued by agent (INDEX_NONE if agent has no valid goal). */
+	int32 PursuedGoalIndex = INDEX_NONE;
+	/** Bit for each domain's goal - set if goal can't be chosen by this agent. */
+	TBitArray<> DisabledGoals;
+	/** Time (world time in seconds) of next goals scoring. */
+	double NextScoringTime = 0.0;
+	/** Index of domain's goal which plan wasn't found lately (INDEX_NONE if there isn't any). */
+	int32 UnreachableGoalIndex = INDEX_NONE;
+	/** Time (world time in seconds) until UnreachableGoalIndex can't be chosen. */
+	double UnreachableGoalRetryTime = 0.0;
+};
+
+/**
+ * Plan of GOAP Mass agent. Gameplay processors execute action of current step (GetCurrentAction) and change agent's
+ * world state; plan stepping processor advances plan when action's effect is met.
+ */
+USTRUCT()
+struct GOAPMASS_API FGOAPMassPlanFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** Indexes of domain's actions (UGOAPMassDomain::GetActionsProblem) in execution order. */
+	TArray<int32> Plan;
+	/** Index of currently executed step of Plan. */
+	int32 StepIndex = 0;
+
+	/** Return true if agent has plan which isn't finished yet. */
+	FORCEINLINE bool HasPlan() const { return Plan.IsValidIndex(StepIndex); }
+	/** Return index of domain's action which should be executed now (INDEX_NONE if there isn't any). */
+	FORCEINLINE int32 GetCurrentAction() const { return HasPlan() ? Plan[StepIndex] : INDEX_NONE; }
+	/** Remove plan. */
+	FORCEINLINE void Reset()
+	{
+		Plan.Reset();
+		StepIndex = 0;
+	}
+};
+
+/**
+ * Memory of GOAP Mass agent - handle of entity which agent's plan is about (e.g. target of actions). Domain's world
+ * state is agent's own, so memory isn't used in planning, it's only passed to gameplay processors executing actions.
+ */
+USTRUCT()
+struct GOAPMASS_API FGOAPMassMemoryFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FMassEntityHandle TargetEntity;
+};
+
+/**
+ * Domain (actions and goals) of GOAP Mass agents, shared by all agents created from the same trait.
+ */
+USTRUCT()
+struct GOAPMASS_API FGOAPMassDomainSharedFragment : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UGOAPMassDomain* Domain = nullptr;
+};
+
+/**
+ * Added to GOAP Mass agent which needs new plan for its pursued goal; removed by planning processor.
+ */
+USTRUCT()
+struct GOAPMASS_API FGOAPMassNeedsPlanTag : public FMassTag
+{
+	GENERATED_BODY()
+};
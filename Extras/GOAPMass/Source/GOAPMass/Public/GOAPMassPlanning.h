@@ -0,0 +1,74 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPPlanningCore.h"
+
+/**
+ * Result of planning single GOAP Mass agent.
+ */
+enum class EGOAPMassPlanningResult : uint8
+{
+	/** Plan was found. */
+	Found,
+	/** Goal is already satisfied in agent's world state. */
+	Satisfied,
+	/** Plan wasn't found within search's time budget - goal is unreachable (or too expensive to plan now). */
+	Unreachable
+};
+
+namespace GOAPMass
+{
+	/**
+	 * Planning problem of single agent - domain's grounded actions searched from agent's world state to goal's
+	 * conditions. Only refers to domain's and agent's data, so it's cheap to create for each search.
+	 */
+	struct FAgentProblem
+	{
+		FAgentProblem(const FGOAPPlanningProblem& InActionsProblem, const FGOAPCoreState& InState,
+			const TArray<FGOAPCoreCondition>& InConditions, EGOAPConditionJunction InJunction)
+			: ActionsProblem(InActionsProblem)
+			, State(InState)
+			, Conditions(InConditions)
+			, Junction(InJunction)
+		{
+		}
+
+		const FGOAPPlanningProblem& ActionsProblem;
+		const FGOAPCoreState& State;
+		const TArray<FGOAPCoreCondition>& Conditions;
+		EGOAPConditionJunction Junction;
+
+		/*
+		 * Problem interface used by FGOAPPlanningCore::SearchForward.
+		 */
+		using FState = FGOAPCoreState;
+		FORCEINLINE const FState& GetInitialState() const { return State; }
+		FORCEINLINE int32 GetActionsNum() const { return ActionsProblem.GetActionsNum(); }
+		FORCEINLINE bool IsActionApplicable(const FState& InState, int32 ActionIndex) const
+		{
+			return ActionsProblem.IsActionApplicable(InState, ActionIndex);
+		}
+		FORCEINLINE void ApplyAction(FState& InState, int32 ActionIndex) const
+		{
+			ActionsProblem.ApplyAction(InState, ActionIndex);
+		}
+		FORCEINLINE int32 GetActionCost(int32 ActionIndex) const { return ActionsProblem.GetActionCost(ActionIndex); }
+		FORCEINLINE int32 GetUnsatisfiedConditionsNum(const FState& InState) const
+		{
+			return FGOAPPlanningProblem::GetUnsatisfiedConditionsNum(Conditions, Junction, InState);
+		}
+		FORCEINLINE static SIZE_T GetStateAllocatedSize(const FState& InState)
+		{
+			return FGOAPPlanningProblem::GetStateAllocatedSize(InState);
+		}
+	};
+
+	/**
+	 * Search plan of single agent. Forward search doesn't end on unreachable goals by itself, so it's canceled after
+	 * MaxSearchTime (in seconds) and reported as unreachable. Thread safe (only reads given data).
+	 */
+	GOAPMASS_API EGOAPMassPlanningResult FindAgentPlan(const FAgentProblem& Problem, double MaxSearchTime,
+		TArray<int32>& OutPlan);
+}
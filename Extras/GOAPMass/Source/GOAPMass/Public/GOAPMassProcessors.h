@@ -0,0 +1,94 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityQuery.h"
+#include "MassProcessor.h"
+#include "GOAPMassProcessors.generated.h"
+
+/**
+ * Chooses pursued goal of GOAP Mass agents. Scores of all valid (not satisfied, not disabled) goals of all agents of
+ * chunk are evaluated in single utility scoring batch; agent which pursued goal changes gets FGOAPMassNeedsPlanTag.
+ */
+UCLASS()
+class GOAPMASS_API UGOAPMassGoalScoringProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPMassGoalScoringProcessor();
+
+protected:
+
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	/** Time (in seconds) between goals scoring of single agent; 0 - goals are scored each frame. */
+	UPROPERTY(EditDefaultsOnly, Category = "GOAP", meta = (ClampMin = 0.0))
+	float ScoringInterval = 0.25f;
+
+private:
+
+	FMassEntityQuery EntityQuery;
+};
+
+/**
+ * Finds plans of GOAP Mass agents with FGOAPMassNeedsPlanTag. Agents of each chunk are planned in parallel by planning
+ * core (searches only read domain's grounded actions and write agent's own plan). Each search is limited by
+ * MaxSearchTime; goal which plan isn't found in time is treated as unreachable.
+ */
+UCLASS()
+class GOAPMASS_API UGOAPMassPlanningProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPMassPlanningProcessor();
+
+protected:
+
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	/** Max number of agents planned in single frame (0 - no limit); the rest is planned in next frames. */
+	UPROPERTY(EditDefaultsOnly, Category = "GOAP", meta = (ClampMin = 0))
+	int32 MaxPlansPerFrame = 256;
+
+	/** Max time (in seconds) of single agent's search. */
+	UPROPERTY(EditDefaultsOnly, Category = "GOAP", meta = (ClampMin = 0.0001))
+	float MaxSearchTime = 0.005f;
+
+	/** Time (in seconds) in which goal without plan isn't chosen again by the same agent. */
+	UPROPERTY(EditDefaultsOnly, Category = "GOAP", meta = (ClampMin = 0.0))
+	float UnreachableGoalRetryInterval = 2.0f;
+
+private:
+
+	FMassEntityQuery EntityQuery;
+};
+
+/**
+ * Advances plans of GOAP Mass agents: step is finished when effect of its action is met in agent's world state, plan
+ * is finished when pursued goal is satisfied and agent is replanned when preconditions of current action are broken.
+ */
+UCLASS()
+class GOAPMASS_API UGOAPMassPlanSteppingProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPMassPlanSteppingProcessor();
+
+protected:
+
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+
+	FMassEntityQuery EntityQuery;
+};
@@ -21,9 +21,13 @@ public class GOAP : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"DeveloperSettings",
 				"Slate",
-				"SlateCore"
+				"SlateCore",
+				"TraceLog"
 			}
 			);
+
+		SetupGameplayDebuggerSupport(Target);
 	}
 }
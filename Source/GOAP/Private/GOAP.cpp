@@ -2,14 +2,39 @@
 
 #include "GOAP.h"
 
+#include "GOAPSolverStatistics.h"
+
+#if WITH_GAMEPLAY_DEBUGGER
+#include "GameplayDebugger.h"
+#include "GOAPGameplayDebuggerCategory.h"
+#endif
+
 #define LOCTEXT_NAMESPACE "FGOAPModule"
 
 void FGOAPModule::StartupModule()
 {
+#if WITH_GAMEPLAY_DEBUGGER
+	IGameplayDebugger& GameplayDebuggerModule = IGameplayDebugger::Get();
+	GameplayDebuggerModule.RegisterCategory("GOAP",
+		IGameplayDebugger::FOnGetCategory::CreateStatic(&FGOAPGameplayDebuggerCategory::MakeInstance),
+		EGameplayDebuggerCategoryState::EnabledInGameAndSimulate);
+	GameplayDebuggerModule.NotifyCategoriesChanged();
+#endif
 }
 
 void FGOAPModule::ShutdownModule()
 {
+	// statistics learned by adaptive solvers are kept for next sessions
+	FGOAPSolverStatistics::Save();
+
+#if WITH_GAMEPLAY_DEBUGGER
+	if(IGameplayDebugger::IsAvailable())
+	{
+		IGameplayDebugger& GameplayDebuggerModule = IGameplayDebugger::Get();
+		GameplayDebuggerModule.UnregisterCategory("GOAP");
+		GameplayDebuggerModule.NotifyCategoriesChanged();
+	}
+#endif
 }
 
 #undef LOCTEXT_NAMESPACE
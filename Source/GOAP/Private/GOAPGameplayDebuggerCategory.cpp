@@ -0,0 +1,202 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPGameplayDebuggerCategory.h"
+
+#if WITH_GAMEPLAY_DEBUGGER
+
+#include "GOAPAgent.h"
+#include "GOAPGoal.h"
+#include "GOAPPlanner.h"
+#include "GOAPSolver.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/UObjectIterator.h"
+
+namespace GOAPGameplayDebugger
+{
+	/** Number of agents shown in rankings. */
+	constexpr int32 RankingSize = 5;
+
+	FString DescribeWorldStateData(const FGOAPWorldStateData& Data)
+	{
+		return FString::Printf(TEXT("%s.%s"), *GetNameSafe(Data.WorldStateKey.WorldStateActor),
+			*Data.WorldStateKey.WorldStateDataTag.ToString());
+	}
+
+	UGOAPPlanner* FindPlanner(AActor* Actor)
+	{
+		if(!Actor)
+			return nullptr;
+
+		if(Actor->Implements<UGOAPAgent>())
+			return IGOAPAgent::Execute_GetGOAPPlanner(Actor);
+
+		return Actor->FindComponentByClass<UGOAPPlanner>();
+	}
+}
+
+FGOAPGameplayDebuggerCategory::FGOAPGameplayDebuggerCategory()
+{
+	SetDataPackReplication<FRepData>(&DataPack);
+}
+
+TSharedRef<FGameplayDebuggerCategory> FGOAPGameplayDebuggerCategory::MakeInstance()
+{
+	return MakeShareable(new FGOAPGameplayDebuggerCategory());
+}
+
+void FGOAPGameplayDebuggerCategory::CollectData(APlayerController* OwnerPC, AActor* DebugActor)
+{
+	DataPack = FRepData();
+
+	if(const UGOAPPlanner* Planner = GOAPGameplayDebugger::FindPlanner(DebugActor))
+	{
+		CollectPlannerData(Planner);
+	}
+	if(OwnerPC)
+	{
+		CollectAgentsRanking(OwnerPC->GetWorld());
+	}
+}
+
+void FGOAPGameplayDebuggerCategory::CollectPlannerData(const UGOAPPlanner* Planner)
+{
+	DataPack.AgentName = GetNameSafe(Planner->GetOwner());
+	DataPack.PursuedGoal = GetNameSafe(Planner->GetPursuedGoal());
+
+	const TArray<UGOAPGoal*>& Goals = Planner->GetGoals();
+	const TArray<float>& Scores = Planner->GetLastGoalsScores();
+	for(int32 GoalIndex = 0; GoalIndex < Goals.Num(); ++GoalIndex)
+	{
+		const float Score = Scores.IsValidIndex(GoalIndex) ? Scores[GoalIndex] : 0.0f;
+		const FString ScoreText = Score < 0.0f ? TEXT("satisfied") : FString::Printf(TEXT("%.2f"), Score);
+		DataPack.Goals.Add(FString::Printf(TEXT("%s%s: %s"), Goals[GoalIndex] == Planner->GetPursuedGoal() ?
+			TEXT("{green}") : TEXT("{white}"), *GetNameSafe(Goals[GoalIndex]), *ScoreText));
+	}
+
+	const TArray<FGOAPActionWithTargetData>& Plan = Planner->GetExecutingPlan();
+	for(int32 StepIndex = 0; StepIndex < Plan.Num(); ++StepIndex)
+	{
+		const TCHAR* Color = StepIndex < Planner->GetExecutingPlanActionIndex() ? TEXT("{grey}") :
+			StepIndex == Planner->GetExecutingPlanActionIndex() ? TEXT("{green}") : TEXT("{white}");
+		DataPack.Plan.Add(FString::Printf(TEXT("%s%d. %s -> %s"), Color, StepIndex, *GetNameSafe(Plan[StepIndex].Action),
+			*GOAPGameplayDebugger::DescribeWorldStateData(Plan[StepIndex].TargetData)));
+	}
+
+	for(const FGOAPPlanDependency& Dependency : Planner->GetExecutingPlanDependencies())
+	{
+		DataPack.Dependencies.Add(FString::Printf(TEXT("%s%s (step %d)"),
+			Dependency.bMet ? TEXT("{white}") : TEXT("{red}"),
+			*GOAPGameplayDebugger::DescribeWorldStateData(Dependency.RequiredWorldState), Dependency.StepIndex));
+	}
+
+	if(const UGOAPSolver* Solver = Planner->GetSolver())
+	{
+		const FGOAPSearchStats& Stats = Solver->GetLastSearchStats();
+		DataPack.SearchStats = FString::Printf(TEXT("%s, searches %d, last: %.3f ms, expanded %d, generated %d, "
+			"deduplicated %d, plan length %d, cost %d"), *Solver->GetClass()->GetName(), Planner->GetSearchesNum(),
+			Stats.SearchTime * 1000.0, Stats.NodesExpanded, Stats.NodesGenerated, Stats.NodesDeduplicated,
+			Stats.PlanLength, Stats.PlanCost);
+		if(Stats.ForwardFrontierSize > 0 || Stats.BackwardFrontierSize > 0)
+		{
+			DataPack.SearchStats += FString::Printf(TEXT(", frontiers %d/%d"), Stats.ForwardFrontierSize,
+				Stats.BackwardFrontierSize);
+		}
+		if(Stats.NodesReexpanded > 0)
+		{
+			DataPack.SearchStats += FString::Printf(TEXT(", reexpanded %d"), Stats.NodesReexpanded);
+		}
+	}
+}
+
+void FGOAPGameplayDebuggerCategory::CollectAgentsRanking(const UWorld* World)
+{
+	struct FPlannerEntry
+	{
+		const UGOAPPlanner* Planner;
+		float SearchesPerMinute;
+		double LastSearchTime;
+	};
+
+	TArray<FPlannerEntry> Entries;
+	for(TObjectIterator<UGOAPPlanner> It; It; ++It)
+	{
+		const UGOAPPlanner* Planner = *It;
+		if(Planner->GetWorld() != World || !Planner->GetOwner() || !Planner->GetSolver())
+			continue;
+
+		const float LifeTime = FMath::Max(Planner->GetOwner()->GetGameTimeSinceCreation(), 1.0f);
+		Entries.Add({Planner, Planner->GetSearchesNum() * 60.0f / LifeTime,
+			Planner->GetSolver()->GetLastSearchStats().SearchTime});
+	}
+
+	Entries.Sort([](const FPlannerEntry& A, const FPlannerEntry& B)
+	{
+		return A.SearchesPerMinute > B.SearchesPerMinute;
+	});
+	for(int32 Index = 0; Index < FMath::Min(Entries.Num(), GOAPGameplayDebugger::RankingSize); ++Index)
+	{
+		DataPack.FrequentPlanners.Add(FString::Printf(TEXT("%s: %.1f searches/min"),
+			*GetNameSafe(Entries[Index].Planner->GetOwner()), Entries[Index].SearchesPerMinute));
+	}
+
+	Entries.Sort([](const FPlannerEntry& A, const FPlannerEntry& B) { return A.LastSearchTime > B.LastSearchTime; });
+	for(int32 Index = 0; Index < FMath::Min(Entries.Num(), GOAPGameplayDebugger::RankingSize); ++Index)
+	{
+		DataPack.SlowPlanners.Add(FString::Printf(TEXT("%s: %.3f ms"),
+			*GetNameSafe(Entries[Index].Planner->GetOwner()), Entries[Index].LastSearchTime * 1000.0));
+	}
+}
+
+void FGOAPGameplayDebuggerCategory::DrawData(APlayerController* OwnerPC, FGameplayDebuggerCanvasContext& CanvasContext)
+{
+	if(!DataPack.AgentName.IsEmpty())
+	{
+		CanvasContext.Printf(TEXT("Agent: {yellow}%s"), *DataPack.AgentName);
+		CanvasContext.Printf(TEXT("Pursued goal: {yellow}%s"), *DataPack.PursuedGoal);
+		CanvasContext.Printf(TEXT("Goals:"));
+		for(const FString& Goal : DataPack.Goals)
+		{
+			CanvasContext.Printf(TEXT("  %s"), *Goal);
+		}
+		CanvasContext.Printf(TEXT("Plan:"));
+		for(const FString& Step : DataPack.Plan)
+		{
+			CanvasContext.Printf(TEXT("  %s"), *Step);
+		}
+		CanvasContext.Printf(TEXT("Plan dependencies:"));
+		for(const FString& Dependency : DataPack.Dependencies)
+		{
+			CanvasContext.Printf(TEXT("  %s"), *Dependency);
+		}
+		CanvasContext.Printf(TEXT("Solver: {yellow}%s"), *DataPack.SearchStats);
+	}
+	else
+	{
+		CanvasContext.Printf(TEXT("{red}Selected actor has no GOAP planner"));
+	}
+
+	CanvasContext.Printf(TEXT("Most searches:"));
+	for(const FString& Planner : DataPack.FrequentPlanners)
+	{
+		CanvasContext.Printf(TEXT("  %s"), *Planner);
+	}
+	CanvasContext.Printf(TEXT("Longest last search:"));
+	for(const FString& Planner : DataPack.SlowPlanners)
+	{
+		CanvasContext.Printf(TEXT("  %s"), *Planner);
+	}
+}
+
+void FGOAPGameplayDebuggerCategory::FRepData::Serialize(FArchive& Ar)
+{
+	Ar << AgentName;
+	Ar << PursuedGoal;
+	Ar << Goals;
+	Ar << Plan;
+	Ar << Dependencies;
+	Ar << SearchStats;
+	Ar << FrequentPlanners;
+	Ar << SlowPlanners;
+}
+
+#endif
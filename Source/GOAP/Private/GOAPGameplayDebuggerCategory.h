@@ -0,0 +1,54 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_GAMEPLAY_DEBUGGER
+
+#include "GameplayDebuggerCategory.h"
+
+class UGOAPPlanner;
+
+/**
+ * Gameplay Debugger category showing planner of debugged agent (goals scores, executed plan, plan dependencies, last
+ * search statistics) and agents which plan the most. Data is collected only while category is active.
+ */
+class FGOAPGameplayDebuggerCategory : public FGameplayDebuggerCategory
+{
+public:
+
+	FGOAPGameplayDebuggerCategory();
+
+	virtual void CollectData(APlayerController* OwnerPC, AActor* DebugActor) override;
+	virtual void DrawData(APlayerController* OwnerPC, FGameplayDebuggerCanvasContext& CanvasContext) override;
+
+	static TSharedRef<FGameplayDebuggerCategory> MakeInstance();
+
+protected:
+
+	/** Collect data of debugged agent's planner. */
+	void CollectPlannerData(const UGOAPPlanner* Planner);
+	/** Collect agents with the most searches per minute and the longest last search. */
+	void CollectAgentsRanking(const UWorld* World);
+
+	/**
+	 * Replicated data.
+	 */
+	struct FRepData
+	{
+		FString AgentName;
+		FString PursuedGoal;
+		TArray<FString> Goals;
+		TArray<FString> Plan;
+		TArray<FString> Dependencies;
+		FString SearchStats;
+		TArray<FString> FrequentPlanners;
+		TArray<FString> SlowPlanners;
+
+		void Serialize(FArchive& Ar);
+	};
+	FRepData DataPack;
+};
+
+#endif
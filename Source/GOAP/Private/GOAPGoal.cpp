@@ -3,14 +3,104 @@
 
 #include "GOAPGoal.h"
 
+#include "GOAPHookProfiler.h"
+
 FGOAPWorldStateData UGOAPGoal::GetDesiredWorldState()
 {
 	// update desired world state to always return current data
-	UpdateDesiredWorldState();
+	{
+		GOAP_HOOK_SCOPE(this, GoalDesiredWorldState);
+		UpdateDesiredWorldState();
+	}
 	
 	return DesiredWorldState;
 }
 
+const FGOAPGoalPredicate& UGOAPGoal::GetDesiredPredicate()
+{
+	{
+		GOAP_HOOK_SCOPE(this, GoalDesiredWorldState);
+		UpdateDesiredWorldState();
+	}
+	CompilePredicate();
+	
+	return CompiledPredicate;
+}
+
+const FGOAPGoalPredicate& UGOAPGoal::GetCompiledPredicate()
+{
+	// conditions set as defaults don't need update to be compiled
+	if(CompiledPredicate.IsEmpty() && DesiredConditions.Num() > 0)
+	{
+		CompilePredicate();
+	}
+	
+	return CompiledPredicate;
+}
+
+void UGOAPGoal::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	// predicate is evaluated after its source payloads can be replaced (e.g. by bSkipWhenSatisfied check), so it keeps
+	// them alive
+	CastChecked<UGOAPGoal>(InThis)->CompiledPredicate.AddReferencedObjects(Collector);
+}
+
+void UGOAPGoal::CompilePredicate()
+{
+	AActor* Agent = Cast<AActor>(AgentActor.GetObject());
+	if(DesiredConditions.Num() > 0)
+	{
+		CompiledPredicate.Compile(DesiredConditions, DesiredConditionsJunction, Agent);
+	}
+	else
+	{
+		CompiledPredicate.Compile({ FGOAPWorldStateCondition(DesiredWorldState, EGOAPConditionOperator::Equal) },
+			EGOAPConditionJunction::All, Agent);
+	}
+}
+
+float UGOAPGoal::CalculateUtilityScore()
+{
+	FGOAPUtilityScoringBatch Batch;
+	Batch.AddGoal(this);
+	TArray<float> Scores;
+	Batch.Evaluate(Scores);
+	return Scores[0];
+}
+
+bool UGOAPGoal::IsDependentOnWorldState(const FGameplayTag& WorldStateAtomTag) const
+{
+	if(RelevantWorldStateTags.HasTagExact(WorldStateAtomTag))
+		return true;
+
+	// goal's own conditions - e.g. satisfied goal (bSkipWhenSatisfied) has to be evaluated again when they aren't met
+	const bool bIsPredicateKey = CompiledPredicate.Keys.ContainsByPredicate(
+		[&WorldStateAtomTag](const FGOAPWorldStateKey& Key)
+	{
+		return Key.WorldStateDataTag.MatchesTagExact(WorldStateAtomTag);
+	});
+	if(bIsPredicateKey)
+		return true;
+	// conditions which weren't compiled yet
+	const bool bIsConditionKey = DesiredConditions.ContainsByPredicate(
+		[&WorldStateAtomTag](const FGOAPWorldStateCondition& Condition)
+	{
+		return Condition.WorldState.WorldStateKey.WorldStateDataTag.MatchesTagExact(WorldStateAtomTag);
+	});
+	if(bIsConditionKey || (DesiredConditions.Num() == 0 &&
+		DesiredWorldState.WorldStateKey.WorldStateDataTag.MatchesTagExact(WorldStateAtomTag)))
+		return true;
+
+	// native score inputs are always relevant
+	return ScoringMode == EGOAPGoalScoringMode::Utility &&
+		UtilityConsiderations.ContainsByPredicate([&WorldStateAtomTag](const FGOAPUtilityConsideration& Consideration)
+	{
+		return Consideration.WorldStateTag.MatchesTagExact(WorldStateAtomTag);
+	});
+}
+
 void UGOAPGoal::UpdateDesiredWorldState_Implementation()
 {
 	// have to be implemented
@@ -0,0 +1,198 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPGoalPredicate.h"
+
+#include "GameFramework/Actor.h"
+#include "GOAPWorldStateFunctionLibrary.h"
+#include "GOAPWorldStatePayloads.h"
+
+void FGOAPGoalPredicate::Compile(const TArray<FGOAPWorldStateCondition>& Conditions, EGOAPConditionJunction InJunction,
+	AActor* AgentActor)
+{
+	Reset();
+	Junction = InJunction;
+	
+	for(const FGOAPWorldStateCondition& Condition : Conditions)
+	{
+		if(!Condition.WorldState.WorldStateValue.Payload || !Condition.WorldState.WorldStateKey.WorldStateDataTag.IsValid())
+		{
+			UE_LOG(LogGOAP, Warning, TEXT("Goal condition without value or tag is ignored."));
+			continue;
+		}
+		
+		FGOAPWorldStateKey Key = Condition.WorldState.WorldStateKey;
+		if(!Key.WorldStateActor)
+		{
+			Key.WorldStateActor = AgentActor;
+		}
+
+		FInstruction Instruction;
+		Instruction.KeyIndex = Keys.AddUnique(Key);
+		Instruction.Operator = Condition.Operator;
+		Instruction.Value = Condition.WorldState.WorldStateValue.Payload;
+		if(Condition.Operator != EGOAPConditionOperator::Equal && Condition.Operator != EGOAPConditionOperator::NotEqual &&
+			!Instruction.Value->GetNumericValue(Instruction.Number))
+		{
+			UE_LOG(LogGOAP, Warning, TEXT("Goal condition for %s uses numeric comparison with not numeric value!"),
+				*Key.WorldStateDataTag.ToString());
+		}
+		Instructions.Add(Instruction);
+	}
+}
+
+void FGOAPGoalPredicate::Reset()
+{
+	Keys.Reset();
+	Instructions.Reset();
+	Junction = EGOAPConditionJunction::All;
+}
+
+void FGOAPGoalPredicate::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for(FGOAPWorldStateKey& Key : Keys)
+	{
+		Collector.AddReferencedObject(Key.WorldStateActor);
+	}
+	for(FInstruction& Instruction : Instructions)
+	{
+		Collector.AddReferencedObject(Instruction.Value);
+	}
+}
+
+bool FGOAPGoalPredicate::IsSatisfied() const
+{
+	return IsSatisfied(TArray<FGOAPWorldStateData>());
+}
+
+bool FGOAPGoalPredicate::IsSatisfied(const TArray<FGOAPWorldStateData>& WithCurrentWorldState) const
+{
+	return GetUnsatisfiedConditionsNum(WithCurrentWorldState) == 0;
+}
+
+bool FGOAPGoalPredicate::IsSatisfied(const TArray<FGOAPWorldStateData>& WithCurrentWorldState,
+	FGOAPWorldStateReader Reader) const
+{
+	return GetUnsatisfiedConditionsNum(WithCurrentWorldState, Reader) == 0;
+}
+
+int32 FGOAPGoalPredicate::GetUnsatisfiedConditionsNum(const TArray<FGOAPWorldStateData>& WithCurrentWorldState) const
+{
+	return GetUnsatisfiedConditionsNum(WithCurrentWorldState, &FGOAPGoalPredicate::ReadActualWorldStateValue);
+}
+
+int32 FGOAPGoalPredicate::GetUnsatisfiedConditionsNum(const TArray<FGOAPWorldStateData>& WithCurrentWorldState,
+	FGOAPWorldStateReader Reader) const
+{
+	TArray<UGOAPWorldStatePayload*> CurrentValues;
+	GetCurrentValues(WithCurrentWorldState, Reader, CurrentValues);
+
+	int32 UnsatisfiedNum = 0;
+	for(const FInstruction& Instruction : Instructions)
+	{
+		const bool bSatisfied = EvaluateInstruction(Instruction, CurrentValues[Instruction.KeyIndex]);
+		if(Junction == EGOAPConditionJunction::Any && bSatisfied)
+			return 0;
+		if(!bSatisfied)
+		{
+			++UnsatisfiedNum;
+		}
+	}
+	
+	if(Junction == EGOAPConditionJunction::Any)
+		return Instructions.Num() > 0 ? 1 : 0;
+	return UnsatisfiedNum;
+}
+
+TArray<TArray<FGOAPWorldStateData>> FGOAPGoalPredicate::GetRegressionTargets() const
+{
+	return GetRegressionTargets(&FGOAPGoalPredicate::ReadActualWorldStateValue);
+}
+
+TArray<TArray<FGOAPWorldStateData>> FGOAPGoalPredicate::GetRegressionTargets(FGOAPWorldStateReader Reader) const
+{
+	TArray<UGOAPWorldStatePayload*> CurrentValues;
+	GetCurrentValues(TArray<FGOAPWorldStateData>(), Reader, CurrentValues);
+	
+	TArray<TArray<FGOAPWorldStateData>> Result;
+	if(Junction == EGOAPConditionJunction::All)
+	{
+		TArray<FGOAPWorldStateData> DesiredStates;
+		for(const FInstruction& Instruction : Instructions)
+		{
+			if(EvaluateInstruction(Instruction, CurrentValues[Instruction.KeyIndex]))
+				continue;
+			// not met condition which can't be regressed - predicate can't be satisfied by backward planning
+			if(Instruction.Operator != EGOAPConditionOperator::Equal)
+				return TArray<TArray<FGOAPWorldStateData>>();
+			DesiredStates.Add(FGOAPWorldStateData(Keys[Instruction.KeyIndex], FGOAPWorldStateValue(Instruction.Value)));
+		}
+		if(DesiredStates.Num() > 0)
+		{
+			Result.Add(DesiredStates);
+		}
+	}
+	else
+	{
+		for(const FInstruction& Instruction : Instructions)
+		{
+			// already satisfied disjunction doesn't need any plan
+			if(EvaluateInstruction(Instruction, CurrentValues[Instruction.KeyIndex]))
+				return TArray<TArray<FGOAPWorldStateData>>();
+			if(Instruction.Operator == EGOAPConditionOperator::Equal)
+			{
+				Result.Add({ FGOAPWorldStateData(Keys[Instruction.KeyIndex], FGOAPWorldStateValue(Instruction.Value)) });
+			}
+		}
+	}
+	return Result;
+}
+
+bool FGOAPGoalPredicate::EvaluateInstruction(const FInstruction& Instruction, UGOAPWorldStatePayload* CurrentValue)
+{
+	switch(Instruction.Operator)
+	{
+	case EGOAPConditionOperator::Equal:
+		return Instruction.Value->IsEqual(CurrentValue);
+	case EGOAPConditionOperator::NotEqual:
+		return !Instruction.Value->IsEqual(CurrentValue);
+	default:
+		break;
+	}
+
+	double CurrentNumber;
+	if(!CurrentValue || !CurrentValue->GetNumericValue(CurrentNumber))
+		return false;
+	
+	switch(Instruction.Operator)
+	{
+	case EGOAPConditionOperator::Less:
+		return CurrentNumber < Instruction.Number;
+	case EGOAPConditionOperator::LessOrEqual:
+		return CurrentNumber <= Instruction.Number;
+	case EGOAPConditionOperator::Greater:
+		return CurrentNumber > Instruction.Number;
+	case EGOAPConditionOperator::GreaterOrEqual:
+		return CurrentNumber >= Instruction.Number;
+	default:
+		return false;
+	}
+}
+
+void FGOAPGoalPredicate::GetCurrentValues(const TArray<FGOAPWorldStateData>& WithCurrentWorldState,
+	FGOAPWorldStateReader Reader, TArray<UGOAPWorldStatePayload*>& OutValues) const
+{
+	// each key is read only once, even if it is used by many conditions
+	OutValues.SetNumUninitialized(Keys.Num());
+	for(int32 KeyIndex = 0; KeyIndex < Keys.Num(); ++KeyIndex)
+	{
+		const FGOAPWorldStateData* CurrentWorldState = WithCurrentWorldState.FindByPredicate(
+			[&Key = Keys[KeyIndex]](const FGOAPWorldStateData& WorldState) { return WorldState.WorldStateKey == Key; });
+		OutValues[KeyIndex] = CurrentWorldState ? CurrentWorldState->WorldStateValue.Payload : Reader(Keys[KeyIndex]).Payload;
+	}
+}
+
+FGOAPWorldStateValue FGOAPGoalPredicate::ReadActualWorldStateValue(const FGOAPWorldStateKey& Key)
+{
+	return UGOAPWorldStateFunctionLibrary::GetActualWorldStateValue(Key, TArray<FGOAPWorldStateData>());
+}
@@ -0,0 +1,157 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPHookProfiler.h"
+
+#if GOAP_HOOK_PROFILER_ENABLED
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+namespace GOAPHookProfiler
+{
+	/**
+	 * Gathered data of single hook of single class.
+	 */
+	struct FHookData
+	{
+		/** Name of class (kept, because class can be garbage collected, e.g. after Blueprint recompilation). */
+		FString ClassName;
+		EGOAPHook Hook = EGOAPHook::Num;
+		uint64 Cycles = 0;
+		int64 CallsNum = 0;
+		TStatId StatId;
+
+		double GetTotalTimeMs() const { return FPlatformTime::ToMilliseconds64(Cycles); }
+		double GetTimePerCallMs() const { return CallsNum > 0 ? GetTotalTimeMs() / CallsNum : 0.0; }
+	};
+
+	FCriticalSection DataCriticalSection;
+	TMap<TPair<const UClass*, EGOAPHook>, FHookData> Data;
+
+	/** Return data of given hook, must be called under DataCriticalSection lock. */
+	FHookData& FindOrAddHookData(const UClass* Class, EGOAPHook Hook)
+	{
+		FHookData* HookData = Data.Find(MakeTuple(Class, Hook));
+		if(!HookData)
+		{
+			HookData = &Data.Add(MakeTuple(Class, Hook));
+			HookData->ClassName = Class->GetName();
+			HookData->Hook = Hook;
+#if STATS
+			const FString StatName = FString::Printf(TEXT("%s::%s"), *HookData->ClassName,
+				FGOAPHookProfiler::GetHookName(Hook));
+			HookData->StatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_GOAPHooks>(FName(*StatName));
+#endif
+		}
+		return *HookData;
+	}
+
+	static FAutoConsoleVariableRef CVarEnable(
+		TEXT("GOAP.HookProfiler.Enable"),
+		FGOAPHookProfiler::bEnabled,
+		TEXT("Measure time and number of calls of user callbacks (atoms updates, goals validity and scores, actions "
+			"queries, actions executor calls) per class."));
+
+	static FAutoConsoleCommandWithArgsAndOutputDevice DumpCommand(
+		TEXT("GOAP.HookProfiler.Dump"),
+		TEXT("Print user callbacks ranked by total time. Use \"GOAP.HookProfiler.Dump PerCall\" to rank them by time "
+			"per call."),
+		FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+		{
+			FGOAPHookProfiler::Dump(Ar, Args.Contains(TEXT("PerCall")));
+		}));
+
+	static FAutoConsoleCommand ResetCommand(
+		TEXT("GOAP.HookProfiler.Reset"),
+		TEXT("Remove data gathered by GOAP hook profiler."),
+		FConsoleCommandDelegate::CreateStatic(&FGOAPHookProfiler::Reset));
+}
+
+bool FGOAPHookProfiler::bEnabled = false;
+
+TStatId FGOAPHookProfiler::GetStatId(const UClass* Class, EGOAPHook Hook)
+{
+	FScopeLock Lock(&GOAPHookProfiler::DataCriticalSection);
+	return GOAPHookProfiler::FindOrAddHookData(Class, Hook).StatId;
+}
+
+void FGOAPHookProfiler::RecordCall(const UClass* Class, EGOAPHook Hook, uint64 Cycles)
+{
+	FScopeLock Lock(&GOAPHookProfiler::DataCriticalSection);
+	GOAPHookProfiler::FHookData& HookData = GOAPHookProfiler::FindOrAddHookData(Class, Hook);
+	HookData.Cycles += Cycles;
+	++HookData.CallsNum;
+}
+
+void FGOAPHookProfiler::Reset()
+{
+	FScopeLock Lock(&GOAPHookProfiler::DataCriticalSection);
+	GOAPHookProfiler::Data.Reset();
+}
+
+void FGOAPHookProfiler::Dump(FOutputDevice& Ar, bool bSortByTimePerCall)
+{
+	TArray<GOAPHookProfiler::FHookData> SortedData;
+	{
+		FScopeLock Lock(&GOAPHookProfiler::DataCriticalSection);
+		GOAPHookProfiler::Data.GenerateValueArray(SortedData);
+	}
+
+	SortedData.Sort([bSortByTimePerCall](const GOAPHookProfiler::FHookData& A, const GOAPHookProfiler::FHookData& B)
+	{
+		return bSortByTimePerCall ? A.GetTimePerCallMs() > B.GetTimePerCallMs() : A.Cycles > B.Cycles;
+	});
+
+	if(!bEnabled)
+	{
+		Ar.Logf(TEXT("GOAP hook profiler is disabled, enable it by GOAP.HookProfiler.Enable 1"));
+	}
+	Ar.Logf(TEXT("GOAP hooks ranked by %s:"), bSortByTimePerCall ? TEXT("time per call") : TEXT("total time"));
+	for(const GOAPHookProfiler::FHookData& HookData : SortedData)
+	{
+		Ar.Logf(TEXT("%s::%s - total %.3f ms, calls %lld, per call %.4f ms"), *HookData.ClassName,
+			GetHookName(HookData.Hook), HookData.GetTotalTimeMs(), HookData.CallsNum, HookData.GetTimePerCallMs());
+	}
+}
+
+const TCHAR* FGOAPHookProfiler::GetHookName(EGOAPHook Hook)
+{
+	switch(Hook)
+	{
+	case EGOAPHook::AtomUpdate: return TEXT("UpdateWorldStateAtomData");
+	case EGOAPHook::GoalValidity: return TEXT("IsGoalValid");
+	case EGOAPHook::GoalScore: return TEXT("GetGoalScore");
+	case EGOAPHook::GoalDesiredWorldState: return TEXT("UpdateDesiredWorldState");
+	case EGOAPHook::ActionCanChangeWorldState: return TEXT("CanChangeWorldState");
+	case EGOAPHook::ActionPreconditions: return TEXT("GetWorldStatePreconditions");
+	case EGOAPHook::ActionCost: return TEXT("GetActionCost");
+	case EGOAPHook::ActionEffect: return TEXT("GetActionEffectWithContextActor");
+	case EGOAPHook::ActionSetTargetData: return TEXT("SetActionTargetData");
+	case EGOAPHook::ActionCanBeCanceled: return TEXT("CanBeCanceled");
+	case EGOAPHook::ExecutorActivateAction: return TEXT("TryActivateActionByClass");
+	case EGOAPHook::ExecutorGetActiveAction: return TEXT("GetActiveAction");
+	case EGOAPHook::ExecutorCancelAction: return TEXT("CancelAction");
+	default: return TEXT("Unknown");
+	}
+}
+
+void FGOAPHookScope::Start(const UClass* InClass, EGOAPHook InHook)
+{
+	Class = InClass;
+	Hook = InHook;
+#if STATS
+	CycleCounter.Emplace(FGOAPHookProfiler::GetStatId(Class, Hook));
+#endif
+	StartCycles = FPlatformTime::Cycles64();
+}
+
+void FGOAPHookScope::Stop()
+{
+	const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+#if STATS
+	CycleCounter.Reset();
+#endif
+	FGOAPHookProfiler::RecordCall(Class, Hook, Cycles);
+}
+
+#endif
@@ -3,11 +3,14 @@
 
 #include "GOAPMemoryComponent.h"
 
+#include "GOAPStats.h"
+
 void UGOAPMemoryComponent::RegisterActorInMemory(AActor* Actor)
 {
 	if(!Actor)
 		return;
 
+	LLM_SCOPE_BYTAG(GOAP_Memory);
 	Memory.AddUnique(Actor);
 	OnMemoryChangedDelegate.Broadcast(Actor, true);
 }
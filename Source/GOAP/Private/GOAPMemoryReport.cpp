@@ -0,0 +1,162 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPGoal.h"
+#include "GOAPMemoryComponent.h"
+#include "GOAPPlanner.h"
+#include "GOAPSolver.h"
+#include "GOAPWorldStatePayloads.h"
+#include "GOAPWorldStateProvider.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectIterator.h"
+
+namespace GOAPMemoryReport
+{
+	/** Memory used by GOAP objects of single agent (or all agents), in bytes, split into LLM tags categories. */
+	struct FFootprint
+	{
+		/** Planner and goals. */
+		int64 Planner = 0;
+		/** Solver and its search nodes (from last search). */
+		int64 Solver = 0;
+		/** Executed plan and its dependencies. */
+		int64 Plans = 0;
+		/** Memory component, world state provider and atoms. */
+		int64 Memory = 0;
+		/** Payloads referenced by atoms and executed plan. */
+		int64 Payloads = 0;
+
+		int64 GetTotal() const { return Planner + Solver + Plans + Memory + Payloads; }
+
+		FFootprint& operator+=(const FFootprint& Other)
+		{
+			Planner += Other.Planner;
+			Solver += Other.Solver;
+			Plans += Other.Plans;
+			Memory += Other.Memory;
+			Payloads += Other.Payloads;
+			return *this;
+		}
+
+		FString ToString() const
+		{
+			return FString::Printf(TEXT("total %.1f KB (planner %.1f KB, solver %.1f KB, plans %.1f KB, memory %.1f KB, "
+				"payloads %.1f KB)"), GetTotal() / 1024.0, Planner / 1024.0, Solver / 1024.0, Plans / 1024.0,
+				Memory / 1024.0, Payloads / 1024.0);
+		}
+	};
+
+	/** Return size of object with memory allocated by its properties. */
+	int64 GetObjectSize(UObject* Object)
+	{
+		if(!Object)
+			return 0;
+
+		FArchiveCountMem CountMem(Object);
+		return Object->GetClass()->GetStructureSize() + CountMem.GetMax();
+	}
+
+	FFootprint GetPlannerFootprint(UGOAPPlanner* Planner)
+	{
+		FFootprint Footprint;
+		Footprint.Planner = GetObjectSize(Planner);
+
+		// goals and solver are created by planner
+		TArray<UObject*> PlannerObjects;
+		GetObjectsWithOuter(Planner, PlannerObjects, false);
+		for(UObject* Object : PlannerObjects)
+		{
+			if(const UGOAPSolver* Solver = Cast<UGOAPSolver>(Object))
+			{
+				Footprint.Solver += GetObjectSize(Object) + Solver->GetLastSearchStats().SearchMemory;
+			}
+			else if(Object->IsA<UGOAPGoal>())
+			{
+				Footprint.Planner += GetObjectSize(Object);
+			}
+		}
+
+		// payloads are shared by values copies, so each one is counted once
+		TSet<UGOAPWorldStatePayload*> Payloads;
+		Footprint.Plans = Planner->GetExecutingPlan().GetAllocatedSize() +
+			Planner->GetExecutingPlanDependencies().GetAllocatedSize();
+		for(const FGOAPActionWithTargetData& Step : Planner->GetExecutingPlan())
+		{
+			Payloads.Add(Step.TargetData.WorldStateValue.Payload);
+		}
+		for(const FGOAPPlanDependency& Dependency : Planner->GetExecutingPlanDependencies())
+		{
+			Payloads.Add(Dependency.RequiredWorldState.WorldStateValue.Payload);
+		}
+
+		Footprint.Memory = GetObjectSize(Planner->GetAgentsMemoryComponent());
+		const AActor* Agent = Planner->GetOwner();
+		if(UGOAPWorldStateProvider* Provider = Agent ? Agent->FindComponentByClass<UGOAPWorldStateProvider>() : nullptr)
+		{
+			Footprint.Memory += GetObjectSize(Provider);
+			TArray<UObject*> Atoms;
+			GetObjectsWithOuter(Provider, Atoms, false);
+			for(UObject* Object : Atoms)
+			{
+				if(UGOAPWorldStateAtom* Atom = Cast<UGOAPWorldStateAtom>(Object))
+				{
+					Footprint.Memory += GetObjectSize(Atom);
+					Payloads.Add(Atom->GetWorldStateValueRef().Payload);
+				}
+			}
+		}
+
+		for(UGOAPWorldStatePayload* Payload : Payloads)
+		{
+			Footprint.Payloads += GetObjectSize(Payload);
+		}
+		return Footprint;
+	}
+
+	void DumpMemory(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const bool bSummaryOnly = Args.Contains(TEXT("Summary"));
+
+		FFootprint TotalFootprint;
+		int32 AgentsNum = 0;
+		for(TObjectIterator<UGOAPPlanner> It; It; ++It)
+		{
+			UGOAPPlanner* Planner = *It;
+			if(Planner->GetWorld() != World || Planner->IsTemplate())
+				continue;
+
+			const FFootprint Footprint = GetPlannerFootprint(Planner);
+			if(!bSummaryOnly)
+			{
+				Ar.Logf(TEXT("%s: %s"), *GetNameSafe(Planner->GetOwner()), *Footprint.ToString());
+			}
+			TotalFootprint += Footprint;
+			++AgentsNum;
+		}
+
+		// payloads created during planning or by gameplay code live in transient package until garbage collection
+		int32 PayloadsNum = 0;
+		int64 PayloadsSize = 0;
+		for(TObjectIterator<UGOAPWorldStatePayload> It; It; ++It)
+		{
+			if(It->IsTemplate())
+				continue;
+
+			++PayloadsNum;
+			PayloadsSize += GetObjectSize(*It);
+		}
+
+		Ar.Logf(TEXT("GOAP agents: %d, %s"), AgentsNum, *TotalFootprint.ToString());
+		if(AgentsNum > 0)
+		{
+			Ar.Logf(TEXT("Average per agent: %.1f KB"), TotalFootprint.GetTotal() / 1024.0 / AgentsNum);
+		}
+		Ar.Logf(TEXT("All payload objects: %d, %.1f KB"), PayloadsNum, PayloadsSize / 1024.0);
+	}
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpMemoryCommand(
+		TEXT("GOAP.DumpMemory"),
+		TEXT("Dump memory used by GOAP agents (planner, solver, plans, memory, payloads). Use \"GOAP.DumpMemory Summary\" "
+			"to print only aggregate values."),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&DumpMemory));
+}
@@ -8,6 +8,13 @@
 #include "GOAPAgent.h"
 #include "GOAPSolver.h"
 #include "GOAPGoal.h"
+#include "GOAPHookProfiler.h"
+#include "GOAPPlannerSubsystem.h"
+#include "GOAPStats.h"
+#include "GOAPWorldStateFunctionLibrary.h"
+#include "GOAPWorldStatePayloads.h"
+#include "GOAPWorldStateProvider.h"
+#include "TimerManager.h"
 
 UGOAPPlanner::UGOAPPlanner()
 {
@@ -20,6 +27,7 @@ UGOAPPlanner::UGOAPPlanner()
 void UGOAPPlanner::BeginPlay()
 {
 	Super::BeginPlay();
+	LLM_SCOPE_BYTAG(GOAP);
 
 	// create solver
 	Solver = NewObject<UGOAPSolver>(this, SolverImplementationClass);
@@ -44,32 +52,219 @@ void UGOAPPlanner::BeginPlay()
 	}
 }
 
+void UGOAPPlanner::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(const UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(GoalsEvaluationTimerHandle);
+		if(UGOAPPlannerSubsystem* Scheduler = World->GetSubsystem<UGOAPPlannerSubsystem>())
+		{
+			Scheduler->CancelPlannerUpdate(this);
+		}
+	}
+
+	// stop listening to any world state and memory changes
+	if(AgentsMemoryComponent)
+	{
+		AgentsMemoryComponent->OnMemoryChangedDelegate.RemoveDynamic(this, &UGOAPPlanner::OnMemoryChanged);
+		for(AActor* MemoryActor : AgentsMemoryComponent->GetMemory())
+		{
+			UnsubscribeWorldStateProvider(MemoryActor);
+		}
+	}
+	UnsubscribeWorldStateProvider(GetOwner());
+	
+	Super::EndPlay(EndPlayReason);
+}
+
 void UGOAPPlanner::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	// // @warning: by default it not tick every frame (and shouldn't tick every frame) - see constructor
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-	
-	// validate if current goal is best goal on each tick
+
+	if(bUseScheduler)
+	{
+		// scheduler will update planner when its frame budget allows
+		if(UGOAPPlannerSubsystem* Scheduler = GetWorld()->GetSubsystem<UGOAPPlannerSubsystem>())
+		{
+			Scheduler->RequestPlannerUpdate(this);
+			return;
+		}
+	}
+
+	UpdatePlanner();
+}
+
+void UGOAPPlanner::SetUseScheduler(bool bInUseScheduler)
+{
+	if(bUseScheduler && !bInUseScheduler)
+	{
+		if(UGOAPPlannerSubsystem* Scheduler = GetWorld() ? GetWorld()->GetSubsystem<UGOAPPlannerSubsystem>() : nullptr)
+		{
+			Scheduler->CancelPlannerUpdate(this);
+		}
+	}
+	bUseScheduler = bInUseScheduler;
+}
+
+void UGOAPPlanner::UpdatePlanner()
+{
+	if(GoalsEvaluationMode == EGOAPGoalsEvaluationMode::Polling)
+	{
+		EvaluateGoals();
+		return;
+	}
+
+	// event driven mode - planner ticks only if goals evaluation was requested
+	bGoalsEvaluationPending = false;
+	if(!EvaluateGoals())
+	{
+		// goal can't be changed at this moment - try again on next tick
+		bGoalsEvaluationPending = true;
+	}
+	// evaluation could be requested again during switching goal (e.g. plan failed immediately)
+	if(bGoalsEvaluationPending)
+		return;
+
+	// nothing to do until next change - stop ticking, but evaluate goals anyway after max interval
+	SetComponentTickEnabled(false);
+	GetWorld()->GetTimerManager().SetTimer(GoalsEvaluationTimerHandle, this, &UGOAPPlanner::RequestGoalsEvaluation,
+		MaxGoalsEvaluationInterval, false);
+}
+
+bool UGOAPPlanner::EvaluateGoals()
+{
+	// validate if current goal is best goal (or was chosen from the best goals by multi-goal planning)
 	UGOAPGoal* CurrentBestGoal = FindBestScoredGoal();
-	if(PursuedGoal != CurrentBestGoal)
+	if((PursuedGoal ? PursuedGoalBestGoal : nullptr) != CurrentBestGoal)
 	{
-		UObject* ActiveAction = IGOAPActionsExecutor::Execute_GetActiveAction(ActionsExecutor);
+		UObject* ActiveAction = GetExecutorActiveAction();
 		if(ActiveAction)
 		{
 			// can't cancel ability so can't change goal at this moment
-			if(!IGOAPAction::Execute_CanBeCanceled(ActiveAction))
-				return;
+			if(!CanActionBeCanceled(ActiveAction))
+				return false;
 			// cancel ability if possible to switch goal; must be CDO object
-			IGOAPActionsExecutor::Execute_CancelAction(ActionsExecutor, ActiveAction);
+			CancelExecutorAction(ActiveAction);
 		}
 		// switch to other goal
-		SetPursuedGoal(CurrentBestGoal);
+		if(MultiGoalPlanningCount > 1)
+		{
+			SetPursuedGoalOfBestGoals(CurrentBestGoal);
+		}
+		else
+		{
+			SetPursuedGoal(CurrentBestGoal);
+		}
+	}
+	return true;
+}
+
+void UGOAPPlanner::RequestGoalsEvaluation()
+{
+	bGoalsEvaluationPending = true;
+	
+	if(GoalsEvaluationMode == EGOAPGoalsEvaluationMode::EventDriven)
+	{
+		if(const UWorld* World = GetWorld())
+		{
+			World->GetTimerManager().ClearTimer(GoalsEvaluationTimerHandle);
+		}
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UGOAPPlanner::OnMemoryChanged(AActor* Actor, bool bRegistered)
+{
+	if(bRegistered)
+	{
+		SubscribeWorldStateProvider(Actor);
+	}
+	else
+	{
+		// plan can still depend on world state of forgotten actor
+		const bool bIsPlanDependency = ExecutingPlanDependencies.ContainsByPredicate([Actor](const FGOAPPlanDependency& Dependency)
+		{
+			return Dependency.RequiredWorldState.WorldStateKey.WorldStateActor == Actor;
+		});
+		if(!bIsPlanDependency)
+		{
+			UnsubscribeWorldStateProvider(Actor);
+		}
+	}
+
+	// failed goal can be achievable with changed memory
+	if(FailedGoal && FailedGoal->IsDependentOnMemory())
+	{
+		FailedGoal = nullptr;
+	}
+
+	const bool bAnyGoalDependent = Goals.ContainsByPredicate([](const UGOAPGoal* Goal)
+	{
+		return Goal->IsDependentOnMemory();
+	});
+	if(bAnyGoalDependent)
+	{
+		RequestGoalsEvaluation();
+	}
+}
+
+void UGOAPPlanner::OnWorldStateChanged(AActor* Actor, const FGameplayTag& WorldStateAtomTag)
+{
+	if(IsCurrentlyExecutingPlan())
+	{
+		UpdatePlanDependencies(Actor, WorldStateAtomTag);
+	}
+
+	// failed goal can be achievable with changed world state
+	if(FailedGoal && FailedGoal->IsDependentOnWorldState(WorldStateAtomTag))
+	{
+		FailedGoal = nullptr;
+	}
+	
+	const bool bAnyGoalDependent = Goals.ContainsByPredicate([&WorldStateAtomTag](const UGOAPGoal* Goal)
+	{
+		return Goal->IsDependentOnWorldState(WorldStateAtomTag);
+	});
+	if(bAnyGoalDependent)
+	{
+		RequestGoalsEvaluation();
+	}
+}
+
+void UGOAPPlanner::SubscribeWorldStateProvider(AActor* Actor)
+{
+	if(!Actor)
+		return;
+
+	UGOAPWorldStateProvider* WorldStateProvider =
+		Cast<UGOAPWorldStateProvider>(Actor->GetComponentByClass(UGOAPWorldStateProvider::StaticClass()));
+	if(!WorldStateProvider)
+		return;
+
+	// avoid double subscription when actor is registered in memory more than once
+	WorldStateProvider->OnWorldStateChanged.RemoveAll(this);
+	WorldStateProvider->OnWorldStateChanged.AddUObject(this, &UGOAPPlanner::OnWorldStateChanged);
+}
+
+void UGOAPPlanner::UnsubscribeWorldStateProvider(AActor* Actor)
+{
+	if(!Actor)
+		return;
+
+	UGOAPWorldStateProvider* WorldStateProvider =
+		Cast<UGOAPWorldStateProvider>(Actor->GetComponentByClass(UGOAPWorldStateProvider::StaticClass()));
+	if(WorldStateProvider)
+	{
+		WorldStateProvider->OnWorldStateChanged.RemoveAll(this);
 	}
 }
 
 void UGOAPPlanner::InitializePlanner(UGOAPMemoryComponent* InMemoryComponent, UObject* InActionExecutor,
 	TArray<UObject*> InActions)
 {
+	LLM_SCOPE_BYTAG(GOAP);
+	
 	AgentsMemoryComponent = InMemoryComponent;
 	ensureMsgf(AgentsMemoryComponent, TEXT("Not valid UGOAPMemoryComponent passed to InitializePlanner!"));
 	
@@ -87,6 +282,18 @@ void UGOAPPlanner::InitializePlanner(UGOAPMemoryComponent* InMemoryComponent, UO
 			Actions.Add(Action);
 		}
 	}
+
+	// in event driven mode listen to all changes which can affect goals
+	if(GoalsEvaluationMode == EGOAPGoalsEvaluationMode::EventDriven && AgentsMemoryComponent)
+	{
+		AgentsMemoryComponent->OnMemoryChangedDelegate.AddUniqueDynamic(this, &UGOAPPlanner::OnMemoryChanged);
+		for(AActor* MemoryActor : AgentsMemoryComponent->GetMemory())
+		{
+			SubscribeWorldStateProvider(MemoryActor);
+		}
+		SubscribeWorldStateProvider(GetOwner());
+		RequestGoalsEvaluation();
+	}
 }
 
 void UGOAPPlanner::AddGoal(TSubclassOf<UGOAPGoal> GoalClass)
@@ -103,6 +310,7 @@ void UGOAPPlanner::AddGoal(TSubclassOf<UGOAPGoal> GoalClass)
 	if(GoalIndex != INDEX_NONE)
 		return;
 	
+	LLM_SCOPE_BYTAG(GOAP);
 	UGOAPGoal* NewGoal = NewObject<UGOAPGoal>(this, GoalClass);
 	if(!NewGoal)
 	{
@@ -112,6 +320,9 @@ void UGOAPPlanner::AddGoal(TSubclassOf<UGOAPGoal> GoalClass)
 	
 	NewGoal->AgentActor = TScriptInterface<IGOAPAgent>(GetOwner());
 	Goals.Add(NewGoal);
+	// scores batched by scheduler refer to previous goals
+	BatchedUtilityScores.Reset();
+	RequestGoalsEvaluation();
 }
 
 void UGOAPPlanner::RemoveGoal(TSubclassOf<UGOAPGoal> GoalClass)
@@ -131,17 +342,24 @@ void UGOAPPlanner::RemoveGoal(TSubclassOf<UGOAPGoal> GoalClass)
 	if(GetPursuedGoal() == Goals[GoalIndex])
 	{
 		// current goal is goal to remove
-		UObject* ActiveAction = IGOAPActionsExecutor::Execute_GetActiveAction(ActionsExecutor);
+		UObject* ActiveAction = GetExecutorActiveAction();
 		if(ActiveAction)
 		{
 			// cancel ability if possible to switch goal; must be CDO object
-			IGOAPActionsExecutor::Execute_CancelAction(ActionsExecutor, ActiveAction);
+			CancelExecutorAction(ActiveAction);
 			// reset pursued goal to force the planner to find another plan
 			PursuedGoal = nullptr;
 		}
 	}
 
+	if(FailedGoal == Goals[GoalIndex])
+	{
+		FailedGoal = nullptr;
+	}
+
 	Goals.RemoveAt(GoalIndex);
+	BatchedUtilityScores.Reset();
+	RequestGoalsEvaluation();
 }
 
 TArray<UObject*> UGOAPPlanner::GetActions()
@@ -159,27 +377,182 @@ TArray<UObject*> UGOAPPlanner::GetActions()
 
 UGOAPGoal* UGOAPPlanner::FindBestScoredGoal()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GOAP_GoalsScoring);
+	
 	float BestScore = 0.0f;
 	UGOAPGoal* BestGoal = nullptr;
-	for(const auto Goal : Goals)
+
+	// goals with native scores are evaluated all at once after Blueprint ones - by scheduler together with goals of
+	// all planners updated in this frame (see SetUtilityGoalsScores) or by own batch
+	const bool bUtilityScoresBatched = UtilityScoresFrame == GFrameCounter &&
+		BatchedUtilityScores.Num() == Goals.Num();
+	UtilityScoringBatch.Reset();
+	TArray<int32> UtilityGoalsIndexes;
+	LastGoalsScores.Reset();
+	LastGoalsScores.SetNumZeroed(Goals.Num());
+	
+	for(int32 GoalIndex = 0; GoalIndex < Goals.Num(); ++GoalIndex)
 	{
-		if(!Goal->IsGoalValid())
+		UGOAPGoal* Goal = Goals[GoalIndex];
+
+		// goal which plan failed to start waits for change of its world state (or max interval)
+		if(Goal == FailedGoal)
+		{
+			if(GetWorld()->GetTimeSeconds() < FailedGoalRetryTime)
+				continue;
+			FailedGoal = nullptr;
+		}
+		
+		// cheap native check - there is nothing to do for goal which is already satisfied
+		if(Goal->ShouldSkipWhenSatisfied())
+		{
+			const FGOAPGoalPredicate& Predicate = Goal->GetCompiledPredicate();
+			if(!Predicate.IsEmpty() && Predicate.IsSatisfied())
+			{
+				LastGoalsScores[GoalIndex] = -1.0f;
+				continue;
+			}
+		}
+		
+		if(Goal->GetScoringMode() == EGOAPGoalScoringMode::Utility)
+		{
+			if(!Goal->ShouldCheckBlueprintValidity() || IsGoalValid(Goal))
+			{
+				if(!bUtilityScoresBatched)
+				{
+					UtilityScoringBatch.AddGoal(Goal);
+				}
+				UtilityGoalsIndexes.Add(GoalIndex);
+			}
+			continue;
+		}
+		
+		if(!IsGoalValid(Goal))
 			continue;
 			
-		const float GoalScore = Goal->GetGoalScore();
+		float GoalScore;
+		{
+			GOAP_HOOK_SCOPE(Goal, GoalScore);
+			GoalScore = Goal->GetGoalScore();
+		}
+		LastGoalsScores[GoalIndex] = GoalScore;
 		if(GoalScore > BestScore)
 		{
 			BestScore = GoalScore;
 			BestGoal = Goal;
 		}
 	}
+
+	if(UtilityGoalsIndexes.Num() > 0)
+	{
+		TArray<float> UtilityScores;
+		if(!bUtilityScoresBatched)
+		{
+			UtilityScoringBatch.Evaluate(UtilityScores);
+		}
+		for(int32 Index = 0; Index < UtilityGoalsIndexes.Num(); ++Index)
+		{
+			const int32 GoalIndex = UtilityGoalsIndexes[Index];
+			const float GoalScore = bUtilityScoresBatched ? BatchedUtilityScores[GoalIndex] : UtilityScores[Index];
+			LastGoalsScores[GoalIndex] = GoalScore;
+			if(GoalScore > BestScore)
+			{
+				BestScore = GoalScore;
+				BestGoal = Goals[GoalIndex];
+			}
+		}
+	}
+	
 	return BestGoal;
 }
 
+bool UGOAPPlanner::AddUtilityGoalsToBatch(FGOAPUtilityScoringBatch& Batch)
+{
+	// validity of goals is checked by goals evaluation, batch only gathers inputs of all native goals
+	bool bAnyGoalAdded = false;
+	UtilityGoalsBatchIndexes.Reset();
+	UtilityGoalsBatchIndexes.Init(INDEX_NONE, Goals.Num());
+	for(int32 GoalIndex = 0; GoalIndex < Goals.Num(); ++GoalIndex)
+	{
+		if(Goals[GoalIndex]->GetScoringMode() == EGOAPGoalScoringMode::Utility)
+		{
+			UtilityGoalsBatchIndexes[GoalIndex] = Batch.AddGoal(Goals[GoalIndex]);
+			bAnyGoalAdded = true;
+		}
+	}
+	return bAnyGoalAdded;
+}
+
+void UGOAPPlanner::SetUtilityGoalsScores(const TArray<float>& BatchScores)
+{
+	BatchedUtilityScores.Reset();
+	BatchedUtilityScores.SetNumZeroed(UtilityGoalsBatchIndexes.Num());
+	for(int32 GoalIndex = 0; GoalIndex < UtilityGoalsBatchIndexes.Num(); ++GoalIndex)
+	{
+		if(UtilityGoalsBatchIndexes[GoalIndex] != INDEX_NONE)
+		{
+			BatchedUtilityScores[GoalIndex] = BatchScores[UtilityGoalsBatchIndexes[GoalIndex]];
+		}
+	}
+	UtilityScoresFrame = GFrameCounter;
+}
+
 void UGOAPPlanner::SetPursuedGoal(UGOAPGoal* Goal)
 {
 	PursuedGoal = Goal;
-	TArray<FGOAPActionWithTargetData> Plan = Solver->FindPlanForGoal(PursuedGoal);
+	PursuedGoalBestGoal = Goal;
+	TArray<FGOAPActionWithTargetData> Plan;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_FindPlan);
+		Plan = Solver->FindPlanForGoal(PursuedGoal);
+		++SearchesNum;
+	}
+	StartPursuedGoalPlan(Plan);
+}
+
+void UGOAPPlanner::SetPursuedGoalOfBestGoals(UGOAPGoal* BestGoal)
+{
+	// valid goals in order of scores (the best one first)
+	TArray<int32> GoalsIndexes;
+	for(int32 GoalIndex = 0; GoalIndex < LastGoalsScores.Num(); ++GoalIndex)
+	{
+		if(LastGoalsScores[GoalIndex] > 0.0f)
+		{
+			GoalsIndexes.Add(GoalIndex);
+		}
+	}
+	GoalsIndexes.StableSort([this](int32 GoalOne, int32 GoalTwo)
+	{
+		return LastGoalsScores[GoalOne] > LastGoalsScores[GoalTwo];
+	});
+	if(GoalsIndexes.Num() <= 1)
+	{
+		SetPursuedGoal(BestGoal);
+		return;
+	}
+
+	TArray<UGOAPGoal*> BestGoals;
+	TArray<float> BestGoalsScores;
+	for(int32 Index = 0; Index < FMath::Min(GoalsIndexes.Num(), MultiGoalPlanningCount); ++Index)
+	{
+		BestGoals.Add(Goals[GoalsIndexes[Index]]);
+		BestGoalsScores.Add(LastGoalsScores[GoalsIndexes[Index]]);
+	}
+
+	int32 PlannedGoalIndex;
+	TArray<FGOAPActionWithTargetData> Plan;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_FindPlan);
+		Plan = Solver->FindPlanForGoals(BestGoals, BestGoalsScores, PlanCostScoreWeight, PlannedGoalIndex);
+		++SearchesNum;
+	}
+	PursuedGoal = PlannedGoalIndex != INDEX_NONE ? BestGoals[PlannedGoalIndex] : BestGoal;
+	PursuedGoalBestGoal = BestGoal;
+	StartPursuedGoalPlan(Plan);
+}
+
+void UGOAPPlanner::StartPursuedGoalPlan(const TArray<FGOAPActionWithTargetData>& Plan)
+{
 	if(Plan.Num() > 0)
 	{
 		// info log
@@ -196,7 +569,12 @@ void UGOAPPlanner::SetPursuedGoal(UGOAPGoal* Goal)
 		}
 		else
 		{
+			// drop plan and goal, so goals are evaluated again instead of waiting for change of the best goal; failed
+			// goal is skipped until anything it depends on changes, otherwise it would be planned again on each tick
 			UE_LOG(LogGOAP, Log, TEXT("Execution failed!"));
+			FailedGoal = PursuedGoal;
+			FailedGoalRetryTime = GetWorld()->GetTimeSeconds() + MaxGoalsEvaluationInterval;
+			FinishExecutePlan();
 		}
 	}
 }
@@ -206,39 +584,76 @@ bool UGOAPPlanner::ExecutePlan(TArray<FGOAPActionWithTargetData> Plan)
 	if(Plan.Num() == 0 )
 		return false;
 
+	LLM_SCOPE_BYTAG(GOAP_Plans);
 	ExecutingPlan = Plan;
 	ExecutingPlanActionIndex = 0;
-	CurrentActionHandle.Reset();
+	// previous action could be canceled without reporting its end - stop waiting for it
+	if(CurrentActionHandle.IsValid())
+	{
+		Cast<IGOAPActionsExecutor>(ActionsExecutor)->OnActionEnded.Remove(CurrentActionHandle);
+		CurrentActionHandle.Reset();
+	}
+
+	if(!CollectPlanDependencies())
+	{
+		UE_LOG(LogGOAP, Log, TEXT("Plan requires world state which is not met!"));
+		return false;
+	}
 
 	return ExecuteCurrentAction();
 }
 
 bool UGOAPPlanner::ExecuteCurrentAction()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GOAP_PlanExecution);
+	
 	// can't activate action if another isn't finished
 	if(CurrentActionHandle.IsValid())
 		return false;
+
+	// validate action's preconditions from cached values before activation
+	for(const FGOAPPlanDependency& Dependency : ExecutingPlanDependencies)
+	{
+		if(Dependency.StepIndex == ExecutingPlanActionIndex && !Dependency.bMet)
+		{
+			UE_LOG(LogGOAP, Log, TEXT("Precondition of %s is not met - action not activated!"),
+				*ExecutingPlan[ExecutingPlanActionIndex].Action->GetName());
+			return false;
+		}
+	}
 	
 	CurrentActionHandle = Cast<IGOAPActionsExecutor>(ActionsExecutor)->OnActionEnded.AddUObject(this, &UGOAPPlanner::OnAbilityEnded);
 
 	// set target data for ability before activation
-	IGOAPAction::Execute_SetActionTargetData(ExecutingPlan[ExecutingPlanActionIndex].Action,
-		ExecutingPlan[ExecutingPlanActionIndex].TargetData);
-	const bool ActivationSuccess =
-		IGOAPActionsExecutor::Execute_TryActivateActionByClass(ActionsExecutor,
+	{
+		GOAP_HOOK_SCOPE(ExecutingPlan[ExecutingPlanActionIndex].Action, ActionSetTargetData);
+		IGOAPAction::Execute_SetActionTargetData(ExecutingPlan[ExecutingPlanActionIndex].Action,
+			ExecutingPlan[ExecutingPlanActionIndex].TargetData);
+	}
+	bool ActivationSuccess;
+	{
+		GOAP_HOOK_SCOPE(ActionsExecutor, ExecutorActivateAction);
+		ActivationSuccess = IGOAPActionsExecutor::Execute_TryActivateActionByClass(ActionsExecutor,
 			ExecutingPlan[ExecutingPlanActionIndex].Action->GetClass());
+	}
 	if(!ActivationSuccess)
+	{
+		Cast<IGOAPActionsExecutor>(ActionsExecutor)->OnActionEnded.Remove(CurrentActionHandle);
+		CurrentActionHandle.Reset();
 		return false;
+	}
 
 	return true;
 }
 
 void UGOAPPlanner::OnAbilityEnded(const UObject* Action, bool bSuccess)
 {
+	SCOPE_CYCLE_COUNTER(STAT_GOAP_PlanExecution);
+	
 	Cast<IGOAPActionsExecutor>(ActionsExecutor)->OnActionEnded.Remove(CurrentActionHandle);
 	CurrentActionHandle.Reset();
 	
-	if(!bSuccess)
+	if(!bSuccess || bExecutingPlanInvalidated)
 	{
 		FinishExecutePlan();
 		return;
@@ -264,8 +679,154 @@ bool UGOAPPlanner::IsCurrentlyExecutingPlan() const
 
 void UGOAPPlanner::FinishExecutePlan()
 {
+	// stop listening to world states which were relevant only for this plan
+	for(const FGOAPPlanDependency& Dependency : ExecutingPlanDependencies)
+	{
+		AActor* DependencyActor = Dependency.RequiredWorldState.WorldStateKey.WorldStateActor;
+		if(!IsWorldStateObservedForGoals(DependencyActor))
+		{
+			UnsubscribeWorldStateProvider(DependencyActor);
+		}
+	}
+	ExecutingPlanDependencies.Reset();
+	bExecutingPlanInvalidated = false;
+	
 	ExecutingPlan.Reset();
 	ExecutingPlanActionIndex = -1;
 	
 	PursuedGoal = nullptr;
-}
\ No newline at end of file
+	// goal is finished (or failed) - new one has to be selected
+	RequestGoalsEvaluation();
+}
+
+bool UGOAPPlanner::CollectPlanDependencies()
+{
+	ExecutingPlanDependencies.Reset();
+	bExecutingPlanInvalidated = false;
+	
+	bool bAllDependenciesMet = true;
+	for(int32 StepIndex = 0; StepIndex < ExecutingPlan.Num(); ++StepIndex)
+	{
+		const FGOAPActionWithTargetData& Step = ExecutingPlan[StepIndex];
+		TArray<FGOAPWorldStateData> Preconditions;
+		{
+			GOAP_HOOK_SCOPE(Step.Action, ActionPreconditions);
+			Preconditions = IGOAPAction::Execute_GetWorldStatePreconditions(Step.Action, Step.TargetData, GetAgent());
+		}
+		for(const FGOAPWorldStateData& Precondition : Preconditions)
+		{
+			// precondition achieved by previous action isn't dependency on world
+			bool bAchievedByPlan = false;
+			for(int32 PreviousStepIndex = 0; PreviousStepIndex < StepIndex; ++PreviousStepIndex)
+			{
+				const FGOAPWorldStateData& PreviousEffect = ExecutingPlan[PreviousStepIndex].TargetData;
+				if(PreviousEffect.WorldStateKey == Precondition.WorldStateKey && Precondition.WorldStateValue.Payload &&
+					Precondition.WorldStateValue.Payload->IsEqual(PreviousEffect.WorldStateValue.Payload))
+				{
+					bAchievedByPlan = true;
+					break;
+				}
+			}
+			if(bAchievedByPlan)
+				continue;
+			if(!Precondition.WorldStateValue.Payload)
+			{
+				UE_LOG(LogGOAP, Warning, TEXT("Precondition of %s has no value - it's ignored!"),
+					*Step.Action->GetName());
+				continue;
+			}
+
+			const bool bMet = UGOAPWorldStateFunctionLibrary::IsWorldStateActual(Precondition);
+			bAllDependenciesMet &= bMet;
+			ExecutingPlanDependencies.Add(FGOAPPlanDependency(Precondition, StepIndex, bMet));
+			SubscribeWorldStateProvider(Precondition.WorldStateKey.WorldStateActor);
+		}
+	}
+	return bAllDependenciesMet;
+}
+
+void UGOAPPlanner::UpdatePlanDependencies(AActor* Actor, const FGameplayTag& WorldStateAtomTag)
+{
+	bool bNextActionsBroken = false;
+	for(FGOAPPlanDependency& Dependency : ExecutingPlanDependencies)
+	{
+		// dependencies of actions already activated don't matter anymore
+		if(Dependency.StepIndex < ExecutingPlanActionIndex)
+			continue;
+		
+		const FGOAPWorldStateKey& Key = Dependency.RequiredWorldState.WorldStateKey;
+		if(Key.WorldStateActor != Actor || !Key.WorldStateDataTag.MatchesTagExact(WorldStateAtomTag))
+			continue;
+
+		Dependency.bMet = UGOAPWorldStateFunctionLibrary::IsWorldStateActual(Dependency.RequiredWorldState);
+		bNextActionsBroken |= !Dependency.bMet && Dependency.StepIndex > ExecutingPlanActionIndex;
+	}
+
+	if(bNextActionsBroken)
+	{
+		InvalidateExecutingPlan();
+	}
+}
+
+void UGOAPPlanner::InvalidateExecutingPlan()
+{
+	UE_LOG(LogGOAP, Log, TEXT("World state required by plan changed - plan invalidated!"));
+	
+	UObject* ActiveAction = GetExecutorActiveAction();
+	if(ActiveAction && CurrentActionHandle.IsValid())
+	{
+		// plan will be finished after current action
+		if(!CanActionBeCanceled(ActiveAction))
+		{
+			bExecutingPlanInvalidated = true;
+			return;
+		}
+		Cast<IGOAPActionsExecutor>(ActionsExecutor)->OnActionEnded.Remove(CurrentActionHandle);
+		CurrentActionHandle.Reset();
+		CancelExecutorAction(ActiveAction);
+	}
+	FinishExecutePlan();
+
+	// find new plan as soon as possible, but not inside world state change notification
+	if(bUseScheduler)
+	{
+		if(UGOAPPlannerSubsystem* Scheduler = GetWorld()->GetSubsystem<UGOAPPlannerSubsystem>())
+		{
+			Scheduler->RequestPlannerUpdate(this);
+			return;
+		}
+	}
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UGOAPPlanner::UpdatePlanner);
+}
+
+bool UGOAPPlanner::IsWorldStateObservedForGoals(AActor* Actor) const
+{
+	if(GoalsEvaluationMode != EGOAPGoalsEvaluationMode::EventDriven)
+		return false;
+	
+	return Actor == GetOwner() || (AgentsMemoryComponent && AgentsMemoryComponent->IsActorInMemory(Actor));
+}
+
+bool UGOAPPlanner::IsGoalValid(UGOAPGoal* Goal) const
+{
+	GOAP_HOOK_SCOPE(Goal, GoalValidity);
+	return Goal->IsGoalValid();
+}
+
+UObject* UGOAPPlanner::GetExecutorActiveAction() const
+{
+	GOAP_HOOK_SCOPE(ActionsExecutor, ExecutorGetActiveAction);
+	return IGOAPActionsExecutor::Execute_GetActiveAction(ActionsExecutor);
+}
+
+bool UGOAPPlanner::CanActionBeCanceled(UObject* Action) const
+{
+	GOAP_HOOK_SCOPE(Action, ActionCanBeCanceled);
+	return IGOAPAction::Execute_CanBeCanceled(Action);
+}
+
+void UGOAPPlanner::CancelExecutorAction(UObject* Action) const
+{
+	GOAP_HOOK_SCOPE(ActionsExecutor, ExecutorCancelAction);
+	IGOAPActionsExecutor::Execute_CancelAction(ActionsExecutor, Action);
+}
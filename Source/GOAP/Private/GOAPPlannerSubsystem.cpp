@@ -0,0 +1,210 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPPlannerSubsystem.h"
+
+#include "GOAPPlanner.h"
+#include "GOAPSettings.h"
+#include "GOAPStats.h"
+#include "GameFramework/PlayerController.h"
+
+void UGOAPPlannerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_GOAP_SchedulerUpdate);
+
+	const UGOAPSettings* Settings = GetDefault<UGOAPSettings>();
+	const double FrameStartTime = FPlatformTime::Seconds();
+	const double FrameEndTime = FrameStartTime + Settings->SchedulerFrameBudgetMs / 1000.0;
+	// budget usually allows similar number of updates as in last frame
+	const int32 ExpectedUpdatesNum = FMath::Max(Metrics.UpdatedPlannersLastFrame, 1);
+
+	Metrics.UpdatedPlannersLastFrame = 0;
+	Metrics.MaxLatencyLastFrame = 0.0f;
+	Metrics.StarvedRequestsLastFrame = 0;
+
+	// remove requests of destroyed planners
+	Requests.RemoveAllSwap([](const FGOAPPlannerUpdateRequest& Request)
+	{
+		return !Request.Planner.IsValid();
+	});
+	if(Requests.Num() == 0)
+	{
+		Metrics.QueueDepth = 0;
+		Metrics.UpdateTimeLastFrameMs = 0.0f;
+		return;
+	}
+
+	// viewers locations are the same for all requests
+	TArray<FVector> ViewLocations;
+	for(FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		if(const APlayerController* PlayerController = Iterator->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	// prioritize requests - starving requests first, then by significance increased by waiting time
+	for(FGOAPPlannerUpdateRequest& Request : Requests)
+	{
+		const float WaitTime = FrameStartTime - Request.RequestTime;
+		Request.bStarving = WaitTime >= Settings->SchedulerMaxRequestWaitTime;
+		Request.Priority = CalculateSignificance(Request.Planner.Get(), ViewLocations) +
+			WaitTime * Settings->SchedulerWaitTimeSignificance;
+	}
+	Requests.Sort([](const FGOAPPlannerUpdateRequest& A, const FGOAPPlannerUpdateRequest& B)
+	{
+		if(A.bStarving != B.bStarving)
+			return A.bStarving;
+		return A.Priority > B.Priority;
+	});
+	ScoreUtilityGoals(ExpectedUpdatesNum);
+
+	// planners updates can request, cancel or destroy planners, so processed requests are moved out of the queue;
+	// requests added during processing wait for next frame
+	ProcessedRequests = MoveTemp(Requests);
+	Requests.Reset();
+
+	// process requests while budget allows; at least one request is processed each frame
+	int32 ProcessedNum = 0;
+	for(FGOAPPlannerUpdateRequest& Request : ProcessedRequests)
+	{
+		// request canceled (or planner destroyed) by update of other planner
+		UGOAPPlanner* Planner = Request.Planner.Get();
+		if(!Planner)
+			continue;
+
+		const double CurrentTime = FPlatformTime::Seconds();
+		const bool bBudgetExhausted = ProcessedNum > 0 && CurrentTime >= FrameEndTime;
+		if(bBudgetExhausted && !Request.bStarving)
+			break;
+		
+		if(bBudgetExhausted)
+		{
+			++Metrics.StarvedRequestsLastFrame;
+		}
+
+		const float Latency = CurrentTime - Request.RequestTime;
+		Metrics.MaxLatencyLastFrame = FMath::Max(Metrics.MaxLatencyLastFrame, Latency);
+		Metrics.AverageLatency = FMath::Lerp(Metrics.AverageLatency, Latency, 0.05f);
+
+		// processed request is cleared before update, so planner can request update again during its update
+		Request.Planner.Reset();
+		Planner->UpdatePlanner();
+		++ProcessedNum;
+	}
+
+	// not processed requests go back to the front of the queue (their planners couldn't be requested again, see
+	// RequestPlannerUpdate)
+	ProcessedRequests.RemoveAll([](const FGOAPPlannerUpdateRequest& Request)
+	{
+		return !Request.Planner.IsValid();
+	});
+	Requests.Insert(MoveTemp(ProcessedRequests), 0);
+	ProcessedRequests.Reset();
+
+	Metrics.UpdatedPlannersLastFrame = ProcessedNum;
+	Metrics.QueueDepth = Requests.Num();
+	SET_DWORD_STAT(STAT_GOAP_SchedulerQueueDepth, Metrics.QueueDepth);
+	Metrics.UpdateTimeLastFrameMs = (FPlatformTime::Seconds() - FrameStartTime) * 1000.0;
+}
+
+TStatId UGOAPPlannerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGOAPPlannerSubsystem, STATGROUP_Tickables);
+}
+
+void UGOAPPlannerSubsystem::RequestPlannerUpdate(UGOAPPlanner* Planner)
+{
+	if(!Planner)
+		return;
+
+	// requests waiting in ProcessedRequests (during Tick) are still valid, processed ones are already cleared
+	const auto IsPlannerRequest = [Planner](const FGOAPPlannerUpdateRequest& Request)
+	{
+		return Request.Planner == Planner;
+	};
+	const bool bAlreadyRequested = Requests.ContainsByPredicate(IsPlannerRequest) ||
+		ProcessedRequests.ContainsByPredicate(IsPlannerRequest);
+	if(!bAlreadyRequested)
+	{
+		Requests.Add(FGOAPPlannerUpdateRequest(Planner, FPlatformTime::Seconds()));
+	}
+}
+
+void UGOAPPlannerSubsystem::CancelPlannerUpdate(UGOAPPlanner* Planner)
+{
+	Requests.RemoveAll([Planner](const FGOAPPlannerUpdateRequest& Request)
+	{
+		return Request.Planner == Planner;
+	});
+
+	// Tick iterates ProcessedRequests, so request is only cleared there
+	for(FGOAPPlannerUpdateRequest& Request : ProcessedRequests)
+	{
+		if(Request.Planner == Planner)
+		{
+			Request.Planner.Reset();
+		}
+	}
+}
+
+void UGOAPPlannerSubsystem::ScoreUtilityGoals(int32 ExpectedUpdatesNum)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GOAP_GoalsScoring);
+
+	// planners which aren't updated in this frame (budget exhausted sooner) don't use their scores later
+	UtilityScoringBatch.Reset();
+	TArray<UGOAPPlanner*, TInlineAllocator<32>> BatchedPlanners;
+	for(int32 RequestIndex = 0; RequestIndex < Requests.Num(); ++RequestIndex)
+	{
+		// starving requests are sorted first
+		if(RequestIndex >= ExpectedUpdatesNum && !Requests[RequestIndex].bStarving)
+			break;
+
+		UGOAPPlanner* Planner = Requests[RequestIndex].Planner.Get();
+		if(Planner->AddUtilityGoalsToBatch(UtilityScoringBatch))
+		{
+			BatchedPlanners.Add(Planner);
+		}
+	}
+	if(BatchedPlanners.Num() == 0)
+		return;
+
+	TArray<float> UtilityScores;
+	UtilityScoringBatch.Evaluate(UtilityScores);
+	for(UGOAPPlanner* Planner : BatchedPlanners)
+	{
+		Planner->SetUtilityGoalsScores(UtilityScores);
+	}
+}
+
+float UGOAPPlannerSubsystem::CalculateSignificance(const UGOAPPlanner* Planner, const TArray<FVector>& ViewLocations) const
+{
+	const UGOAPSettings* Settings = GetDefault<UGOAPSettings>();
+	
+	float Significance = Planner->GetSchedulingPriority();
+	if(Planner->IsInCombat())
+	{
+		Significance += Settings->SchedulerCombatSignificance;
+	}
+
+	const AActor* Agent = Planner->GetAgent();
+	if(Agent && ViewLocations.Num() > 0)
+	{
+		float MinDistanceSquared = MAX_flt;
+		for(const FVector& ViewLocation : ViewLocations)
+		{
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(ViewLocation, Agent->GetActorLocation()));
+		}
+		const float DistanceFactor = 1.0f - FMath::Clamp(FMath::Sqrt(MinDistanceSquared) /
+			Settings->SchedulerSignificanceDistance, 0.0f, 1.0f);
+		Significance += DistanceFactor * Settings->SchedulerDistanceSignificance;
+	}
+	
+	return Significance;
+}
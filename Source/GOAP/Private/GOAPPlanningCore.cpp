@@ -0,0 +1,1302 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPPlanningCore.h"
+
+namespace GOAPPlanningCore
+{
+	/**
+	 * Desired fact of backward search node. Used to tracking which node produce specified desired fact and which node
+	 * satisfied it.
+	 */
+	struct FDesiredFact
+	{
+		FDesiredFact() {}
+		FDesiredFact(const FGOAPCoreFact& InFact, int32 InInstigatorNodeIndex)
+			: Fact(InFact), InstigatorNodeIndex(InInstigatorNodeIndex) {}
+
+		FGOAPCoreFact Fact;
+		/** Node index which add this desired fact. */
+		int32 InstigatorNodeIndex = INDEX_NONE;
+		/** Node index which satisfied this desired fact. */
+		int32 SatisfiedByNodeIndex = INDEX_NONE;
+	};
+
+	/**
+	 * Regression state - canonical (sorted) set of not satisfied desired facts of backward search node. Expansion of
+	 * node depends only on this set, so nodes of equal regression states reached by different orderings of actions
+	 * are transpositions and only the cheapest of them is expanded.
+	 */
+	struct FRegressionState
+	{
+		TArray<FGOAPCoreFact> Facts;
+		uint32 Hash = 0;
+
+		/** Sort facts and compute hash; has to be called after Facts are changed. */
+		void Finalize()
+		{
+			Facts.Sort([](const FGOAPCoreFact& FactOne, const FGOAPCoreFact& FactTwo)
+			{
+				return FactOne.Key != FactTwo.Key ? FactOne.Key < FactTwo.Key : FactOne.Value < FactTwo.Value;
+			});
+			Hash = 0;
+			for(const FGOAPCoreFact& Fact : Facts)
+			{
+				Hash = HashCombine(Hash, GetTypeHash(Fact));
+			}
+		}
+
+		FORCEINLINE bool operator==(const FRegressionState& Other) const
+		{
+			return Hash == Other.Hash && Facts == Other.Facts;
+		}
+		friend FORCEINLINE uint32 GetTypeHash(const FRegressionState& State) { return State.Hash; }
+	};
+
+	/**
+	 * Node of backward search tree.
+	 */
+	struct FBackwardNode
+	{
+		/** Indexes leading to this node (parents). */
+		TArray<int32> PathToNode;
+		/** Problem's action immediately preceding this node. */
+		int32 ActionIndex = INDEX_NONE;
+		/** Summary cost of actions on path to this node. */
+		int32 Cost = 0;
+		/** Set if cheaper node of the same regression state was found later - this one isn't expanded anymore. */
+		bool bSuperseded = false;
+		/** Desired facts for this node. */
+		TArray<FDesiredFact> DesiredFacts;
+		/** DesiredFacts index which this node solves. */
+		int32 SolvedDesiredFactIndex = INDEX_NONE;
+
+		/** Return true if this node satisfy goal (all desired facts are satisfied). */
+		bool IsGoalSatisfiedInNode() const
+		{
+			for(const FDesiredFact& DesiredFact : DesiredFacts)
+			{
+				if(DesiredFact.SatisfiedByNodeIndex == INDEX_NONE)
+					return false;
+			}
+			return true;
+		}
+		/** Return regression state of this node. */
+		FRegressionState GetRegressionState() const
+		{
+			FRegressionState State;
+			for(const FDesiredFact& DesiredFact : DesiredFacts)
+			{
+				if(DesiredFact.SatisfiedByNodeIndex == INDEX_NONE)
+				{
+					State.Facts.Add(DesiredFact.Fact);
+				}
+			}
+			State.Finalize();
+			return State;
+		}
+		/** Return size of memory allocated by this node. */
+		SIZE_T GetAllocatedSize() const { return PathToNode.GetAllocatedSize() + DesiredFacts.GetAllocatedSize(); }
+	};
+
+	/** Return memory allocated by given backward search nodes. */
+	int64 GetSearchMemory(const TArray<FBackwardNode>& Nodes, const TArray<int32>& OpenNodes)
+	{
+		int64 SearchMemory = Nodes.GetAllocatedSize() + OpenNodes.GetAllocatedSize();
+		for(const FBackwardNode& Node : Nodes)
+		{
+			SearchMemory += Node.GetAllocatedSize();
+		}
+		return SearchMemory;
+	}
+
+	/**
+	 * Data of single backward search (for single regression target).
+	 */
+	struct FBackwardSearch
+	{
+		FBackwardSearch(const FGOAPPlanningProblem& InProblem, EGOAPSubgoalSelection InSubgoalSelection)
+			: Problem(InProblem), SubgoalSelection(InSubgoalSelection) {}
+
+		const FGOAPPlanningProblem& Problem;
+		EGOAPSubgoalSelection SubgoalSelection;
+
+		TArray<FBackwardNode> Nodes;
+		TArray<int32> OpenNodes;
+		/** Paths of nodes satisfying goal. */
+		TArray<TArray<int32>> Solutions;
+		/** The cheapest node of each reached regression state. */
+		TMap<FRegressionState, int32> BestNodes;
+		/** Number of nodes dropped as transpositions or by partial order pruning. */
+		int32 DeduplicatedNodesNum = 0;
+	};
+
+	/**
+	 * Return true if given action can solve given desired fact of node - node is not valid if some of action's
+	 * preconditions has the same key as some of node's not satisfied desired facts (except the solved one).
+	 */
+	bool CanSolveDesiredFact(const FGOAPPlanningProblem& Problem, const FBackwardNode& Node, int32 DesiredFactIndex,
+		int32 ActionIndex)
+	{
+		for(const FGOAPCoreFact& Precondition : Problem.Actions[ActionIndex].Preconditions)
+		{
+			for(int32 Index = 0; Index < Node.DesiredFacts.Num(); ++Index)
+			{
+				if(Index != DesiredFactIndex && Node.DesiredFacts[Index].SatisfiedByNodeIndex == INDEX_NONE &&
+					Node.DesiredFacts[Index].Fact.Key == Precondition.Key)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Return true if actions solving given desired facts are independent - order in which facts are solved doesn't
+	 * change resulting regression state, so only one order has to be explored.
+	 */
+	bool AreCommutative(const FGOAPPlanningProblem& Problem, int32 ActionOne, const FGOAPCoreFact& FactOne,
+		int32 ActionTwo, const FGOAPCoreFact& FactTwo)
+	{
+		const TArray<FGOAPCoreFact>& PreconditionsOne = Problem.Actions[ActionOne].Preconditions;
+		const TArray<FGOAPCoreFact>& PreconditionsTwo = Problem.Actions[ActionTwo].Preconditions;
+		if(FactOne.Key == FactTwo.Key)
+			return false;
+
+		for(const FGOAPCoreFact& PreconditionOne : PreconditionsOne)
+		{
+			if(PreconditionOne.Key == FactTwo.Key)
+				return false;
+			for(const FGOAPCoreFact& PreconditionTwo : PreconditionsTwo)
+			{
+				if(PreconditionOne.Key == PreconditionTwo.Key)
+					return false;
+			}
+		}
+		for(const FGOAPCoreFact& PreconditionTwo : PreconditionsTwo)
+		{
+			if(PreconditionTwo.Key == FactOne.Key)
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Select the most constrained not satisfied desired fact of node - the one with the fewest actions able to solve
+	 * it. Facts which some actions can't solve now (because of conflicts with other desired facts) aren't selected, as
+	 * solving other facts first could unblock them; if there is no other fact, OutSelectedIndex is INDEX_NONE and all
+	 * facts have to be expanded. Return false if node is dead end.
+	 */
+	bool SelectDesiredFact(const FGOAPPlanningProblem& Problem, const FBackwardNode& Node, int32& OutSelectedIndex)
+	{
+		OutSelectedIndex = INDEX_NONE;
+		int32 MinProducersNum = MAX_int32;
+		for(int32 DesiredFactIndex = 0; DesiredFactIndex < Node.DesiredFacts.Num(); ++DesiredFactIndex)
+		{
+			if(Node.DesiredFacts[DesiredFactIndex].SatisfiedByNodeIndex != INDEX_NONE)
+				continue;
+
+			// fact which no action achieves can't be ever satisfied
+			const TArray<int32>* Producers = Problem.Producers.Find(Node.DesiredFacts[DesiredFactIndex].Fact);
+			if(!Producers)
+				return false;
+
+			const bool bAllProducersUsable = !Producers->ContainsByPredicate([&](int32 ActionIndex)
+			{
+				return !CanSolveDesiredFact(Problem, Node, DesiredFactIndex, ActionIndex);
+			});
+			if(bAllProducersUsable && Producers->Num() < MinProducersNum)
+			{
+				OutSelectedIndex = DesiredFactIndex;
+				MinProducersNum = Producers->Num();
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Create nodes for actions satisfying node's desired facts (all of them or one selected, see
+	 * EGOAPSubgoalSelection); node satisfying goal is added to Solutions. New node which regression state was already
+	 * reached with lower or equal cost is dropped (BestNodes keeps the cheapest node of each regression state).
+	 */
+	void ExpandBackwardNode(FBackwardSearch& Search, int32 NodeIndex)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_ExpandNode);
+
+		const FGOAPPlanningProblem& Problem = Search.Problem;
+		TArray<FBackwardNode>& Nodes = Search.Nodes;
+
+		// transposition of cheaper node found after this one was added
+		if(Nodes[NodeIndex].bSuperseded)
+			return;
+
+		// check if node is solution - simply add to known solutions and not expand this node
+		if(Nodes[NodeIndex].IsGoalSatisfiedInNode())
+		{
+			Search.Solutions.Add(Nodes[NodeIndex].PathToNode);
+			return;
+		}
+
+		// Nodes can be reallocated by adding new node, so expanded node is copied
+		const FBackwardNode Node = Nodes[NodeIndex];
+		int32 SelectedDesiredFactIndex = INDEX_NONE;
+		if(Search.SubgoalSelection == EGOAPSubgoalSelection::MostConstrained &&
+			!SelectDesiredFact(Problem, Node, SelectedDesiredFactIndex))
+		{
+			return;
+		}
+
+		for(int32 DesiredFactIndex = 0; DesiredFactIndex < Node.DesiredFacts.Num(); ++DesiredFactIndex)
+		{
+			// this desired fact is already satisfied or other one is selected
+			if(Node.DesiredFacts[DesiredFactIndex].SatisfiedByNodeIndex != INDEX_NONE ||
+				(SelectedDesiredFactIndex != INDEX_NONE && DesiredFactIndex != SelectedDesiredFactIndex))
+			{
+				continue;
+			}
+
+			const TArray<int32>* Producers = Problem.Producers.Find(Node.DesiredFacts[DesiredFactIndex].Fact);
+			if(!Producers)
+				continue;
+
+			for(const int32 ActionIndex : *Producers)
+			{
+				if(!CanSolveDesiredFact(Problem, Node, DesiredFactIndex, ActionIndex))
+					continue;
+
+				// partial order pruning - independent facts are solved only in order of their indexes (the other
+				// order gives the same regression state)
+				if(SelectedDesiredFactIndex == INDEX_NONE && Node.ActionIndex != INDEX_NONE &&
+					DesiredFactIndex < Node.SolvedDesiredFactIndex &&
+					AreCommutative(Problem, ActionIndex, Node.DesiredFacts[DesiredFactIndex].Fact, Node.ActionIndex,
+						Node.DesiredFacts[Node.SolvedDesiredFactIndex].Fact))
+				{
+					++Search.DeduplicatedNodesNum;
+					continue;
+				}
+
+				const int32 NewNodeIndex = Nodes.Add(Node);
+				FBackwardNode& NewNode = Nodes[NewNodeIndex];
+				NewNode.ActionIndex = ActionIndex;
+				NewNode.Cost = Node.Cost + Problem.Actions[ActionIndex].Cost;
+				NewNode.SolvedDesiredFactIndex = DesiredFactIndex;
+				NewNode.DesiredFacts[DesiredFactIndex].SatisfiedByNodeIndex = NewNodeIndex;
+				for(const FGOAPCoreFact& Precondition : Problem.Actions[ActionIndex].Preconditions)
+				{
+					NewNode.DesiredFacts.Add(FDesiredFact(Precondition, NewNodeIndex));
+				}
+				NewNode.PathToNode.Add(NewNodeIndex);
+
+				// merge transpositions - keep only the cheapest path to each regression state
+				int32& BestNodeIndex = Search.BestNodes.FindOrAdd(NewNode.GetRegressionState(), INDEX_NONE);
+				if(BestNodeIndex != INDEX_NONE)
+				{
+					++Search.DeduplicatedNodesNum;
+					if(Nodes[BestNodeIndex].Cost <= NewNode.Cost)
+					{
+						Nodes.Pop();
+						continue;
+					}
+					Nodes[BestNodeIndex].bSuperseded = true;
+				}
+				BestNodeIndex = NewNodeIndex;
+				Search.OpenNodes.Add(NewNodeIndex);
+			}
+		}
+	}
+
+	/**
+	 * Signature of prepared solution - its actions with their targets (actors of effects' keys), so solutions of equal
+	 * signatures are identical plans.
+	 */
+	struct FSolutionSignature
+	{
+		/** Action index and target of each step. */
+		TArray<int32> Steps;
+		uint32 Hash = 0;
+
+		FSolutionSignature(const FGOAPPlanningProblem& Problem, const TArray<FBackwardNode>& Nodes,
+			const TArray<int32>& Solution)
+		{
+			Steps.Reserve(Solution.Num() * 2);
+			for(const int32 NodeIndex : Solution)
+			{
+				const FGOAPCoreAction& Action = Problem.Actions[Nodes[NodeIndex].ActionIndex];
+				Steps.Add(Action.ActionIndex);
+				Steps.Add(Problem.KeysActors[Action.Effect.Key]);
+			}
+			for(const int32 Step : Steps)
+			{
+				Hash = HashCombine(Hash, ::GetTypeHash(Step));
+			}
+		}
+
+		FORCEINLINE bool operator==(const FSolutionSignature& Other) const
+		{
+			return Hash == Other.Hash && Steps == Other.Steps;
+		}
+		friend FORCEINLINE uint32 GetTypeHash(const FSolutionSignature& Signature) { return Signature.Hash; }
+	};
+
+	/**
+	 * Build map of solution's dependencies - for each node, nodes solving its action's preconditions. Solution's last
+	 * node has all desired facts of the path (with their instigators and solvers), so the map is built in one pass.
+	 */
+	void BuildSolutionDependencies(const TArray<FBackwardNode>& Nodes, const TArray<int32>& Solution,
+		TMap<int32, TArray<int32>>& OutDependencies)
+	{
+		OutDependencies.Reset();
+		for(const FDesiredFact& DesiredFact : Nodes[Solution.Last()].DesiredFacts)
+		{
+			if(DesiredFact.SatisfiedByNodeIndex != INDEX_NONE)
+			{
+				OutDependencies.FindOrAdd(DesiredFact.InstigatorNodeIndex).Add(DesiredFact.SatisfiedByNodeIndex);
+			}
+		}
+	}
+
+	/** Add given node and all nodes used (directly or not) to satisfy its preconditions to OutNodes. */
+	void CollectUsedNodes(const TMap<int32, TArray<int32>>& Dependencies, int32 NodeIndex, TSet<int32>& OutNodes)
+	{
+		TArray<int32> NodesToVisit;
+		NodesToVisit.Add(NodeIndex);
+		while(NodesToVisit.Num() > 0)
+		{
+			const int32 VisitedNodeIndex = NodesToVisit.Pop();
+			bool bAlreadyCollected;
+			OutNodes.Add(VisitedNodeIndex, &bAlreadyCollected);
+			if(bAlreadyCollected)
+				continue;
+
+			if(const TArray<int32>* Producers = Dependencies.Find(VisitedNodeIndex))
+			{
+				NodesToVisit.Append(*Producers);
+			}
+		}
+	}
+
+	/**
+	 * Return number of preconditions (and desired facts of initial node) which aren't met when plan's actions (except
+	 * removed ones) are executed from initial state.
+	 */
+	int32 GetUnmetFactsNum(const FGOAPPlanningProblem& Problem, const TArray<FBackwardNode>& Nodes,
+		const TArray<int32>& Plan, const TSet<int32>& RemovedNodes)
+	{
+		int32 UnmetFactsNum = 0;
+		FGOAPCoreState CurrentState = Problem.InitialState;
+		for(const int32 NodeIndex : Plan)
+		{
+			if(RemovedNodes.Contains(NodeIndex))
+				continue;
+
+			const FGOAPCoreAction& Action = Problem.Actions[Nodes[NodeIndex].ActionIndex];
+			for(const FGOAPCoreFact& Precondition : Action.Preconditions)
+			{
+				UnmetFactsNum += Problem.IsFactMet(CurrentState, Precondition) ? 0 : 1;
+			}
+			CurrentState[Action.Effect.Key] = Action.Effect.Value;
+		}
+		for(const FDesiredFact& DesiredFact : Nodes[0].DesiredFacts)
+		{
+			UnmetFactsNum += Problem.IsFactMet(CurrentState, DesiredFact.Fact) ? 0 : 1;
+		}
+		return UnmetFactsNum;
+	}
+
+	/**
+	 * Reverse solution's actions (backward planning) and remove each action which effect is already met by previous
+	 * actions or initial state, together with actions used to satisfy its preconditions (unless some other action
+	 * needs their effects - then only the action itself is removed).
+	 */
+	TArray<int32> PrepareSolution(const FGOAPPlanningProblem& Problem, const TArray<FBackwardNode>& Nodes,
+		const TArray<int32>& Solution, TMap<int32, TArray<int32>>& Dependencies)
+	{
+		// actions in execution order, without initial node
+		TArray<int32> Plan;
+		Plan.Reserve(Solution.Num() - 1);
+		for(int32 PathIndex = Solution.Num() - 1; PathIndex > 0; --PathIndex)
+		{
+			Plan.Add(Solution[PathIndex]);
+		}
+		BuildSolutionDependencies(Nodes, Solution, Dependencies);
+
+		TSet<int32> RemovedNodes;
+		TSet<int32> NodesToRemove;
+		const int32 UnmetFactsNum = GetUnmetFactsNum(Problem, Nodes, Plan, RemovedNodes);
+		bool bContinue;
+		do
+		{
+			bContinue = false;
+			// build state to time when some action is not needed - remove this action and all associated actions and
+			// start building state from scratch
+			FGOAPCoreState CurrentState = Problem.InitialState;
+			for(const int32 NodeIndex : Plan)
+			{
+				if(RemovedNodes.Contains(NodeIndex))
+					continue;
+
+				const FGOAPCoreFact& Effect = Problem.Actions[Nodes[NodeIndex].ActionIndex].Effect;
+				if(Problem.IsFactMet(CurrentState, Effect))
+				{
+					NodesToRemove = RemovedNodes;
+					CollectUsedNodes(Dependencies, NodeIndex, NodesToRemove);
+					if(GetUnmetFactsNum(Problem, Nodes, Plan, NodesToRemove) <= UnmetFactsNum)
+					{
+						RemovedNodes = MoveTemp(NodesToRemove);
+					}
+					else
+					{
+						// associated actions achieve facts used by other actions - removing only this one doesn't
+						// change any state, as its effect is already met
+						RemovedNodes.Add(NodeIndex);
+					}
+					bContinue = true;
+					break;
+				}
+				CurrentState[Effect.Key] = Effect.Value;
+			}
+		} while(bContinue);
+
+		Plan.RemoveAll([&RemovedNodes](int32 NodeIndex) { return RemovedNodes.Contains(NodeIndex); });
+		return Plan;
+	}
+
+	/** Return summary cost of solution's actions. */
+	int32 GetSolutionCost(const FGOAPPlanningProblem& Problem, const TArray<FBackwardNode>& Nodes,
+		const TArray<int32>& Solution)
+	{
+		int32 Cost = 0;
+		for(const int32 NodeIndex : Solution)
+		{
+			Cost += Problem.Actions[Nodes[NodeIndex].ActionIndex].Cost;
+		}
+		return Cost;
+	}
+
+	/**
+	 * Find the cheapest plan satisfying all given desired facts; return false if there is no such plan (or search was
+	 * canceled by given Cancellation).
+	 */
+	bool SearchBackwardForFacts(const FGOAPPlanningProblem& Problem, EGOAPSubgoalSelection SubgoalSelection,
+		const TArray<FGOAPCoreFact>& DesiredFacts, const FGOAPSearchCancellation* Cancellation,
+		TArray<int32>& OutPlan, int32& OutPlanCost, FGOAPCoreSearchResult& InOutStats)
+	{
+		FBackwardSearch Search(Problem, SubgoalSelection);
+		TArray<FBackwardNode>& Nodes = Search.Nodes;
+		const TArray<TArray<int32>>& Solutions = Search.Solutions;
+
+		FBackwardNode& InitNode = Nodes.AddDefaulted_GetRef();
+		for(const FGOAPCoreFact& DesiredFact : DesiredFacts)
+		{
+			InitNode.DesiredFacts.Add(FDesiredFact(DesiredFact, 0));
+		}
+		if(InitNode.IsGoalSatisfiedInNode())
+			return false;
+		InitNode.PathToNode.Add(0);
+		Search.BestNodes.Add(InitNode.GetRegressionState(), 0);
+
+		// find all solutions
+		ExpandBackwardNode(Search, 0);
+		int32 VisitedNodesNum = 1;
+		while(Search.OpenNodes.Num() > 0)
+		{
+			if(Cancellation && Cancellation->IsCanceled())
+				return false;
+			ExpandBackwardNode(Search, Search.OpenNodes.Pop());
+			++VisitedNodesNum;
+		}
+		UE_LOG(LogGOAP, Verbose, TEXT("Summary visited nodes number: %d"), VisitedNodesNum);
+		InOutStats.NodesExpanded += VisitedNodesNum;
+		InOutStats.NodesGenerated += Nodes.Num();
+		InOutStats.NodesDeduplicated += Search.DeduplicatedNodesNum;
+		InOutStats.SearchMemory = FMath::Max(InOutStats.SearchMemory, GetSearchMemory(Nodes, Search.OpenNodes) +
+			static_cast<int64>(Search.BestNodes.GetAllocatedSize()));
+
+		// prepare plans and remove duplicates (after preparation some plans can be the same)
+		TArray<TArray<int32>> PreparedSolutions;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GOAP_PrepareSolutions);
+
+			TSet<FSolutionSignature> Signatures;
+			TMap<int32, TArray<int32>> Dependencies;
+			for(const TArray<int32>& Solution : Solutions)
+			{
+				TArray<int32> PreparedSolution = PrepareSolution(Problem, Nodes, Solution, Dependencies);
+				bool bAlreadyPrepared;
+				Signatures.Add(FSolutionSignature(Problem, Nodes, PreparedSolution), &bAlreadyPrepared);
+				if(!bAlreadyPrepared)
+				{
+					PreparedSolutions.Add(MoveTemp(PreparedSolution));
+				}
+			}
+			InOutStats.NodesDeduplicated += Solutions.Num() - PreparedSolutions.Num();
+		}
+
+		// find best plan (min cost)
+		int32 BestSolutionIndex = INDEX_NONE;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GOAP_PickBestSolution);
+
+			OutPlanCost = MAX_int32;
+			for(int32 SolutionIndex = 0; SolutionIndex < PreparedSolutions.Num(); ++SolutionIndex)
+			{
+				const int32 SolutionCost = GetSolutionCost(Problem, Nodes, PreparedSolutions[SolutionIndex]);
+				UE_LOG(LogGOAP, Verbose, TEXT("Plan %d: %d actions, cost %d"), SolutionIndex + 1,
+					PreparedSolutions[SolutionIndex].Num(), SolutionCost);
+				if(SolutionCost < OutPlanCost)
+				{
+					OutPlanCost = SolutionCost;
+					BestSolutionIndex = SolutionIndex;
+				}
+			}
+		}
+		UE_LOG(LogGOAP, Verbose, TEXT("Best plan index: %d"), BestSolutionIndex + 1);
+		if(BestSolutionIndex == INDEX_NONE)
+			return false;
+
+		OutPlan.Reset();
+		for(const int32 NodeIndex : PreparedSolutions[BestSolutionIndex])
+		{
+			OutPlan.Add(Nodes[NodeIndex].ActionIndex);
+		}
+		return OutPlan.Num() > 0;
+	}
+
+	/**
+	 * Node of forward frontier of bidirectional search.
+	 */
+	struct FBidirectionalForwardNode
+	{
+		/** World state in this node. */
+		FGOAPCoreState State;
+		uint32 Hash = 0;
+		/** Index of parent node (INDEX_NONE for initial node). */
+		int32 ParentIndex = INDEX_NONE;
+		/** Problem's action performed to get to this node from the parent. */
+		int32 ActionIndex = INDEX_NONE;
+		/** Summary cost of actions from initial state. */
+		int32 Cost = 0;
+		/** Number of not met goal's conditions. */
+		int32 Heuristic = 0;
+		/** Set if cheaper node of the same state was found later - this one isn't expanded anymore. */
+		bool bSuperseded = false;
+
+		int32 GetNodeFx() const { return Cost + Heuristic; }
+	};
+
+	/**
+	 * Node of backward frontier of bidirectional search - regression state from which actions of following nodes
+	 * (child, its child etc.) lead to regression target.
+	 */
+	struct FBidirectionalBackwardNode
+	{
+		FRegressionState State;
+		/** Index of node closer to regression target (INDEX_NONE for regression target). */
+		int32 ChildIndex = INDEX_NONE;
+		/** Problem's action leading from this node's state to child's one. */
+		int32 ActionIndex = INDEX_NONE;
+		/** Summary cost of actions to regression target. */
+		int32 Cost = 0;
+		/** Number of facts not met in initial state. */
+		int32 Heuristic = 0;
+		/** Set if cheaper node of the same regression state was found later - this one isn't expanded anymore. */
+		bool bSuperseded = false;
+
+		int32 GetNodeFx() const { return Cost + Heuristic; }
+	};
+
+	/**
+	 * Data of bidirectional search. Both frontiers are indexed by facts, so joins of new node are tested only against
+	 * nodes which can meet it: forward nodes by each fact of their states, backward nodes by the first fact of their
+	 * regression states (regression target without facts is indexed by default fact).
+	 */
+	struct FBidirectionalSearch
+	{
+		explicit FBidirectionalSearch(const FGOAPPlanningProblem& InProblem) : Problem(InProblem) {}
+
+		const FGOAPPlanningProblem& Problem;
+
+		TArray<FBidirectionalForwardNode> ForwardNodes;
+		TArray<int32> ForwardOpenNodes;
+		/** Forward nodes by hashes of their states. */
+		TMultiMap<uint32, int32> ForwardNodesByHash;
+		TMap<FGOAPCoreFact, TArray<int32>> ForwardNodesByFact;
+
+		TArray<FBidirectionalBackwardNode> BackwardNodes;
+		TArray<int32> BackwardOpenNodes;
+		/** The cheapest node of each reached regression state. */
+		TMap<FRegressionState, int32> BestBackwardNodes;
+		TMap<FGOAPCoreFact, TArray<int32>> BackwardNodesByFirstFact;
+
+		/** The cheapest join found so far (BestBackwardNode is INDEX_NONE if forward node satisfies goal itself). */
+		int32 BestForwardNode = INDEX_NONE;
+		int32 BestBackwardNode = INDEX_NONE;
+		int32 BestCost = MAX_int32;
+
+		/** Number of nodes dropped as duplicates of cheaper nodes. */
+		int32 DeduplicatedNodesNum = 0;
+	};
+
+	/**
+	 * Test join of given forward node with given backward node (or with goal if BackwardNodeIndex is INDEX_NONE) and
+	 * keep it if it's the cheapest plan so far. Plan is simulated, as regression target can skip goal's conditions
+	 * which were met in initial state.
+	 */
+	void TryJoin(FBidirectionalSearch& Search, int32 ForwardNodeIndex, int32 BackwardNodeIndex)
+	{
+		const FGOAPPlanningProblem& Problem = Search.Problem;
+		const FBidirectionalForwardNode& ForwardNode = Search.ForwardNodes[ForwardNodeIndex];
+		if(BackwardNodeIndex == INDEX_NONE)
+		{
+			if(ForwardNode.Heuristic == 0 && ForwardNode.Cost < Search.BestCost)
+			{
+				Search.BestForwardNode = ForwardNodeIndex;
+				Search.BestBackwardNode = INDEX_NONE;
+				Search.BestCost = ForwardNode.Cost;
+			}
+			return;
+		}
+
+		const FBidirectionalBackwardNode& BackwardNode = Search.BackwardNodes[BackwardNodeIndex];
+		if(ForwardNode.Cost + BackwardNode.Cost >= Search.BestCost)
+			return;
+		for(const FGOAPCoreFact& Fact : BackwardNode.State.Facts)
+		{
+			if(!Problem.IsFactMet(ForwardNode.State, Fact))
+				return;
+		}
+
+		FGOAPCoreState State = ForwardNode.State;
+		for(int32 NodeIndex = BackwardNodeIndex; Search.BackwardNodes[NodeIndex].ChildIndex != INDEX_NONE;
+			NodeIndex = Search.BackwardNodes[NodeIndex].ChildIndex)
+		{
+			if(!Problem.IsActionApplicable(State, Search.BackwardNodes[NodeIndex].ActionIndex))
+				return;
+			Problem.ApplyAction(State, Search.BackwardNodes[NodeIndex].ActionIndex);
+		}
+		if(Problem.GetUnsatisfiedConditionsNum(State) > 0)
+			return;
+
+		Search.BestForwardNode = ForwardNodeIndex;
+		Search.BestBackwardNode = BackwardNodeIndex;
+		Search.BestCost = ForwardNode.Cost + BackwardNode.Cost;
+	}
+
+	/** Return hash of given complete state. */
+	uint32 GetStateHash(const FGOAPCoreState& State)
+	{
+		uint32 Hash = 0;
+		for(const int32 Value : State)
+		{
+			Hash = HashCombine(Hash, ::GetTypeHash(Value));
+		}
+		return Hash;
+	}
+
+	/** Add new forward node (unless its state was already reached with lower or equal cost) and test its joins. */
+	void AddForwardNode(FBidirectionalSearch& Search, FBidirectionalForwardNode&& NewNode)
+	{
+		TArray<FBidirectionalForwardNode>& Nodes = Search.ForwardNodes;
+		for(auto It = Search.ForwardNodesByHash.CreateKeyIterator(NewNode.Hash); It; ++It)
+		{
+			FBidirectionalForwardNode& Node = Nodes[It.Value()];
+			if(Node.bSuperseded || Node.State != NewNode.State)
+				continue;
+
+			++Search.DeduplicatedNodesNum;
+			if(Node.Cost <= NewNode.Cost)
+				return;
+			Node.bSuperseded = true;
+		}
+
+		const int32 NodeIndex = Nodes.Add(MoveTemp(NewNode));
+		const FBidirectionalForwardNode& Node = Nodes[NodeIndex];
+		Search.ForwardOpenNodes.Add(NodeIndex);
+		Search.ForwardNodesByHash.Add(Node.Hash, NodeIndex);
+
+		TryJoin(Search, NodeIndex, INDEX_NONE);
+		if(const TArray<int32>* BackwardNodes = Search.BackwardNodesByFirstFact.Find(FGOAPCoreFact()))
+		{
+			for(const int32 BackwardNodeIndex : *BackwardNodes)
+			{
+				TryJoin(Search, NodeIndex, BackwardNodeIndex);
+			}
+		}
+		for(int32 Key = 0; Key < Node.State.Num(); ++Key)
+		{
+			const FGOAPCoreFact Fact(Key, Node.State[Key]);
+			Search.ForwardNodesByFact.FindOrAdd(Fact).Add(NodeIndex);
+			if(const TArray<int32>* BackwardNodes = Search.BackwardNodesByFirstFact.Find(Fact))
+			{
+				for(const int32 BackwardNodeIndex : *BackwardNodes)
+				{
+					if(!Search.BackwardNodes[BackwardNodeIndex].bSuperseded)
+					{
+						TryJoin(Search, NodeIndex, BackwardNodeIndex);
+					}
+				}
+			}
+		}
+	}
+
+	/** Add new backward node (unless its state was already reached with lower or equal cost) and test its joins. */
+	void AddBackwardNode(FBidirectionalSearch& Search, FBidirectionalBackwardNode&& NewNode)
+	{
+		TArray<FBidirectionalBackwardNode>& Nodes = Search.BackwardNodes;
+		int32& BestNodeIndex = Search.BestBackwardNodes.FindOrAdd(NewNode.State, INDEX_NONE);
+		if(BestNodeIndex != INDEX_NONE)
+		{
+			++Search.DeduplicatedNodesNum;
+			if(Nodes[BestNodeIndex].Cost <= NewNode.Cost)
+				return;
+			Nodes[BestNodeIndex].bSuperseded = true;
+		}
+
+		const int32 NodeIndex = Nodes.Add(MoveTemp(NewNode));
+		BestNodeIndex = NodeIndex;
+		const FBidirectionalBackwardNode& Node = Nodes[NodeIndex];
+		Search.BackwardOpenNodes.Add(NodeIndex);
+
+		// only forward nodes containing the rarest fact of regression state can meet it
+		const TArray<int32>* ForwardNodes = nullptr;
+		for(const FGOAPCoreFact& Fact : Node.State.Facts)
+		{
+			const TArray<int32>* FactForwardNodes = Search.ForwardNodesByFact.Find(Fact);
+			if(!FactForwardNodes)
+			{
+				ForwardNodes = nullptr;
+				break;
+			}
+			if(!ForwardNodes || FactForwardNodes->Num() < ForwardNodes->Num())
+			{
+				ForwardNodes = FactForwardNodes;
+			}
+		}
+		Search.BackwardNodesByFirstFact.FindOrAdd(Node.State.Facts.Num() > 0 ? Node.State.Facts[0] : FGOAPCoreFact())
+			.Add(NodeIndex);
+
+		if(Node.State.Facts.Num() == 0)
+		{
+			// every state meets empty regression state, the initial one the cheapest
+			TryJoin(Search, 0, NodeIndex);
+		}
+		else if(ForwardNodes)
+		{
+			for(const int32 ForwardNodeIndex : *ForwardNodes)
+			{
+				if(!Search.ForwardNodes[ForwardNodeIndex].bSuperseded)
+				{
+					TryJoin(Search, ForwardNodeIndex, NodeIndex);
+				}
+			}
+		}
+	}
+
+	/** Create forward nodes for all actions applicable in given node. */
+	void ExpandBidirectionalForwardNode(FBidirectionalSearch& Search, int32 NodeIndex)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_ExpandNode);
+
+		const FGOAPPlanningProblem& Problem = Search.Problem;
+		for(int32 ActionIndex = 0; ActionIndex < Problem.GetActionsNum(); ++ActionIndex)
+		{
+			if(!Problem.IsActionApplicable(Search.ForwardNodes[NodeIndex].State, ActionIndex))
+				continue;
+
+			// Nodes can be reallocated by adding new node, so parent's data is copied first
+			FBidirectionalForwardNode NewNode;
+			NewNode.State = Search.ForwardNodes[NodeIndex].State;
+			Problem.ApplyAction(NewNode.State, ActionIndex);
+			NewNode.Hash = GetStateHash(NewNode.State);
+			NewNode.ParentIndex = NodeIndex;
+			NewNode.ActionIndex = ActionIndex;
+			NewNode.Cost = Search.ForwardNodes[NodeIndex].Cost + Problem.GetActionCost(ActionIndex);
+			{
+				SCOPE_CYCLE_COUNTER(STAT_GOAP_Heuristic);
+				NewNode.Heuristic = Problem.GetUnsatisfiedConditionsNum(NewNode.State);
+			}
+			AddForwardNode(Search, MoveTemp(NewNode));
+		}
+	}
+
+	/** Return number of given regression state's facts not met in initial state. */
+	int32 GetRegressionHeuristic(const FGOAPPlanningProblem& Problem, const FRegressionState& State)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_Heuristic);
+
+		int32 UnmetFactsNum = 0;
+		for(const FGOAPCoreFact& Fact : State.Facts)
+		{
+			UnmetFactsNum += Problem.IsFactMet(Problem.InitialState, Fact) ? 0 : 1;
+		}
+		return UnmetFactsNum;
+	}
+
+	/**
+	 * Create backward nodes for all actions achieving some fact of given node's regression state - new state is the
+	 * old one without achieved fact and with action's preconditions. Actions which preconditions conflict with other
+	 * facts of state (the same key, other value) are skipped.
+	 */
+	void ExpandBidirectionalBackwardNode(FBidirectionalSearch& Search, int32 NodeIndex)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_ExpandNode);
+
+		const FGOAPPlanningProblem& Problem = Search.Problem;
+		// Nodes can be reallocated by adding new node, so expanded node is copied
+		const FBidirectionalBackwardNode Node = Search.BackwardNodes[NodeIndex];
+		for(int32 FactIndex = 0; FactIndex < Node.State.Facts.Num(); ++FactIndex)
+		{
+			const TArray<int32>* Producers = Problem.Producers.Find(Node.State.Facts[FactIndex]);
+			if(!Producers)
+				continue;
+
+			for(const int32 ActionIndex : *Producers)
+			{
+				FBidirectionalBackwardNode NewNode;
+				NewNode.State.Facts = Node.State.Facts;
+				NewNode.State.Facts.RemoveAt(FactIndex);
+				NewNode.State.Facts.Append(Problem.Actions[ActionIndex].Preconditions);
+				NewNode.State.Finalize();
+
+				// facts are sorted, so duplicates and conflicts are neighbours
+				bool bConflict = false;
+				for(int32 Index = NewNode.State.Facts.Num() - 1; Index > 0 && !bConflict; --Index)
+				{
+					const FGOAPCoreFact& Fact = NewNode.State.Facts[Index];
+					const FGOAPCoreFact& PreviousFact = NewNode.State.Facts[Index - 1];
+					if(Fact == PreviousFact)
+					{
+						NewNode.State.Facts.RemoveAt(Index);
+					}
+					else
+					{
+						bConflict = Fact.Key == PreviousFact.Key;
+					}
+				}
+				if(bConflict)
+					continue;
+
+				NewNode.State.Finalize();
+				NewNode.ChildIndex = NodeIndex;
+				NewNode.ActionIndex = ActionIndex;
+				NewNode.Cost = Node.Cost + Problem.GetActionCost(ActionIndex);
+				NewNode.Heuristic = GetRegressionHeuristic(Problem, NewNode.State);
+				AddBackwardNode(Search, MoveTemp(NewNode));
+			}
+		}
+	}
+
+	/** Remove superseded nodes from open nodes and return index of open node of min f(x) (INDEX_NONE if none). */
+	template<typename NodeType>
+	int32 FindBestOpenNode(const TArray<NodeType>& Nodes, TArray<int32>& OpenNodes)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_SelectNode);
+
+		OpenNodes.RemoveAllSwap([&Nodes](int32 NodeIndex) { return Nodes[NodeIndex].bSuperseded; });
+		int32 BestIndex = INDEX_NONE;
+		int32 MinFx = MAX_int32;
+		for(const int32 NodeIndex : OpenNodes)
+		{
+			const int32 NodeFx = Nodes[NodeIndex].GetNodeFx();
+			if(NodeFx < MinFx)
+			{
+				BestIndex = NodeIndex;
+				MinFx = NodeFx;
+			}
+		}
+		return BestIndex;
+	}
+
+	/** Keep only BeamWidth open nodes of min f(x) (the rest is dropped, but stays available for joins). */
+	template<typename NodeType>
+	void LimitOpenNodes(const TArray<NodeType>& Nodes, TArray<int32>& OpenNodes, int32 BeamWidth)
+	{
+		if(OpenNodes.Num() <= BeamWidth)
+			return;
+
+		OpenNodes.StableSort([&Nodes](int32 NodeOne, int32 NodeTwo)
+		{
+			return Nodes[NodeOne].GetNodeFx() < Nodes[NodeTwo].GetNodeFx();
+		});
+		OpenNodes.SetNum(BeamWidth);
+	}
+}
+
+void FGOAPPlanningProblem::Reset()
+{
+	InitialState.Reset();
+	KeysActors.Reset();
+	Actions.Reset();
+	Conditions.Reset();
+	Junction = EGOAPConditionJunction::All;
+	RegressionTargets.Reset();
+	Producers.Reset();
+	Goals.Reset();
+}
+
+int32 FGOAPPlanningProblem::GetUnsatisfiedConditionsNum(const TArray<FGOAPCoreCondition>& Conditions,
+	EGOAPConditionJunction Junction, const FGOAPCoreState& State)
+{
+	int32 UnsatisfiedNum = 0;
+	for(const FGOAPCoreCondition& Condition : Conditions)
+	{
+		const bool bSatisfied = Condition.IsSatisfied(State[Condition.Key]);
+		if(Junction == EGOAPConditionJunction::Any && bSatisfied)
+			return 0;
+		if(!bSatisfied)
+		{
+			++UnsatisfiedNum;
+		}
+	}
+
+	if(Junction == EGOAPConditionJunction::Any)
+		return Conditions.Num() > 0 ? 1 : 0;
+	return UnsatisfiedNum;
+}
+
+SIZE_T FGOAPPlanningProblem::GetAllocatedSize() const
+{
+	SIZE_T Size = InitialState.GetAllocatedSize() + KeysActors.GetAllocatedSize() + Actions.GetAllocatedSize() +
+		Conditions.GetAllocatedSize() + RegressionTargets.GetAllocatedSize() + Producers.GetAllocatedSize();
+	for(const FGOAPCoreAction& Action : Actions)
+	{
+		Size += Action.Preconditions.GetAllocatedSize();
+	}
+	for(const FGOAPCoreCondition& Condition : Conditions)
+	{
+		Size += Condition.SatisfyingValues.GetAllocatedSize();
+	}
+	for(const TArray<FGOAPCoreFact>& RegressionTarget : RegressionTargets)
+	{
+		Size += RegressionTarget.GetAllocatedSize();
+	}
+	for(const TPair<FGOAPCoreFact, TArray<int32>>& Producer : Producers)
+	{
+		Size += Producer.Value.GetAllocatedSize();
+	}
+	Size += Goals.GetAllocatedSize();
+	for(const FGOAPCoreGoal& Goal : Goals)
+	{
+		Size += Goal.Conditions.GetAllocatedSize();
+		for(const FGOAPCoreCondition& Condition : Goal.Conditions)
+		{
+			Size += Condition.SatisfyingValues.GetAllocatedSize();
+		}
+	}
+	return Size;
+}
+
+void FGOAPPlanningCore::SearchBackward(const FGOAPPlanningProblem& Problem, FGOAPCoreSearchResult& OutResult) const
+{
+	OutResult = FGOAPCoreSearchResult();
+
+	// plan is searched for each regression target and the cheapest one is used
+	int32 BestPlanCost = MAX_int32;
+	TArray<int32> Plan;
+	for(const TArray<FGOAPCoreFact>& DesiredFacts : Problem.RegressionTargets)
+	{
+		int32 PlanCost;
+		if(GOAPPlanningCore::SearchBackwardForFacts(Problem, SubgoalSelection, DesiredFacts, Cancellation, Plan,
+			PlanCost, OutResult) &&
+			PlanCost < BestPlanCost)
+		{
+			OutResult.Plan = Plan;
+			BestPlanCost = PlanCost;
+		}
+	}
+	if(IsSearchCanceled())
+	{
+		// plans of not searched targets could be cheaper
+		OutResult.Plan.Reset();
+	}
+	OutResult.PlanCost = OutResult.Plan.Num() > 0 ? BestPlanCost : 0;
+}
+
+void FGOAPPlanningCore::SearchBidirectional(const FGOAPPlanningProblem& Problem,
+	FGOAPCoreSearchResult& OutResult) const
+{
+	using namespace GOAPPlanningCore;
+
+	OutResult = FGOAPCoreSearchResult();
+	if(Problem.GetUnsatisfiedConditionsNum(Problem.InitialState) == 0)
+	{
+		// goal is satisfied without any actions
+		return;
+	}
+
+	FBidirectionalSearch Search(Problem);
+	FBidirectionalForwardNode InitNode;
+	InitNode.State = Problem.InitialState;
+	InitNode.Hash = GetStateHash(InitNode.State);
+	InitNode.Heuristic = Problem.GetUnsatisfiedConditionsNum(InitNode.State);
+	AddForwardNode(Search, MoveTemp(InitNode));
+	for(const TArray<FGOAPCoreFact>& RegressionTarget : Problem.RegressionTargets)
+	{
+		FBidirectionalBackwardNode TargetNode;
+		TargetNode.State.Facts = RegressionTarget;
+		TargetNode.State.Finalize();
+		TargetNode.Heuristic = GetRegressionHeuristic(Problem, TargetNode.State);
+		AddBackwardNode(Search, MoveTemp(TargetNode));
+	}
+
+	// backward frontier bounds plan cost only if each state satisfying goal meets some regression target (targets of
+	// FGOAPGoalPredicate::GetRegressionTargets: not met equality conditions of conjunction, or each condition of
+	// disjunction if all of them are equalities)
+	const bool bBackwardBoundsCost = Problem.Junction == EGOAPConditionJunction::All ?
+		Problem.RegressionTargets.Num() > 0 : Problem.RegressionTargets.Num() == Problem.Conditions.Num();
+
+	// beam search drops nodes, so exhausted backward frontier doesn't mean all joins were found
+	const bool bBeam = SearchSettings.Quality == EGOAPSearchQuality::Beam;
+	const float CostBoundWeight = SearchSettings.Quality == EGOAPSearchQuality::Weighted ?
+		FMath::Max(SearchSettings.Weight, 1.0f) : 1.0f;
+	const double Deadline = SearchSettings.Quality == EGOAPSearchQuality::Anytime ?
+		FPlatformTime::Seconds() + SearchSettings.AnytimeTimeBudget : 0.0;
+
+	// smaller frontier is expanded (cardinality criterion), until no plan through any of them can be cheaper than
+	// the best join
+	int32 VisitedNodesNum = 0;
+	bool bCanceled = false;
+	while(true)
+	{
+		const int32 ForwardNodeIndex = FindBestOpenNode(Search.ForwardNodes, Search.ForwardOpenNodes);
+		const int32 BackwardNodeIndex = FindBestOpenNode(Search.BackwardNodes, Search.BackwardOpenNodes);
+		if(ForwardNodeIndex == INDEX_NONE || (BackwardNodeIndex == INDEX_NONE && bBackwardBoundsCost && !bBeam))
+			break;
+
+		int32 MinPlanCost = Search.ForwardNodes[ForwardNodeIndex].GetNodeFx();
+		if(BackwardNodeIndex != INDEX_NONE && bBackwardBoundsCost)
+		{
+			MinPlanCost = FMath::Max(MinPlanCost, Search.BackwardNodes[BackwardNodeIndex].GetNodeFx());
+		}
+		if(Search.BestCost <= CostBoundWeight * MinPlanCost)
+			break;
+		// anytime search returns the best join found in time budget
+		if(Deadline > 0.0 && Search.BestForwardNode != INDEX_NONE && FPlatformTime::Seconds() >= Deadline)
+			break;
+		if(IsSearchCanceled())
+		{
+			bCanceled = true;
+			break;
+		}
+
+		if(BackwardNodeIndex != INDEX_NONE && Search.BackwardOpenNodes.Num() < Search.ForwardOpenNodes.Num())
+		{
+			Search.BackwardOpenNodes.RemoveSingleSwap(BackwardNodeIndex);
+			ExpandBidirectionalBackwardNode(Search, BackwardNodeIndex);
+			if(bBeam)
+			{
+				LimitOpenNodes(Search.BackwardNodes, Search.BackwardOpenNodes, FMath::Max(SearchSettings.BeamWidth, 1));
+			}
+		}
+		else
+		{
+			Search.ForwardOpenNodes.RemoveSingleSwap(ForwardNodeIndex);
+			ExpandBidirectionalForwardNode(Search, ForwardNodeIndex);
+			if(bBeam)
+			{
+				LimitOpenNodes(Search.ForwardNodes, Search.ForwardOpenNodes, FMath::Max(SearchSettings.BeamWidth, 1));
+			}
+		}
+		++VisitedNodesNum;
+	}
+	UE_LOG(LogGOAP, Verbose, TEXT("Summary visited nodes number: %d (frontiers: forward %d, backward %d)"),
+		VisitedNodesNum, Search.ForwardOpenNodes.Num(), Search.BackwardOpenNodes.Num());
+
+	// anytime search keeps the best join found before cancellation
+	if(Search.BestForwardNode != INDEX_NONE && (!bCanceled || Deadline > 0.0))
+	{
+		OutResult.PlanCost = Search.BestCost;
+		for(int32 NodeIndex = Search.BestForwardNode; Search.ForwardNodes[NodeIndex].ParentIndex != INDEX_NONE;
+			NodeIndex = Search.ForwardNodes[NodeIndex].ParentIndex)
+		{
+			OutResult.Plan.Add(Search.ForwardNodes[NodeIndex].ActionIndex);
+		}
+		Algo::Reverse(OutResult.Plan);
+		for(int32 NodeIndex = Search.BestBackwardNode;
+			NodeIndex != INDEX_NONE && Search.BackwardNodes[NodeIndex].ChildIndex != INDEX_NONE;
+			NodeIndex = Search.BackwardNodes[NodeIndex].ChildIndex)
+		{
+			OutResult.Plan.Add(Search.BackwardNodes[NodeIndex].ActionIndex);
+		}
+	}
+	OutResult.NodesExpanded = VisitedNodesNum;
+	OutResult.NodesGenerated = Search.ForwardNodes.Num() + Search.BackwardNodes.Num();
+	OutResult.NodesDeduplicated = Search.DeduplicatedNodesNum;
+	OutResult.ForwardFrontierSize = Search.ForwardOpenNodes.Num();
+	OutResult.BackwardFrontierSize = Search.BackwardOpenNodes.Num();
+
+	OutResult.SearchMemory = Search.ForwardNodes.GetAllocatedSize() + Search.ForwardOpenNodes.GetAllocatedSize() +
+		Search.ForwardNodesByHash.GetAllocatedSize() + Search.ForwardNodesByFact.GetAllocatedSize() +
+		Search.BackwardNodes.GetAllocatedSize() + Search.BackwardOpenNodes.GetAllocatedSize() +
+		Search.BestBackwardNodes.GetAllocatedSize() + Search.BackwardNodesByFirstFact.GetAllocatedSize();
+	for(const FBidirectionalForwardNode& Node : Search.ForwardNodes)
+	{
+		OutResult.SearchMemory += Node.State.GetAllocatedSize();
+	}
+	for(const FBidirectionalBackwardNode& Node : Search.BackwardNodes)
+	{
+		OutResult.SearchMemory += Node.State.Facts.GetAllocatedSize();
+	}
+	for(const TPair<FGOAPCoreFact, TArray<int32>>& FactNodes : Search.ForwardNodesByFact)
+	{
+		OutResult.SearchMemory += FactNodes.Value.GetAllocatedSize();
+	}
+	for(const TPair<FGOAPCoreFact, TArray<int32>>& FactNodes : Search.BackwardNodesByFirstFact)
+	{
+		OutResult.SearchMemory += FactNodes.Value.GetAllocatedSize();
+	}
+}
+
+void FGOAPPlanningCore::SearchMultiGoal(const FGOAPPlanningProblem& Problem, float PlanCostScoreWeight,
+	FGOAPCoreSearchResult& OutResult) const
+{
+	using namespace GOAPPlanningCore;
+
+	OutResult = FGOAPCoreSearchResult();
+
+	// goals satisfied in initial state have nothing to plan
+	TArray<int32> PendingGoals;
+	for(int32 GoalIndex = 0; GoalIndex < Problem.Goals.Num(); ++GoalIndex)
+	{
+		const FGOAPCoreGoal& Goal = Problem.Goals[GoalIndex];
+		if(FGOAPPlanningProblem::GetUnsatisfiedConditionsNum(Goal.Conditions, Goal.Junction, Problem.InitialState) > 0)
+		{
+			PendingGoals.Add(GoalIndex);
+		}
+	}
+	if(PendingGoals.Num() == 0)
+		return;
+
+	const auto GetHeuristic = [&Problem, &PendingGoals](const FGOAPCoreState& State)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_Heuristic);
+
+		int32 MinUnsatisfiedNum = MAX_int32;
+		for(const int32 GoalIndex : PendingGoals)
+		{
+			const FGOAPCoreGoal& Goal = Problem.Goals[GoalIndex];
+			MinUnsatisfiedNum = FMath::Min(MinUnsatisfiedNum,
+				FGOAPPlanningProblem::GetUnsatisfiedConditionsNum(Goal.Conditions, Goal.Junction, State));
+		}
+		return MinUnsatisfiedNum;
+	};
+
+	TArray<FBidirectionalForwardNode> Nodes;
+	TArray<int32> OpenNodes;
+	// nodes by hashes of their states
+	TMultiMap<uint32, int32> NodesByHash;
+
+	FBidirectionalForwardNode& InitNode = Nodes.AddDefaulted_GetRef();
+	InitNode.State = Problem.InitialState;
+	InitNode.Hash = GetStateHash(InitNode.State);
+	InitNode.Heuristic = GetHeuristic(InitNode.State);
+	OpenNodes.Add(0);
+	NodesByHash.Add(InitNode.Hash, 0);
+
+	int32 BestNodeIndex = INDEX_NONE;
+	float BestValue = 0.0f;
+	int32 VisitedNodesNum = 0;
+	while(PendingGoals.Num() > 0)
+	{
+		const int32 NodeIndex = FindBestOpenNode(Nodes, OpenNodes);
+		if(NodeIndex == INDEX_NONE)
+			break;
+
+		// f(x) of the best open node bounds costs of plans of goals not reached yet
+		if(BestNodeIndex != INDEX_NONE)
+		{
+			float MaxPendingValue = -MAX_flt;
+			for(const int32 GoalIndex : PendingGoals)
+			{
+				MaxPendingValue = FMath::Max(MaxPendingValue,
+					Problem.Goals[GoalIndex].Score - PlanCostScoreWeight * Nodes[NodeIndex].GetNodeFx());
+			}
+			if(BestValue >= MaxPendingValue)
+				break;
+		}
+		OpenNodes.RemoveSingleSwap(NodeIndex);
+		++VisitedNodesNum;
+
+		// goals are tested in problem's order, so of goals reached with the same value the first one is kept
+		for(int32 PendingIndex = 0; PendingIndex < PendingGoals.Num();)
+		{
+			const int32 GoalIndex = PendingGoals[PendingIndex];
+			const FGOAPCoreGoal& Goal = Problem.Goals[GoalIndex];
+			if(FGOAPPlanningProblem::GetUnsatisfiedConditionsNum(Goal.Conditions, Goal.Junction,
+				Nodes[NodeIndex].State) > 0)
+			{
+				++PendingIndex;
+				continue;
+			}
+
+			const float Value = Goal.Score - PlanCostScoreWeight * Nodes[NodeIndex].Cost;
+			UE_LOG(LogGOAP, Verbose, TEXT("Goal %d reached: cost %d, value %f"), GoalIndex, Nodes[NodeIndex].Cost,
+				Value);
+			if(BestNodeIndex == INDEX_NONE || Value > BestValue)
+			{
+				BestNodeIndex = NodeIndex;
+				BestValue = Value;
+				OutResult.GoalIndex = GoalIndex;
+			}
+			PendingGoals.RemoveAt(PendingIndex);
+		}
+
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_ExpandNode);
+		for(int32 ActionIndex = 0; ActionIndex < Problem.GetActionsNum() && PendingGoals.Num() > 0; ++ActionIndex)
+		{
+			if(!Problem.IsActionApplicable(Nodes[NodeIndex].State, ActionIndex))
+				continue;
+
+			// Nodes can be reallocated by adding new node, so parent's data is copied first
+			FBidirectionalForwardNode NewNode;
+			NewNode.State = Nodes[NodeIndex].State;
+			Problem.ApplyAction(NewNode.State, ActionIndex);
+			NewNode.Hash = GetStateHash(NewNode.State);
+			NewNode.ParentIndex = NodeIndex;
+			NewNode.ActionIndex = ActionIndex;
+			NewNode.Cost = Nodes[NodeIndex].Cost + Problem.GetActionCost(ActionIndex);
+			NewNode.Heuristic = GetHeuristic(NewNode.State);
+
+			// state already reached with lower or equal cost isn't searched again
+			bool bDuplicate = false;
+			for(auto It = NodesByHash.CreateKeyIterator(NewNode.Hash); It && !bDuplicate; ++It)
+			{
+				FBidirectionalForwardNode& Node = Nodes[It.Value()];
+				if(Node.bSuperseded || Node.State != NewNode.State)
+					continue;
+
+				++OutResult.NodesDeduplicated;
+				bDuplicate = Node.Cost <= NewNode.Cost;
+				Node.bSuperseded = !bDuplicate;
+			}
+			if(bDuplicate)
+				continue;
+
+			const uint32 Hash = NewNode.Hash;
+			const int32 NewNodeIndex = Nodes.Add(MoveTemp(NewNode));
+			OpenNodes.Add(NewNodeIndex);
+			NodesByHash.Add(Hash, NewNodeIndex);
+		}
+	}
+	UE_LOG(LogGOAP, Verbose, TEXT("Summary visited nodes number: %d (goals not reached: %d)"), VisitedNodesNum,
+		PendingGoals.Num());
+
+	if(BestNodeIndex != INDEX_NONE)
+	{
+		OutResult.PlanCost = Nodes[BestNodeIndex].Cost;
+		for(int32 NodeIndex = BestNodeIndex; Nodes[NodeIndex].ParentIndex != INDEX_NONE;
+			NodeIndex = Nodes[NodeIndex].ParentIndex)
+		{
+			OutResult.Plan.Add(Nodes[NodeIndex].ActionIndex);
+		}
+		Algo::Reverse(OutResult.Plan);
+	}
+	OutResult.NodesExpanded = VisitedNodesNum;
+	OutResult.NodesGenerated = Nodes.Num();
+	OutResult.ForwardFrontierSize = OpenNodes.Num();
+	OutResult.SearchMemory = Nodes.GetAllocatedSize() + OpenNodes.GetAllocatedSize() + NodesByHash.GetAllocatedSize();
+	for(const FBidirectionalForwardNode& Node : Nodes)
+	{
+		OutResult.SearchMemory += Node.State.GetAllocatedSize();
+	}
+}
@@ -0,0 +1,557 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPPlanningRecording.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GOAPWorldStatePayloads.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/BufferArchive.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+namespace GOAPPlanningRecording
+{
+	/** Identifies recording files. */
+	static constexpr uint32 FileMagic = 0x52414F47; // "GOAR"
+	/** Increase when file format changes. Version 2 - predicates and scores of many goals. */
+	static constexpr int32 FileVersion = 2;
+	/** Index of object which isn't recorded (INDEX_NONE means null object). */
+	static constexpr int32 UnknownIndex = -2;
+
+	/**
+	 * Archive storing references to recorded actors (e.g. in actor payloads) as their indexes, so they can be bound to
+	 * stand-in actors during replay. References to other objects aren't stored.
+	 */
+	class FRecordingArchive : public FObjectAndNameAsStringProxyArchive
+	{
+	public:
+
+		FRecordingArchive(FArchive& InInnerArchive, const TArray<AActor*>& InActors,
+			const TMap<AActor*, int32>& InActorsIndexes)
+			: FObjectAndNameAsStringProxyArchive(InInnerArchive, false), Actors(InActors),
+			ActorsIndexes(InActorsIndexes) {}
+
+		virtual FArchive& operator<<(UObject*& Obj) override
+		{
+			int32 ActorIndex = INDEX_NONE;
+			if(IsSaving())
+			{
+				const int32* FoundIndex = ActorsIndexes.Find(Cast<AActor>(Obj));
+				ActorIndex = FoundIndex ? *FoundIndex : INDEX_NONE;
+			}
+			InnerArchive << ActorIndex;
+			if(IsLoading())
+			{
+				Obj = Actors.IsValidIndex(ActorIndex) ? Actors[ActorIndex] : nullptr;
+			}
+			return *this;
+		}
+
+	private:
+
+		const TArray<AActor*>& Actors;
+		const TMap<AActor*, int32>& ActorsIndexes;
+	};
+}
+
+/// Recording
+void FGOAPPlanningRecording::BeginRecording(AActor* Agent, const TArray<AActor*>& Memory,
+	const TArray<UObject*>& InActions, const UClass* SolverClass, const UObject* Goal)
+{
+	Actors.Reset();
+	ActorsNames.Reset();
+	ActorsIndexes.Reset();
+	MemoryIndexes.Reset();
+	Actions.Reset();
+	ActionsNames.Reset();
+	ActionsIndexes.Reset();
+	KeysActors.Reset();
+	KeysTags.Reset();
+	KeysIndexes.Reset();
+	Values.Reset();
+	ValuesIndexes.Reset();
+	PredicatesData.Reset();
+	PredicatesJunctions.Reset();
+	bMultiGoal = false;
+	GoalsScores.Reset();
+	PlanCostScoreWeight = 0.0f;
+	Queries.Reset();
+
+	SolverClassPath = SolverClass ? SolverClass->GetPathName() : FString();
+	GoalName = Goal ? Goal->GetClass()->GetName() : FString();
+
+	AgentIndex = GetActorIndex(Agent, true);
+	for(AActor* MemoryActor : Memory)
+	{
+		MemoryIndexes.Add(GetActorIndex(MemoryActor, true));
+	}
+	for(UObject* Action : InActions)
+	{
+		ActionsIndexes.Add(Action, Actions.Add(Action));
+		ActionsNames.Add(GetNameSafe(Action));
+	}
+}
+
+void FGOAPPlanningRecording::RecordGoalPredicate(const FGOAPGoalPredicate& Predicate)
+{
+	PredicatesJunctions.Add(static_cast<int32>(Predicate.Junction));
+	TArray<int32>& PredicateData = PredicatesData.AddDefaulted_GetRef();
+	for(const FGOAPGoalPredicate::FInstruction& Instruction : Predicate.Instructions)
+	{
+		PredicateData.Add(GetKeyIndex(Predicate.Keys[Instruction.KeyIndex], true));
+		PredicateData.Add(static_cast<int32>(Instruction.Operator));
+		PredicateData.Add(GetValueIndex(Instruction.Value, true));
+	}
+}
+
+void FGOAPPlanningRecording::RecordGoalsScores(const TArray<float>& Scores, float InPlanCostScoreWeight)
+{
+	bMultiGoal = true;
+	GoalsScores = Scores;
+	PlanCostScoreWeight = InPlanCostScoreWeight;
+}
+
+void FGOAPPlanningRecording::RecordWorldStateValue(const FGOAPWorldStateKey& Key, const FGOAPWorldStateValue& Value)
+{
+	FRecordedQuery Query;
+	Query.Data = { static_cast<int32>(EQueryType::WorldStateValue), GetKeyIndex(Key, true) };
+	Queries.Add(Query, { GetValueIndex(Value.Payload, true) });
+}
+
+void FGOAPPlanningRecording::RecordCanChangeWorldState(UObject* Action, const FGOAPWorldStateData& DesiredWorldState,
+	bool bResult)
+{
+	FRecordedQuery Query;
+	MakeActionQuery(EQueryType::CanChangeWorldState, Action, DesiredWorldState, true, Query);
+	Queries.Add(Query, { bResult ? 1 : 0 });
+}
+
+void FGOAPPlanningRecording::RecordPreconditions(UObject* Action, const FGOAPWorldStateData& ForDesiredWorldState,
+	const TArray<FGOAPWorldStateData>& Preconditions)
+{
+	FRecordedQuery Query;
+	MakeActionQuery(EQueryType::Preconditions, Action, ForDesiredWorldState, true, Query);
+	TArray<int32> Result;
+	for(const FGOAPWorldStateData& Precondition : Preconditions)
+	{
+		EncodeData(Precondition, true, Result);
+	}
+	Queries.Add(Query, Result);
+}
+
+void FGOAPPlanningRecording::RecordActionCost(UObject* Action, const FGOAPWorldStateData& DesiredWorldState,
+	const TArray<FGOAPWorldStateData>& WithCurrentWorldState, int32 Cost)
+{
+	FRecordedQuery Query;
+	MakeActionQuery(EQueryType::ActionCost, Action, DesiredWorldState, true, Query);
+	for(const FGOAPWorldStateData& CurrentWorldState : WithCurrentWorldState)
+	{
+		EncodeData(CurrentWorldState, true, Query.Data);
+	}
+	Queries.Add(Query, { Cost });
+}
+
+void FGOAPPlanningRecording::RecordActionEffect(UObject* Action, AActor* ContextActor, bool bResult,
+	const FGOAPWorldStateData& Effect)
+{
+	FRecordedQuery Query;
+	Query.Data = { static_cast<int32>(EQueryType::ActionEffect), ActionsIndexes.FindRef(Action),
+		GetActorIndex(ContextActor, true) };
+	TArray<int32> Result = { bResult ? 1 : 0 };
+	if(bResult)
+	{
+		EncodeData(Effect, true, Result);
+	}
+	Queries.Add(Query, Result);
+}
+
+void FGOAPPlanningRecording::FinishRecording(int32 InPlanLength, int32 InPlanCost, double InSearchTime)
+{
+	PlanLength = InPlanLength;
+	PlanCost = InPlanCost;
+	SearchTime = InSearchTime;
+}
+
+/// Replay
+const FGOAPGoalPredicate& FGOAPPlanningRecording::GetReplayPredicate(int32 GoalIndex) const
+{
+	// recording without goal's predicate is replayed as search of empty (satisfied) goal
+	static const FGOAPGoalPredicate EmptyPredicate;
+	return ReplayPredicates.IsValidIndex(GoalIndex) ? ReplayPredicates[GoalIndex] : EmptyPredicate;
+}
+
+bool FGOAPPlanningRecording::FindWorldStateValue(const FGOAPWorldStateKey& Key, FGOAPWorldStateValue& OutValue)
+{
+	FRecordedQuery Query;
+	Query.Data = { static_cast<int32>(EQueryType::WorldStateValue), GetKeyIndex(Key, false) };
+	const TArray<int32>* Result = FindQueryResult(Query);
+	if(!Result)
+		return false;
+
+	OutValue.Payload = Values.IsValidIndex((*Result)[0]) ? Values[(*Result)[0]] : nullptr;
+	return true;
+}
+
+bool FGOAPPlanningRecording::FindCanChangeWorldState(UObject* Action, const FGOAPWorldStateData& DesiredWorldState,
+	bool& bOutResult)
+{
+	FRecordedQuery Query;
+	MakeActionQuery(EQueryType::CanChangeWorldState, Action, DesiredWorldState, false, Query);
+	const TArray<int32>* Result = FindQueryResult(Query);
+	if(!Result)
+		return false;
+
+	bOutResult = (*Result)[0] != 0;
+	return true;
+}
+
+bool FGOAPPlanningRecording::FindPreconditions(UObject* Action, const FGOAPWorldStateData& ForDesiredWorldState,
+	TArray<FGOAPWorldStateData>& OutPreconditions)
+{
+	FRecordedQuery Query;
+	MakeActionQuery(EQueryType::Preconditions, Action, ForDesiredWorldState, false, Query);
+	const TArray<int32>* Result = FindQueryResult(Query);
+	if(!Result)
+		return false;
+
+	OutPreconditions.Reset(Result->Num() / 2);
+	for(int32 Index = 0; Index < Result->Num(); Index += 2)
+	{
+		OutPreconditions.Add(DecodeData(*Result, Index));
+	}
+	return true;
+}
+
+bool FGOAPPlanningRecording::FindActionCost(UObject* Action, const FGOAPWorldStateData& DesiredWorldState,
+	const TArray<FGOAPWorldStateData>& WithCurrentWorldState, int32& OutCost)
+{
+	FRecordedQuery Query;
+	if(MakeActionQuery(EQueryType::ActionCost, Action, DesiredWorldState, false, Query))
+	{
+		for(const FGOAPWorldStateData& CurrentWorldState : WithCurrentWorldState)
+		{
+			if(!EncodeData(CurrentWorldState, false, Query.Data))
+			{
+				Query.Data.Reset();
+				break;
+			}
+		}
+	}
+	const TArray<int32>* Result = FindQueryResult(Query);
+	if(!Result)
+		return false;
+
+	OutCost = (*Result)[0];
+	return true;
+}
+
+bool FGOAPPlanningRecording::FindActionEffect(UObject* Action, AActor* ContextActor, bool& bOutResult,
+	FGOAPWorldStateData& OutEffect)
+{
+	FRecordedQuery Query;
+	const int32* ActionIndex = ActionsIndexes.Find(Action);
+	Query.Data = { static_cast<int32>(EQueryType::ActionEffect), ActionIndex ? *ActionIndex : GOAPPlanningRecording::UnknownIndex,
+		GetActorIndex(ContextActor, false) };
+	const TArray<int32>* Result = FindQueryResult(Query);
+	if(!Result)
+		return false;
+
+	bOutResult = (*Result)[0] != 0;
+	if(bOutResult)
+	{
+		OutEffect = DecodeData(*Result, 1);
+	}
+	return true;
+}
+
+/// Helpers
+int32 FGOAPPlanningRecording::GetActorIndex(AActor* Actor, bool bAdd)
+{
+	if(!Actor)
+		return INDEX_NONE;
+
+	if(const int32* FoundIndex = ActorsIndexes.Find(Actor))
+		return *FoundIndex;
+
+	if(!bAdd)
+		return GOAPPlanningRecording::UnknownIndex;
+
+	const int32 NewIndex = Actors.Add(Actor);
+	ActorsNames.Add(Actor->GetName());
+	ActorsIndexes.Add(Actor, NewIndex);
+	return NewIndex;
+}
+
+int32 FGOAPPlanningRecording::GetKeyIndex(const FGOAPWorldStateKey& Key, bool bAdd)
+{
+	if(const int32* FoundIndex = KeysIndexes.Find(Key))
+		return *FoundIndex;
+
+	if(!bAdd)
+		return GOAPPlanningRecording::UnknownIndex;
+
+	const int32 NewIndex = KeysActors.Add(GetActorIndex(Key.WorldStateActor, true));
+	KeysTags.Add(Key.WorldStateDataTag);
+	KeysIndexes.Add(Key, NewIndex);
+	return NewIndex;
+}
+
+int32 FGOAPPlanningRecording::GetValueIndex(UGOAPWorldStatePayload* Value, bool bAdd)
+{
+	if(!Value)
+		return INDEX_NONE;
+
+	if(const int32* FoundIndex = ValuesIndexes.Find(Value))
+		return *FoundIndex;
+
+	// values are compared, so each distinct value is stored once
+	for(int32 ValueIndex = 0; ValueIndex < Values.Num(); ++ValueIndex)
+	{
+		if(Values[ValueIndex]->GetClass() == Value->GetClass() && Values[ValueIndex]->IsEqual(Value))
+		{
+			if(bAdd)
+			{
+				ValuesIndexes.Add(Value, ValueIndex);
+			}
+			return ValueIndex;
+		}
+	}
+
+	if(!bAdd)
+		return GOAPPlanningRecording::UnknownIndex;
+
+	// payloads can be overridden later (e.g. by atoms), so copy is stored
+	UGOAPWorldStatePayload* ValueCopy = DuplicateObject<UGOAPWorldStatePayload>(Value, GetTransientPackage());
+	const int32 NewIndex = Values.Add(ValueCopy);
+	ValuesIndexes.Add(Value, NewIndex);
+	ValuesIndexes.Add(ValueCopy, NewIndex);
+	return NewIndex;
+}
+
+bool FGOAPPlanningRecording::EncodeData(const FGOAPWorldStateData& Data, bool bAdd, TArray<int32>& OutQueryData)
+{
+	const int32 KeyIndex = GetKeyIndex(Data.WorldStateKey, bAdd);
+	const int32 ValueIndex = GetValueIndex(Data.WorldStateValue.Payload, bAdd);
+	if(KeyIndex == GOAPPlanningRecording::UnknownIndex || ValueIndex == GOAPPlanningRecording::UnknownIndex)
+		return false;
+
+	OutQueryData.Add(KeyIndex);
+	OutQueryData.Add(ValueIndex);
+	return true;
+}
+
+FGOAPWorldStateData FGOAPPlanningRecording::DecodeData(const TArray<int32>& QueryData, int32 Index) const
+{
+	const int32 KeyIndex = QueryData[Index];
+	const int32 ValueIndex = QueryData[Index + 1];
+	AActor* KeyActor = Actors.IsValidIndex(KeysActors[KeyIndex]) ? Actors[KeysActors[KeyIndex]] : nullptr;
+	return FGOAPWorldStateData(FGOAPWorldStateKey(KeyActor, KeysTags[KeyIndex]),
+		FGOAPWorldStateValue(Values.IsValidIndex(ValueIndex) ? Values[ValueIndex] : nullptr));
+}
+
+bool FGOAPPlanningRecording::MakeActionQuery(EQueryType Type, UObject* Action, const FGOAPWorldStateData& Data,
+	bool bAdd, FRecordedQuery& OutQuery)
+{
+	OutQuery.Data.Reset();
+	const int32* ActionIndex = ActionsIndexes.Find(Action);
+	if(!ActionIndex && !bAdd)
+		return false;
+
+	OutQuery.Data.Add(static_cast<int32>(Type));
+	if(ActionIndex)
+	{
+		OutQuery.Data.Add(*ActionIndex);
+	}
+	else
+	{
+		const int32 NewIndex = Actions.Add(Action);
+		ActionsNames.Add(GetNameSafe(Action));
+		ActionsIndexes.Add(Action, NewIndex);
+		OutQuery.Data.Add(NewIndex);
+	}
+	if(!EncodeData(Data, bAdd, OutQuery.Data))
+	{
+		// unknown data - query can't be recorded
+		OutQuery.Data.Reset();
+		return false;
+	}
+	return true;
+}
+
+const TArray<int32>* FGOAPPlanningRecording::FindQueryResult(const FRecordedQuery& Query)
+{
+	// empty query is query with unknown arguments
+	const TArray<int32>* Result = Query.Data.Num() > 0 ? Queries.Find(Query) : nullptr;
+	if(!Result)
+	{
+		++MissedQueriesNum;
+	}
+	return Result;
+}
+
+/// Serialization
+bool FGOAPPlanningRecording::SaveToFile(const FString& FilePath)
+{
+	FBufferArchive Buffer;
+	GOAPPlanningRecording::FRecordingArchive Archive(Buffer, Actors, ActorsIndexes);
+	if(!Serialize(Archive, nullptr))
+		return false;
+
+	return FFileHelper::SaveArrayToFile(Buffer, *FilePath);
+}
+
+bool FGOAPPlanningRecording::LoadFromFile(const FString& FilePath, UWorld* ReplayWorld)
+{
+	if(!ReplayWorld)
+		return false;
+
+	TArray<uint8> Buffer;
+	if(!FFileHelper::LoadFileToArray(Buffer, *FilePath))
+		return false;
+
+	FMemoryReader Reader(Buffer);
+	GOAPPlanningRecording::FRecordingArchive Archive(Reader, Actors, ActorsIndexes);
+	return Serialize(Archive, ReplayWorld);
+}
+
+bool FGOAPPlanningRecording::Serialize(FArchive& Ar, UWorld* ReplayWorld)
+{
+	uint32 Magic = GOAPPlanningRecording::FileMagic;
+	int32 Version = GOAPPlanningRecording::FileVersion;
+	Ar << Magic << Version;
+	if(Magic != GOAPPlanningRecording::FileMagic || Version != GOAPPlanningRecording::FileVersion)
+	{
+		UE_LOG(LogGOAP, Error, TEXT("Not supported planning recording format!"));
+		return false;
+	}
+
+	Ar << SolverClassPath << GoalName << PlanLength << PlanCost << SearchTime;
+
+	// actors - stand-ins are spawned during loading
+	Ar << ActorsNames << AgentIndex << MemoryIndexes;
+	if(Ar.IsLoading())
+	{
+		Actors.Reset();
+		ActorsIndexes.Reset();
+		for(const FString& ActorName : ActorsNames)
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.Name = MakeUniqueObjectName(ReplayWorld->PersistentLevel, AActor::StaticClass(),
+				FName(*ActorName));
+			SpawnParameters.ObjectFlags |= RF_Transient;
+			AActor* StandIn = ReplayWorld->SpawnActor<AActor>(SpawnParameters);
+			ActorsIndexes.Add(StandIn, Actors.Add(StandIn));
+		}
+		ReplayMemory.Reset();
+		for(const int32 MemoryIndex : MemoryIndexes)
+		{
+			ReplayMemory.Add(Actors.IsValidIndex(MemoryIndex) ? Actors[MemoryIndex] : nullptr);
+		}
+	}
+
+	// actions
+	Ar << ActionsNames;
+	if(Ar.IsLoading())
+	{
+		Actions.Reset();
+		ActionsIndexes.Reset();
+		for(const FString& ActionName : ActionsNames)
+		{
+			UGOAPRecordedAction* StandIn = NewObject<UGOAPRecordedAction>(ReplayWorld);
+			StandIn->RecordedName = ActionName;
+			ActionsIndexes.Add(StandIn, Actions.Add(StandIn));
+		}
+	}
+
+	// keys
+	TArray<FName> KeysTagsNames;
+	if(Ar.IsSaving())
+	{
+		for(const FGameplayTag& Tag : KeysTags)
+		{
+			KeysTagsNames.Add(Tag.GetTagName());
+		}
+	}
+	Ar << KeysActors << KeysTagsNames;
+	if(Ar.IsLoading())
+	{
+		KeysTags.Reset();
+		KeysIndexes.Reset();
+		for(int32 KeyIndex = 0; KeyIndex < KeysActors.Num(); ++KeyIndex)
+		{
+			KeysTags.Add(FGameplayTag::RequestGameplayTag(KeysTagsNames[KeyIndex], false));
+			AActor* KeyActor = Actors.IsValidIndex(KeysActors[KeyIndex]) ? Actors[KeysActors[KeyIndex]] : nullptr;
+			KeysIndexes.Add(FGOAPWorldStateKey(KeyActor, KeysTags[KeyIndex]), KeyIndex);
+		}
+	}
+
+	// values - class path followed by payload properties
+	int32 ValuesNum = Values.Num();
+	Ar << ValuesNum;
+	if(Ar.IsLoading())
+	{
+		Values.Reset();
+		ValuesIndexes.Reset();
+	}
+	for(int32 ValueIndex = 0; ValueIndex < ValuesNum; ++ValueIndex)
+	{
+		FString ClassPath = Ar.IsSaving() ? Values[ValueIndex]->GetClass()->GetPathName() : FString();
+		Ar << ClassPath;
+		if(Ar.IsLoading())
+		{
+			UClass* PayloadClass = FindObject<UClass>(nullptr, *ClassPath);
+			if(!PayloadClass || !PayloadClass->IsChildOf(UGOAPWorldStatePayload::StaticClass()))
+			{
+				UE_LOG(LogGOAP, Error, TEXT("Planning recording contains unknown payload class %s!"), *ClassPath);
+				return false;
+			}
+			ValuesIndexes.Add(Values.Add_GetRef(NewObject<UGOAPWorldStatePayload>(GetTransientPackage(), PayloadClass)),
+				ValueIndex);
+		}
+		Values[ValueIndex]->Serialize(Ar);
+	}
+
+	// goals
+	Ar << PredicatesData << PredicatesJunctions << bMultiGoal << GoalsScores << PlanCostScoreWeight;
+	if(Ar.IsLoading())
+	{
+		ReplayPredicates.Reset();
+		for(int32 GoalIndex = 0; GoalIndex < PredicatesData.Num(); ++GoalIndex)
+		{
+			const TArray<int32>& Data = PredicatesData[GoalIndex];
+			FGOAPGoalPredicate& ReplayPredicate = ReplayPredicates.AddDefaulted_GetRef();
+			ReplayPredicate.Junction = PredicatesJunctions.IsValidIndex(GoalIndex) ?
+				static_cast<EGOAPConditionJunction>(PredicatesJunctions[GoalIndex]) : EGOAPConditionJunction::All;
+			for(int32 Index = 0; Index + 2 < Data.Num(); Index += 3)
+			{
+				const FGOAPWorldStateData Condition = DecodeData({ Data[Index], Data[Index + 2] }, 0);
+				FGOAPGoalPredicate::FInstruction Instruction;
+				Instruction.KeyIndex = ReplayPredicate.Keys.AddUnique(Condition.WorldStateKey);
+				Instruction.Operator = static_cast<EGOAPConditionOperator>(Data[Index + 1]);
+				Instruction.Value = Condition.WorldStateValue.Payload;
+				if(Instruction.Value)
+				{
+					Instruction.Value->GetNumericValue(Instruction.Number);
+				}
+				ReplayPredicate.Instructions.Add(Instruction);
+			}
+		}
+	}
+
+	// queries
+	Ar << Queries;
+
+	return !Ar.IsError();
+}
+
+void FGOAPPlanningRecording::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(Values);
+	Collector.AddReferencedObjects(Actions);
+	for(FGOAPGoalPredicate& ReplayPredicate : ReplayPredicates)
+	{
+		ReplayPredicate.AddReferencedObjects(Collector);
+	}
+}
@@ -0,0 +1,9 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPSettings.h"
+
+UGOAPSettings::UGOAPSettings()
+{
+	CategoryName = TEXT("Plugins");
+}
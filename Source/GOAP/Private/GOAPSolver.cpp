@@ -3,6 +3,32 @@
 
 #include "GOAPSolver.h"
 
+#include "GOAPAction.h"
+#include "GOAPGoal.h"
+#include "GOAPHookProfiler.h"
+#include "GOAPPlanner.h"
+#include "GOAPPlanningRecording.h"
+#include "GOAPStats.h"
+#include "GOAPTrace.h"
+#include "GOAPWorldStateFunctionLibrary.h"
+#include "GOAPWorldStatePayloads.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<bool> CVarGOAPRecordingEnable(
+	TEXT("GOAP.Recording.Enable"),
+	false,
+	TEXT("If true, solvers record planning problems (world state reads and action queries) and save them to ")
+	TEXT("Saved/GOAP/Recordings, so they can be replayed offline."));
+
+static TAutoConsoleVariable<float> CVarGOAPRecordingMinSearchTime(
+	TEXT("GOAP.Recording.MinSearchTimeMs"),
+	0.0f,
+	TEXT("Only searches lasting at least this time (in milliseconds) are saved when recording is enabled."));
+
+FGOAPSearchFinishedDelegate UGOAPSolver::OnSearchFinished;
+
 void UGOAPSolver::InitializeSolver(UGOAPPlanner* ForPlanner)
 {
 	Planner = ForPlanner;
@@ -10,6 +36,467 @@ void UGOAPSolver::InitializeSolver(UGOAPPlanner* ForPlanner)
 
 TArray<FGOAPActionWithTargetData> UGOAPSolver::FindPlanForGoal(UGOAPGoal* Goal)
 {
-	return TArray<FGOAPActionWithTargetData>();
+	LLM_SCOPE_BYTAG(GOAP_Solver);
+
+	if(!Goal)
+	{
+		return TArray<FGOAPActionWithTargetData>();
+	}
+
+	UE_LOG(LogGOAP, Log, TEXT("Start looking for solution for goal: %s (%s)"), *Goal->GetName(),
+		*GetClass()->GetName());
+	BeginSearch(Goal);
+
+	// solver which doesn't ground problems (e.g. base class) finds no plan
+	FGOAPCoreSearchResult Result;
+	if(BuildProblemForGoal(Goal))
+	{
+		SearchProblem(Result);
+	}
+
+	TArray<FGOAPActionWithTargetData> Plan = TranslatePlan(Result);
+	FinishSearch(Result);
+	return Plan;
+}
+
+TArray<FGOAPActionWithTargetData> UGOAPSolver::FindPlanForGoals(const TArray<UGOAPGoal*>& Goals,
+	const TArray<float>& Scores, float PlanCostScoreWeight, int32& OutGoalIndex)
+{
+	LLM_SCOPE_BYTAG(GOAP_Solver);
+
+	OutGoalIndex = INDEX_NONE;
+	if(Goals.Num() == 0)
+	{
+		return TArray<FGOAPActionWithTargetData>();
+	}
+
+	UE_LOG(LogGOAP, Log, TEXT("Start looking for solution for %d goals (multi-goal planning)"), Goals.Num());
+	// search settings are the first goal's ones
+	BeginSearch(Goals[0]);
+	if(ActiveRecording.IsValid())
+	{
+		ActiveRecording->RecordGoalsScores(Scores, PlanCostScoreWeight);
+	}
+
+	ResetProblem();
+	AddActionsOnContextActors(UsesSimplifiedActionCost());
+	TArray<const FGOAPGoalPredicate*> GoalsPredicates;
+	for(int32 GoalIndex = 0; GoalIndex < Goals.Num(); ++GoalIndex)
+	{
+		GoalsPredicates.Add(&GetGoalPredicate(Goals[GoalIndex], GoalIndex));
+	}
+	FinalizeProblem(GoalsPredicates, Scores);
+
+	FGOAPCoreSearchResult Result;
+	PlanningCore.SearchMultiGoal(Problem, PlanCostScoreWeight, Result);
+	OutGoalIndex = Result.GoalIndex;
+	if(OutGoalIndex != INDEX_NONE)
+	{
+		UE_LOG(LogGOAP, Log, TEXT("Goal %s chosen (plan cost %d)"), *Goals[OutGoalIndex]->GetName(), Result.PlanCost);
+	}
+
+	TArray<FGOAPActionWithTargetData> Plan = TranslatePlan(Result);
+	FinishSearch(Result);
+	return Plan;
+}
+
+TArray<FGOAPActionWithTargetData> UGOAPSolver::ReplayRecording(FGOAPPlanningRecording& Recording)
+{
+	// goals are only placeholders - their predicates are taken from recording
+	const int32 GoalsNum = Recording.IsMultiGoal() ? Recording.GetGoalsScores().Num() : 1;
+	while(ReplayGoals.Num() < GoalsNum)
+	{
+		ReplayGoals.Add(NewObject<UGOAPGoal>(this));
+	}
+	
+	ReplayedRecording = &Recording;
+	TArray<FGOAPActionWithTargetData> Plan;
+	if(Recording.IsMultiGoal())
+	{
+		int32 GoalIndex;
+		Plan = FindPlanForGoals(TArray<UGOAPGoal*>(ReplayGoals.GetData(), GoalsNum), Recording.GetGoalsScores(),
+			Recording.GetPlanCostScoreWeight(), GoalIndex);
+	}
+	else
+	{
+		Plan = FindPlanForGoal(ReplayGoals[0]);
+	}
+	ReplayedRecording = nullptr;
+	return Plan;
+}
+
+void UGOAPSolver::BeginSearch(const UGOAPGoal* Goal, bool bRecordable)
+{
+	LastSearchStats = FGOAPSearchStats();
+
+	// gather planning context
+	if(ReplayedRecording)
+	{
+		PlanningAgent = ReplayedRecording->GetReplayAgent();
+		PlanningMemory = ReplayedRecording->GetReplayMemory();
+		PlanningActions = ReplayedRecording->GetReplayActions();
+	}
+	else
+	{
+		PlanningAgent = Planner->GetAgent();
+		PlanningMemory = Planner->GetAgentsMemoryComponent()->GetMemory();
+		PlanningActions = Planner->GetActions();
+
+		if(bRecordable && CVarGOAPRecordingEnable.GetValueOnGameThread())
+		{
+			ActiveRecording = MakeShared<FGOAPPlanningRecording>();
+			ActiveRecording->BeginRecording(PlanningAgent, PlanningMemory, PlanningActions, GetClass(), Goal);
+		}
+	}
+	
+	// goal's settings override planner's ones; replayed searches use default settings
+	if(Goal && Goal->ShouldOverrideSearchSettings())
+	{
+		PlanningCore.SearchSettings = Goal->GetSearchSettings();
+	}
+	else
+	{
+		PlanningCore.SearchSettings = Planner && !ReplayedRecording ? Planner->GetSearchSettings() :
+			FGOAPSearchSettings();
+	}
+
+	SearchStartTime = FPlatformTime::Seconds();
+	GOAP_TRACE_SEARCH_STARTED(this, Goal);
+}
+
+void UGOAPSolver::FinishSearch(int32 PlanLength, int32 PlanCost)
+{
+	LastSearchStats.PlanLength = PlanLength;
+	LastSearchStats.PlanCost = PlanLength > 0 ? PlanCost : 0;
+	LastSearchStats.SearchTime = FPlatformTime::Seconds() - SearchStartTime;
+
+	INC_DWORD_STAT(STAT_GOAP_Searches);
+	INC_DWORD_STAT_BY(STAT_GOAP_NodesExpanded, LastSearchStats.NodesExpanded);
+	INC_DWORD_STAT_BY(STAT_GOAP_NodesGenerated, LastSearchStats.NodesGenerated);
+	INC_DWORD_STAT_BY(STAT_GOAP_NodesDeduplicated, LastSearchStats.NodesDeduplicated);
+	GOAP_TRACE_SEARCH_FINISHED(this, LastSearchStats);
+	OnSearchFinished.Broadcast(this, LastSearchStats);
+
+	if(ActiveRecording.IsValid())
+	{
+		if(LastSearchStats.SearchTime * 1000.0 >= CVarGOAPRecordingMinSearchTime.GetValueOnGameThread())
+		{
+			ActiveRecording->FinishRecording(LastSearchStats.PlanLength, LastSearchStats.PlanCost,
+				LastSearchStats.SearchTime);
+			const FString FilePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("GOAP"), TEXT("Recordings"),
+				FString::Printf(TEXT("%s_%s_%s.goaprec"), *GetClass()->GetName(), *ActiveRecording->GetGoalName(),
+					*FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S-%s"))));
+			if(ActiveRecording->SaveToFile(FilePath))
+			{
+				UE_LOG(LogGOAP, Display, TEXT("Planning problem recorded to %s"), *FilePath);
+			}
+			else
+			{
+				UE_LOG(LogGOAP, Error, TEXT("Can't save planning recording to %s!"), *FilePath);
+			}
+		}
+		ActiveRecording.Reset();
+	}
+
+	PlanningAgent = nullptr;
+	PlanningMemory.Reset();
+	PlanningActions.Reset();
+	ResetProblem();
+}
+
+void UGOAPSolver::FinishSearch(const FGOAPCoreSearchResult& Result)
+{
+	LastSearchStats.NodesExpanded = Result.NodesExpanded;
+	LastSearchStats.NodesGenerated = Result.NodesGenerated;
+	LastSearchStats.NodesDeduplicated = Result.NodesDeduplicated;
+	LastSearchStats.SearchMemory = Result.SearchMemory + Problem.GetAllocatedSize();
+	LastSearchStats.ForwardFrontierSize = Result.ForwardFrontierSize;
+	LastSearchStats.BackwardFrontierSize = Result.BackwardFrontierSize;
+	LastSearchStats.NodesReexpanded = Result.NodesReexpanded;
+	FinishSearch(Result.Plan.Num(), Result.PlanCost);
+}
+
+void UGOAPSolver::ResetProblem()
+{
+	Problem.Reset();
+	ProblemKeys.Reset();
+	ProblemKeysIndexes.Reset();
+	ProblemActors.Reset();
+	ProblemValues.Reset();
+}
+
+FGOAPCoreFact UGOAPSolver::InternFact(const FGOAPWorldStateData& WorldState)
+{
+	return FGOAPCoreFact(InternKey(WorldState.WorldStateKey), InternValue(WorldState.WorldStateValue.Payload));
+}
+
+int32 UGOAPSolver::InternKey(const FGOAPWorldStateKey& Key)
+{
+	if(const int32* KeyIndex = ProblemKeysIndexes.Find(Key))
+		return *KeyIndex;
+
+	const int32 KeyIndex = ProblemKeys.Add(Key);
+	ProblemKeysIndexes.Add(Key, KeyIndex);
+	Problem.KeysActors.Add(ProblemActors.AddUnique(Key.WorldStateActor));
+	return KeyIndex;
+}
+
+int32 UGOAPSolver::InternValue(UGOAPWorldStatePayload* Payload)
+{
+	// values are compared by payloads, so equal values of different payload objects share index
+	const int32 ValueIndex = ProblemValues.IndexOfByPredicate([Payload](UGOAPWorldStatePayload* Value)
+	{
+		return Value == Payload || (Value && Value->IsEqual(Payload));
+	});
+	return ValueIndex != INDEX_NONE ? ValueIndex : ProblemValues.Add(Payload);
+}
+
+FGOAPWorldStateData UGOAPSolver::GetFactWorldState(const FGOAPCoreFact& Fact) const
+{
+	return FGOAPWorldStateData(ProblemKeys[Fact.Key], FGOAPWorldStateValue(ProblemValues[Fact.Value]));
+}
+
+int32 UGOAPSolver::AddProblemAction(int32 ActionIndex, const FGOAPWorldStateData& Effect,
+	const TArray<FGOAPWorldStateData>& Preconditions, int32 Cost)
+{
+	FGOAPCoreAction& Action = Problem.Actions.AddDefaulted_GetRef();
+	Action.ActionIndex = ActionIndex;
+	Action.Effect = InternFact(Effect);
+	Action.Cost = Cost;
+	Action.Preconditions.Reserve(Preconditions.Num());
+	for(const FGOAPWorldStateData& Precondition : Preconditions)
+	{
+		Action.Preconditions.Add(InternFact(Precondition));
+	}
+	return Problem.Actions.Num() - 1;
+}
+
+void UGOAPSolver::AddActionsOnContextActors(bool bSimplifiedCost)
+{
+	const TArray<UObject*>& Actions = GetPlanningActions();
+	for(int32 ActionIndex = 0; ActionIndex < Actions.Num(); ++ActionIndex)
+	{
+		for(auto ContextActor : GetPlanningMemory())
+		{
+			FGOAPWorldStateData ActionEffect;
+			if(QueryActionEffect(Actions[ActionIndex], ContextActor, ActionEffect))
+			{
+				// world state in search nodes isn't known during grounding, so cost is evaluated once, without planned
+				// world state (WithCurrentWorldState is deprecated)
+				const int32 Cost = bSimplifiedCost ? 1 :
+					QueryActionCost(Actions[ActionIndex], ActionEffect, TArray<FGOAPWorldStateData>());
+				AddProblemAction(ActionIndex, ActionEffect, QueryPreconditions(Actions[ActionIndex], ActionEffect),
+					Cost);
+			}
+		}
+	}
+}
+
+void UGOAPSolver::FinalizeProblem(const FGOAPGoalPredicate* GoalPredicate)
+{
+	// goal's keys have to be known before actual values are read
+	if(GoalPredicate)
+	{
+		for(const FGOAPWorldStateKey& Key : GoalPredicate->Keys)
+		{
+			InternKey(Key);
+		}
+	}
+
+	ReadInitialState();
+	if(!GoalPredicate)
+		return;
+
+	Problem.Junction = GoalPredicate->Junction;
+	CompileConditions(*GoalPredicate, Problem.Conditions);
+}
+
+void UGOAPSolver::FinalizeProblem(const TArray<const FGOAPGoalPredicate*>& GoalsPredicates,
+	const TArray<float>& Scores)
+{
+	// goals' keys have to be known before actual values are read
+	for(const FGOAPGoalPredicate* GoalPredicate : GoalsPredicates)
+	{
+		for(const FGOAPWorldStateKey& Key : GoalPredicate->Keys)
+		{
+			InternKey(Key);
+		}
+	}
+
+	ReadInitialState();
+	for(int32 GoalIndex = 0; GoalIndex < GoalsPredicates.Num(); ++GoalIndex)
+	{
+		FGOAPCoreGoal& Goal = Problem.Goals.AddDefaulted_GetRef();
+		Goal.Junction = GoalsPredicates[GoalIndex]->Junction;
+		Goal.Score = Scores.IsValidIndex(GoalIndex) ? Scores[GoalIndex] : 0.0f;
+		CompileConditions(*GoalsPredicates[GoalIndex], Goal.Conditions);
+	}
+}
+
+void UGOAPSolver::ReadInitialState()
+{
+	// reading actual values can add new values, but not new keys
+	Problem.InitialState.SetNumUninitialized(ProblemKeys.Num());
+	for(int32 KeyIndex = 0; KeyIndex < ProblemKeys.Num(); ++KeyIndex)
+	{
+		Problem.InitialState[KeyIndex] = InternValue(QueryWorldStateValue(ProblemKeys[KeyIndex]).Payload);
+	}
+}
+
+void UGOAPSolver::CompileConditions(const FGOAPGoalPredicate& GoalPredicate,
+	TArray<FGOAPCoreCondition>& OutConditions)
+{
+	// conditions are evaluated for each known value once, so searches only compare indexes
+	for(const FGOAPGoalPredicate::FInstruction& Instruction : GoalPredicate.Instructions)
+	{
+		FGOAPCoreCondition& Condition = OutConditions.AddDefaulted_GetRef();
+		Condition.Key = InternKey(GoalPredicate.Keys[Instruction.KeyIndex]);
+		Condition.SatisfyingValues.Init(false, ProblemValues.Num());
+		for(int32 ValueIndex = 0; ValueIndex < ProblemValues.Num(); ++ValueIndex)
+		{
+			Condition.SatisfyingValues[ValueIndex] = FGOAPGoalPredicate::EvaluateInstruction(Instruction,
+				ProblemValues[ValueIndex]);
+		}
+	}
 }
 
+TArray<FGOAPActionWithTargetData> UGOAPSolver::TranslatePlan(const FGOAPCoreSearchResult& Result) const
+{
+	TArray<FGOAPActionWithTargetData> Plan;
+	Plan.Reserve(Result.Plan.Num());
+	for(const int32 ActionIndex : Result.Plan)
+	{
+		const FGOAPCoreAction& Action = Problem.Actions[ActionIndex];
+		Plan.Add(FGOAPActionWithTargetData(GetPlanningActions()[Action.ActionIndex], GetFactWorldState(Action.Effect)));
+	}
+	return Plan;
+}
+
+const FGOAPGoalPredicate& UGOAPSolver::GetGoalPredicate(UGOAPGoal* Goal, int32 GoalIndex) const
+{
+	if(ReplayedRecording)
+		return ReplayedRecording->GetReplayPredicate(GoalIndex);
+
+	const FGOAPGoalPredicate& Predicate = Goal->GetDesiredPredicate();
+	if(ActiveRecording.IsValid())
+	{
+		ActiveRecording->RecordGoalPredicate(Predicate);
+	}
+	return Predicate;
+}
+
+FGOAPWorldStateValue UGOAPSolver::QueryWorldStateValue(const FGOAPWorldStateKey& Key) const
+{
+	FGOAPWorldStateValue Value;
+	if(ReplayedRecording)
+	{
+		ReplayedRecording->FindWorldStateValue(Key, Value);
+		return Value;
+	}
+	
+	Value = UGOAPWorldStateFunctionLibrary::GetActualWorldStateValue(Key, TArray<FGOAPWorldStateData>());
+	if(ActiveRecording.IsValid())
+	{
+		ActiveRecording->RecordWorldStateValue(Key, Value);
+	}
+	return Value;
+}
+
+bool UGOAPSolver::QueryIsWorldStateActual(const FGOAPWorldStateData& DesiredWorldState) const
+{
+	return DesiredWorldState.WorldStateValue.Payload->IsEqual(QueryWorldStateValue(DesiredWorldState.WorldStateKey).Payload);
+}
+
+bool UGOAPSolver::QueryCanChangeWorldState(UObject* Action, const FGOAPWorldStateData& DesiredWorldState) const
+{
+	bool bResult = false;
+	if(ReplayedRecording)
+	{
+		ReplayedRecording->FindCanChangeWorldState(Action, DesiredWorldState, bResult);
+		return bResult;
+	}
+
+	{
+		GOAP_HOOK_SCOPE(Action, ActionCanChangeWorldState);
+		bResult = IGOAPAction::Execute_CanChangeWorldState(Action, DesiredWorldState, PlanningAgent);
+	}
+	if(ActiveRecording.IsValid())
+	{
+		ActiveRecording->RecordCanChangeWorldState(Action, DesiredWorldState, bResult);
+	}
+	return bResult;
+}
+
+TArray<FGOAPWorldStateData> UGOAPSolver::QueryPreconditions(UObject* Action,
+	const FGOAPWorldStateData& ForDesiredWorldState) const
+{
+	TArray<FGOAPWorldStateData> Preconditions;
+	if(ReplayedRecording)
+	{
+		ReplayedRecording->FindPreconditions(Action, ForDesiredWorldState, Preconditions);
+		return Preconditions;
+	}
+
+	{
+		GOAP_HOOK_SCOPE(Action, ActionPreconditions);
+		Preconditions = IGOAPAction::Execute_GetWorldStatePreconditions(Action, ForDesiredWorldState, PlanningAgent);
+	}
+	if(ActiveRecording.IsValid())
+	{
+		ActiveRecording->RecordPreconditions(Action, ForDesiredWorldState, Preconditions);
+	}
+	return Preconditions;
+}
+
+int32 UGOAPSolver::QueryActionCost(UObject* Action, const FGOAPWorldStateData& DesiredWorldState,
+	const TArray<FGOAPWorldStateData>& WithCurrentWorldState) const
+{
+	int32 Cost = 0;
+	if(ReplayedRecording)
+	{
+		ReplayedRecording->FindActionCost(Action, DesiredWorldState, WithCurrentWorldState, Cost);
+		return Cost;
+	}
+
+	{
+		GOAP_HOOK_SCOPE(Action, ActionCost);
+		Cost = IGOAPAction::Execute_GetActionCost(Action, DesiredWorldState, PlanningAgent, WithCurrentWorldState);
+	}
+	if(ActiveRecording.IsValid())
+	{
+		ActiveRecording->RecordActionCost(Action, DesiredWorldState, WithCurrentWorldState, Cost);
+	}
+	return Cost;
+}
+
+int32 UGOAPSolver::QueryPlanCost(const TArray<FGOAPActionWithTargetData>& Plan) const
+{
+	int32 Cost = 0;
+	for(const FGOAPActionWithTargetData& Step : Plan)
+	{
+		Cost += QueryActionCost(Step.Action, Step.TargetData, TArray<FGOAPWorldStateData>());
+	}
+	return Cost;
+}
+
+bool UGOAPSolver::QueryActionEffect(UObject* Action, AActor* ContextActor,
+	FGOAPWorldStateData& OutEffectWorldState) const
+{
+	bool bResult = false;
+	if(ReplayedRecording)
+	{
+		ReplayedRecording->FindActionEffect(Action, ContextActor, bResult, OutEffectWorldState);
+		return bResult;
+	}
+
+	{
+		GOAP_HOOK_SCOPE(Action, ActionEffect);
+		bResult = IGOAPAction::Execute_GetActionEffectWithContextActor(Action, PlanningAgent, ContextActor,
+			OutEffectWorldState);
+	}
+	if(ActiveRecording.IsValid())
+	{
+		ActiveRecording->RecordActionEffect(Action, ContextActor, bResult, OutEffectWorldState);
+	}
+	return bResult;
+}
@@ -0,0 +1,149 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPSolverStatistics.h"
+
+#include "GOAPSolver.h"
+#include "GOAPTypes.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/BufferArchive.h"
+#include "Serialization/MemoryReader.h"
+
+namespace GOAPSolverStatistics
+{
+	/** Identifies statistics files. */
+	static constexpr uint32 FileMagic = 0x53534F47; // "GOSS"
+	/** Increase when file format (or meaning of recorded values) changes. Version 2 - real plan costs. */
+	static constexpr int32 FileVersion = 2;
+
+	/** Records by goal class path and solver class path. */
+	static TMap<FString, TMap<FString, FGOAPSolverRecord>> Records;
+	/** True if Records were loaded from file (or file doesn't exist). */
+	static bool bLoaded = false;
+	/** True if Records changed since they were loaded or saved. */
+	static bool bDirty = false;
+
+	/** Load Records from file if they aren't loaded yet. */
+	static void EnsureLoaded()
+	{
+		if(bLoaded)
+			return;
+
+		bLoaded = true;
+		TArray<uint8> Buffer;
+		if(!FFileHelper::LoadFileToArray(Buffer, *FGOAPSolverStatistics::GetFilePath(), FILEREAD_Silent))
+			return;
+
+		FMemoryReader Reader(Buffer);
+		uint32 Magic = 0;
+		int32 Version = 0;
+		Reader << Magic << Version;
+		if(Magic != FileMagic || Version != FileVersion)
+		{
+			UE_LOG(LogGOAP, Warning, TEXT("Not supported solver statistics format, statistics are gathered again."));
+			return;
+		}
+		Reader << Records;
+		if(Reader.IsError())
+		{
+			UE_LOG(LogGOAP, Warning, TEXT("Solver statistics file is corrupted, statistics are gathered again."));
+			Records.Reset();
+		}
+	}
+
+	static FAutoConsoleCommandWithOutputDevice DumpCommand(
+		TEXT("GOAP.SolverStatistics.Dump"),
+		TEXT("Print searches statistics of each solver for each goal class (used by adaptive solver)."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FGOAPSolverStatistics::Dump));
+
+	static FAutoConsoleCommand SaveCommand(
+		TEXT("GOAP.SolverStatistics.Save"),
+		TEXT("Save solvers statistics now (they are also saved on exit)."),
+		FConsoleCommandDelegate::CreateLambda([]() { FGOAPSolverStatistics::Save(); }));
+
+	static FAutoConsoleCommand ResetCommand(
+		TEXT("GOAP.SolverStatistics.Reset"),
+		TEXT("Remove solvers statistics, so adaptive solver learns again."),
+		FConsoleCommandDelegate::CreateStatic(&FGOAPSolverStatistics::Reset));
+}
+
+void FGOAPSolverStatistics::RecordSearch(const UClass* GoalClass, const UClass* SolverClass,
+	const FGOAPSearchStats& Stats)
+{
+	if(!GoalClass || !SolverClass)
+		return;
+
+	GOAPSolverStatistics::EnsureLoaded();
+	FGOAPSolverRecord& Record = GOAPSolverStatistics::Records.FindOrAdd(GoalClass->GetPathName()).FindOrAdd(
+		SolverClass->GetPathName());
+	++Record.SearchesNum;
+	Record.PlansNum += Stats.PlanLength > 0 ? 1 : 0;
+	Record.SearchTime += Stats.SearchTime;
+	Record.NodesExpanded += Stats.NodesExpanded;
+	Record.PlanCost += Stats.PlanCost;
+	GOAPSolverStatistics::bDirty = true;
+}
+
+const FGOAPSolverRecord* FGOAPSolverStatistics::FindRecord(const UClass* GoalClass, const UClass* SolverClass)
+{
+	if(!GoalClass || !SolverClass)
+		return nullptr;
+
+	GOAPSolverStatistics::EnsureLoaded();
+	const TMap<FString, FGOAPSolverRecord>* GoalRecords = GOAPSolverStatistics::Records.Find(GoalClass->GetPathName());
+	return GoalRecords ? GoalRecords->Find(SolverClass->GetPathName()) : nullptr;
+}
+
+bool FGOAPSolverStatistics::Save()
+{
+	if(!GOAPSolverStatistics::bDirty)
+		return true;
+
+	FBufferArchive Buffer;
+	uint32 Magic = GOAPSolverStatistics::FileMagic;
+	int32 Version = GOAPSolverStatistics::FileVersion;
+	Buffer << Magic << Version;
+	Buffer << GOAPSolverStatistics::Records;
+	if(!FFileHelper::SaveArrayToFile(Buffer, *GetFilePath()))
+	{
+		UE_LOG(LogGOAP, Error, TEXT("Can't save solver statistics to %s!"), *GetFilePath());
+		return false;
+	}
+	GOAPSolverStatistics::bDirty = false;
+	return true;
+}
+
+void FGOAPSolverStatistics::Reset()
+{
+	GOAPSolverStatistics::Records.Reset();
+	GOAPSolverStatistics::bLoaded = true;
+	GOAPSolverStatistics::bDirty = true;
+}
+
+void FGOAPSolverStatistics::Dump(FOutputDevice& Ar)
+{
+	GOAPSolverStatistics::EnsureLoaded();
+	Ar.Logf(TEXT("GOAP solver statistics (%s):"), *GetFilePath());
+	for(const TPair<FString, TMap<FString, FGOAPSolverRecord>>& GoalRecords : GOAPSolverStatistics::Records)
+	{
+		Ar.Logf(TEXT("%s:"), *FPackageName::ObjectPathToObjectName(GoalRecords.Key));
+		for(const TPair<FString, FGOAPSolverRecord>& SolverRecord : GoalRecords.Value)
+		{
+			const FGOAPSolverRecord& Record = SolverRecord.Value;
+			const int32 SearchesNum = FMath::Max(Record.SearchesNum, 1);
+			Ar.Logf(TEXT("    %s - searches %d, plans %d, time per plan %.3f ms, mean nodes expanded %.1f, "
+				"mean plan cost %.1f"), *FPackageName::ObjectPathToObjectName(SolverRecord.Key), Record.SearchesNum,
+				Record.PlansNum, Record.PlansNum > 0 ? Record.GetTimePerPlan() * 1000.0 : 0.0,
+				static_cast<double>(Record.NodesExpanded) / SearchesNum,
+				Record.PlansNum > 0 ? Record.GetCostPerPlan() : 0.0);
+		}
+	}
+}
+
+FString FGOAPSolverStatistics::GetFilePath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("GOAP"), TEXT("SolverStatistics.bin"));
+}
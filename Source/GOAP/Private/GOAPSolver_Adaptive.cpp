@@ -0,0 +1,112 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPSolver_Adaptive.h"
+
+#include "GOAPGoal.h"
+#include "GOAPAction.h"
+#include "GOAPStats.h"
+#include "GOAPSolverStatistics.h"
+#include "GOAPSolver_Backward.h"
+#include "GOAPSolver_Bidirectional.h"
+#include "GOAPSolver_Forward.h"
+
+UGOAPSolver_Adaptive::UGOAPSolver_Adaptive()
+{
+	SolversClasses.Add(UGOAPSolver_Backward::StaticClass());
+	SolversClasses.Add(UGOAPSolver_Forward::StaticClass());
+	SolversClasses.Add(UGOAPSolver_Bidirectional::StaticClass());
+}
+
+void UGOAPSolver_Adaptive::InitializeSolver(UGOAPPlanner* ForPlanner)
+{
+	Super::InitializeSolver(ForPlanner);
+
+	Solvers.Reset();
+	for(const TSubclassOf<UGOAPSolver>& SolverClass : SolversClasses)
+	{
+		if(!IsValid(SolverClass) || SolverClass->HasAnyClassFlags(CLASS_Abstract) ||
+			SolverClass->IsChildOf(UGOAPSolver_Adaptive::StaticClass()))
+		{
+			UE_LOG(LogGOAP, Warning, TEXT("Adaptive solver %s skips invalid solver class!"), *GetName());
+			continue;
+		}
+
+		UGOAPSolver* Solver = NewObject<UGOAPSolver>(this, SolverClass);
+		Solver->InitializeSolver(ForPlanner);
+		Solvers.Add(Solver);
+	}
+}
+
+TArray<FGOAPActionWithTargetData> UGOAPSolver_Adaptive::FindPlanForGoal(UGOAPGoal* Goal)
+{
+	LLM_SCOPE_BYTAG(GOAP_Solver);
+
+	// solvers are created by InitializeSolver, so adaptive solver can't replay recordings (its solvers record their
+	// own searches)
+	if(!Goal || Solvers.Num() == 0)
+	{
+		return TArray<FGOAPActionWithTargetData>();
+	}
+
+	LastSolver = SelectSolver(Goal);
+	UE_LOG(LogGOAP, Log, TEXT("Adaptive solver selected %s for goal: %s"), *LastSolver->GetClass()->GetName(),
+		*Goal->GetName());
+	TArray<FGOAPActionWithTargetData> Plan = LastSolver->FindPlanForGoal(Goal);
+
+	// solvers can search with simplified costs, so plans are compared by their real costs
+	LastSearchStats = LastSolver->GetLastSearchStats();
+	LastSearchStats.PlanCost = QueryPlanCost(Plan);
+	FGOAPSolverStatistics::RecordSearch(Goal->GetClass(), LastSolver->GetClass(), LastSearchStats);
+	return Plan;
+}
+
+UGOAPSolver* UGOAPSolver_Adaptive::SelectSolver(const UGOAPGoal* Goal) const
+{
+	// search time per found plan (solver which often doesn't find plan isn't fast) and mean real plan cost rank
+	// solvers, both relative to the best solver
+	UGOAPSolver* LeastTriedSolver = nullptr;
+	int32 LeastSearchesNum = MAX_int32;
+	double BestTimePerPlan = MAX_dbl;
+	double BestCostPerPlan = MAX_dbl;
+	TArray<const FGOAPSolverRecord*, TInlineAllocator<4>> Records;
+	for(UGOAPSolver* Solver : Solvers)
+	{
+		const FGOAPSolverRecord* Record = FGOAPSolverStatistics::FindRecord(Goal->GetClass(), Solver->GetClass());
+		Records.Add(Record);
+		const int32 SearchesNum = Record ? Record->SearchesNum : 0;
+		if(SearchesNum < LeastSearchesNum)
+		{
+			LeastTriedSolver = Solver;
+			LeastSearchesNum = SearchesNum;
+		}
+		if(Record && Record->PlansNum > 0)
+		{
+			BestTimePerPlan = FMath::Min(BestTimePerPlan, Record->GetTimePerPlan());
+			BestCostPerPlan = FMath::Min(BestCostPerPlan, Record->GetCostPerPlan());
+		}
+	}
+
+	if(LeastSearchesNum < MinSearchesPerSolver || BestTimePerPlan == MAX_dbl)
+		return LeastTriedSolver;
+	if(FMath::FRand() < ExplorationRate)
+		return Solvers[FMath::RandRange(0, Solvers.Num() - 1)];
+
+	UGOAPSolver* BestSolver = nullptr;
+	double BestRank = MAX_dbl;
+	for(int32 SolverIndex = 0; SolverIndex < Solvers.Num(); ++SolverIndex)
+	{
+		const FGOAPSolverRecord* Record = Records[SolverIndex];
+		if(!Record || Record->PlansNum == 0)
+			continue;
+
+		const double Rank = Record->GetTimePerPlan() / FMath::Max(BestTimePerPlan, UE_DOUBLE_SMALL_NUMBER) +
+			PlanCostWeight * Record->GetCostPerPlan() / FMath::Max(BestCostPerPlan, 1.0);
+		if(Rank < BestRank)
+		{
+			BestSolver = Solvers[SolverIndex];
+			BestRank = Rank;
+		}
+	}
+	return BestSolver;
+}
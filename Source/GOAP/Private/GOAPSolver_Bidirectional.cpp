@@ -0,0 +1,44 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPSolver_Bidirectional.h"
+
+#include "GOAPGoal.h"
+#include "GOAPAction.h"
+
+bool UGOAPSolver_Bidirectional::BuildProblemForGoal(UGOAPGoal* Goal)
+{
+	// goal which can't be regressed (not met non equality conditions) is searched only forward
+	const auto WorldStateReader = [this](const FGOAPWorldStateKey& Key) { return QueryWorldStateValue(Key); };
+	const FGOAPGoalPredicate& GoalPredicate = GetGoalPredicate(Goal);
+	BuildProblem(GoalPredicate, GoalPredicate.GetRegressionTargets(WorldStateReader));
+	return true;
+}
+
+void UGOAPSolver_Bidirectional::SearchProblem(FGOAPCoreSearchResult& OutResult) const
+{
+	PlanningCore.SearchBidirectional(Problem, OutResult);
+}
+
+void UGOAPSolver_Bidirectional::BuildProblem(const FGOAPGoalPredicate& GoalPredicate,
+	const TArray<TArray<FGOAPWorldStateData>>& RegressionTargets)
+{
+	ResetProblem();
+
+	// check all available actions on each context actor
+	AddActionsOnContextActors(false);
+	for(int32 ProblemActionIndex = 0; ProblemActionIndex < Problem.Actions.Num(); ++ProblemActionIndex)
+	{
+		Problem.Producers.FindOrAdd(Problem.Actions[ProblemActionIndex].Effect).Add(ProblemActionIndex);
+	}
+
+	for(const TArray<FGOAPWorldStateData>& DesiredWorldStates : RegressionTargets)
+	{
+		TArray<FGOAPCoreFact>& DesiredFacts = Problem.RegressionTargets.AddDefaulted_GetRef();
+		for(const FGOAPWorldStateData& DesiredWorldState : DesiredWorldStates)
+		{
+			DesiredFacts.Add(InternFact(DesiredWorldState));
+		}
+	}
+	FinalizeProblem(&GoalPredicate);
+}
@@ -0,0 +1,26 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPSolver_IterativeDeepening.h"
+
+#include "GOAPGoal.h"
+
+bool UGOAPSolver_IterativeDeepening::BuildProblemForGoal(UGOAPGoal* Goal)
+{
+	BuildProblem(GetGoalPredicate(Goal));
+	return true;
+}
+
+void UGOAPSolver_IterativeDeepening::SearchProblem(FGOAPCoreSearchResult& OutResult) const
+{
+	PlanningCore.SearchIterativeDeepening(Problem, OutResult);
+}
+
+void UGOAPSolver_IterativeDeepening::BuildProblem(const FGOAPGoalPredicate& GoalPredicate)
+{
+	ResetProblem();
+
+	// check all available actions on each context actor
+	AddActionsOnContextActors(false);
+	FinalizeProblem(&GoalPredicate);
+}
@@ -0,0 +1,140 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPSolver_Portfolio.h"
+
+#include "GOAPGoal.h"
+#include "GOAPAction.h"
+#include "GOAPStats.h"
+#include "GOAPSolver_Backward.h"
+#include "GOAPSolver_Forward.h"
+#include "Async/ParallelFor.h"
+
+UGOAPSolver_Portfolio::UGOAPSolver_Portfolio()
+{
+	SolversClasses.Add(UGOAPSolver_Forward::StaticClass());
+	SolversClasses.Add(UGOAPSolver_Backward::StaticClass());
+}
+
+void UGOAPSolver_Portfolio::InitializeSolver(UGOAPPlanner* ForPlanner)
+{
+	Super::InitializeSolver(ForPlanner);
+
+	Solvers.Reset();
+	for(const TSubclassOf<UGOAPSolver>& SolverClass : SolversClasses)
+	{
+		// portfolio can't race itself
+		if(!IsValid(SolverClass) || SolverClass->HasAnyClassFlags(CLASS_Abstract) ||
+			SolverClass->IsChildOf(UGOAPSolver_Portfolio::StaticClass()))
+		{
+			UE_LOG(LogGOAP, Warning, TEXT("Portfolio solver %s skips invalid solver class!"), *GetName());
+			continue;
+		}
+
+		UGOAPSolver* Solver = NewObject<UGOAPSolver>(this, SolverClass);
+		Solver->InitializeSolver(ForPlanner);
+		Solvers.Add(Solver);
+	}
+}
+
+TArray<FGOAPActionWithTargetData> UGOAPSolver_Portfolio::FindPlanForGoal(UGOAPGoal* Goal)
+{
+	LLM_SCOPE_BYTAG(GOAP_Solver);
+
+	// solvers are created by InitializeSolver, so portfolio can't replay recordings
+	if(!Goal || Solvers.Num() == 0)
+	{
+		return TArray<FGOAPActionWithTargetData>();
+	}
+
+	UE_LOG(LogGOAP, Log, TEXT("Start looking for solution for goal: %s (portfolio planning)"), *Goal->GetName());
+	// solvers record their own searches
+	BeginSearch(Goal, false);
+	LastWinner = nullptr;
+
+	// all problems are grounded before any search starts, so searches share the same world state
+	TArray<UGOAPSolver*> RacingSolvers;
+	for(UGOAPSolver* Solver : Solvers)
+	{
+		Solver->BeginSearch(Goal);
+		if(Solver->BuildProblemForGoal(Goal))
+		{
+			RacingSolvers.Add(Solver);
+		}
+		else
+		{
+			UE_LOG(LogGOAP, Warning, TEXT("Solver %s can't be used by portfolio solver!"), *Solver->GetName());
+			Solver->FinishSearch(FGOAPCoreSearchResult());
+		}
+	}
+
+	// the first plan cancels other searches at once or brings their deadline forward
+	FGOAPSearchCancellation Cancellation;
+	Cancellation.Deadline = FPlatformTime::Seconds() + MaxSearchTime;
+	std::atomic<int32> FirstPlanIndex{INDEX_NONE};
+	TArray<FGOAPCoreSearchResult> Results;
+	Results.SetNum(RacingSolvers.Num());
+	for(UGOAPSolver* Solver : RacingSolvers)
+	{
+		Solver->PlanningCore.Cancellation = &Cancellation;
+	}
+	ParallelFor(RacingSolvers.Num(), [&](int32 SolverIndex)
+	{
+		RacingSolvers[SolverIndex]->SearchProblem(Results[SolverIndex]);
+		int32 NoPlanIndex = INDEX_NONE;
+		if(Results[SolverIndex].Plan.Num() > 0 && FirstPlanIndex.compare_exchange_strong(NoPlanIndex, SolverIndex))
+		{
+			if(BestPlanTimeBudget > 0.0f)
+			{
+				Cancellation.Deadline = FMath::Min(Cancellation.Deadline.load(),
+					FPlatformTime::Seconds() + BestPlanTimeBudget);
+			}
+			else
+			{
+				Cancellation.bCanceled = true;
+			}
+		}
+	}, EParallelForFlags::Unbalanced);
+
+	// of plans found in time budget the cheapest one wins (the first one of equal costs); solvers' costs models
+	// differ, so plans are compared by real actions' costs
+	int32 WinnerIndex = FirstPlanIndex;
+	int32 WinnerCost = MAX_int32;
+	TArray<FGOAPActionWithTargetData> Plan;
+	for(int32 SolverIndex = 0; SolverIndex < RacingSolvers.Num(); ++SolverIndex)
+	{
+		UGOAPSolver* Solver = RacingSolvers[SolverIndex];
+		Solver->PlanningCore.Cancellation = nullptr;
+		if(Results[SolverIndex].Plan.Num() > 0 && (SolverIndex == FirstPlanIndex || BestPlanTimeBudget > 0.0f))
+		{
+			TArray<FGOAPActionWithTargetData> SolverPlan = Solver->TranslatePlan(Results[SolverIndex]);
+			const int32 SolverCost = QueryPlanCost(SolverPlan);
+			const bool bFirstWins = SolverCost == WinnerCost && FirstPlanIndex == SolverIndex;
+			if(SolverCost < WinnerCost || bFirstWins)
+			{
+				WinnerIndex = SolverIndex;
+				WinnerCost = SolverCost;
+				Plan = MoveTemp(SolverPlan);
+			}
+		}
+		Solver->FinishSearch(Results[SolverIndex]);
+
+		// portfolio's statistics sum work of all searches (they run at once), plan's ones are winner's
+		LastSearchStats.NodesExpanded += Solver->GetLastSearchStats().NodesExpanded;
+		LastSearchStats.NodesGenerated += Solver->GetLastSearchStats().NodesGenerated;
+		LastSearchStats.NodesDeduplicated += Solver->GetLastSearchStats().NodesDeduplicated;
+		LastSearchStats.SearchMemory += Solver->GetLastSearchStats().SearchMemory;
+	}
+
+	if(WinnerIndex != INDEX_NONE)
+	{
+		LastWinner = RacingSolvers[WinnerIndex];
+		int32& WinsNum = WinsPerGoalClass.FindOrAdd(Goal->GetClass()->GetFName()).WinsPerSolver.FindOrAdd(
+			LastWinner->GetClass()->GetFName());
+		++WinsNum;
+		UE_LOG(LogGOAP, Log, TEXT("Portfolio won by %s (cost %d, %d wins for goal %s)"),
+			*LastWinner->GetClass()->GetName(), WinnerCost, WinsNum, *Goal->GetClass()->GetName());
+	}
+	FinishSearch(Plan.Num(), WinnerIndex != INDEX_NONE ? WinnerCost : 0);
+	return Plan;
+}
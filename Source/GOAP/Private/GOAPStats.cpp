@@ -0,0 +1,27 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPStats.h"
+
+DEFINE_STAT(STAT_GOAP_GoalsScoring);
+DEFINE_STAT(STAT_GOAP_FindPlan);
+DEFINE_STAT(STAT_GOAP_ExpandNode);
+DEFINE_STAT(STAT_GOAP_Heuristic);
+DEFINE_STAT(STAT_GOAP_SelectNode);
+DEFINE_STAT(STAT_GOAP_PrepareSolutions);
+DEFINE_STAT(STAT_GOAP_PickBestSolution);
+DEFINE_STAT(STAT_GOAP_AtomUpdate);
+DEFINE_STAT(STAT_GOAP_PlanExecution);
+DEFINE_STAT(STAT_GOAP_SchedulerUpdate);
+
+DEFINE_STAT(STAT_GOAP_Searches);
+DEFINE_STAT(STAT_GOAP_NodesExpanded);
+DEFINE_STAT(STAT_GOAP_NodesGenerated);
+DEFINE_STAT(STAT_GOAP_NodesDeduplicated);
+DEFINE_STAT(STAT_GOAP_SchedulerQueueDepth);
+
+LLM_DEFINE_TAG(GOAP);
+LLM_DEFINE_TAG(GOAP_Solver, TEXT("Solver"), TEXT("GOAP"));
+LLM_DEFINE_TAG(GOAP_Payloads, TEXT("Payloads"), TEXT("GOAP"));
+LLM_DEFINE_TAG(GOAP_Memory, TEXT("Memory"), TEXT("GOAP"));
+LLM_DEFINE_TAG(GOAP_Plans, TEXT("Plans"), TEXT("GOAP"));
@@ -0,0 +1,78 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPTrace.h"
+
+#if GOAP_TRACE_ENABLED
+
+#include "GOAPSolver.h"
+#include "Trace/Trace.inl"
+
+UE_TRACE_CHANNEL_DEFINE(GOAPChannel)
+
+UE_TRACE_EVENT_BEGIN(GOAP, SearchStarted)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, SolverId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, SolverClass)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Goal)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(GOAP, NodeVisited)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, SolverId)
+	UE_TRACE_EVENT_FIELD(int32, VisitedNodesNum)
+	UE_TRACE_EVENT_FIELD(int32, Cost)
+	UE_TRACE_EVENT_FIELD(int32, Heuristic)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(GOAP, SearchFinished)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, SolverId)
+	UE_TRACE_EVENT_FIELD(int32, NodesExpanded)
+	UE_TRACE_EVENT_FIELD(int32, NodesGenerated)
+	UE_TRACE_EVENT_FIELD(int32, NodesDeduplicated)
+	UE_TRACE_EVENT_FIELD(int32, PlanLength)
+	UE_TRACE_EVENT_FIELD(int32, PlanCost)
+	UE_TRACE_EVENT_FIELD(double, SearchTime)
+UE_TRACE_EVENT_END()
+
+bool FGOAPTrace::IsEnabled()
+{
+	return UE_TRACE_CHANNELEXPR_IS_ENABLED(GOAPChannel);
+}
+
+void FGOAPTrace::OutputSearchStarted(const UObject* Solver, const UObject* Goal)
+{
+	const FString SolverClass = Solver->GetClass()->GetName();
+	const FString GoalName = Goal ? Goal->GetName() : FString();
+	UE_TRACE_LOG(GOAP, SearchStarted, GOAPChannel)
+		<< SearchStarted.Cycle(FPlatformTime::Cycles64())
+		<< SearchStarted.SolverId(Solver->GetUniqueID())
+		<< SearchStarted.SolverClass(*SolverClass, SolverClass.Len())
+		<< SearchStarted.Goal(*GoalName, GoalName.Len());
+}
+
+void FGOAPTrace::OutputNodeVisited(const UObject* Solver, int32 VisitedNodesNum, int32 Cost, int32 Heuristic)
+{
+	UE_TRACE_LOG(GOAP, NodeVisited, GOAPChannel)
+		<< NodeVisited.Cycle(FPlatformTime::Cycles64())
+		<< NodeVisited.SolverId(Solver->GetUniqueID())
+		<< NodeVisited.VisitedNodesNum(VisitedNodesNum)
+		<< NodeVisited.Cost(Cost)
+		<< NodeVisited.Heuristic(Heuristic);
+}
+
+void FGOAPTrace::OutputSearchFinished(const UObject* Solver, const FGOAPSearchStats& Stats)
+{
+	UE_TRACE_LOG(GOAP, SearchFinished, GOAPChannel)
+		<< SearchFinished.Cycle(FPlatformTime::Cycles64())
+		<< SearchFinished.SolverId(Solver->GetUniqueID())
+		<< SearchFinished.NodesExpanded(Stats.NodesExpanded)
+		<< SearchFinished.NodesGenerated(Stats.NodesGenerated)
+		<< SearchFinished.NodesDeduplicated(Stats.NodesDeduplicated)
+		<< SearchFinished.PlanLength(Stats.PlanLength)
+		<< SearchFinished.PlanCost(Stats.PlanCost)
+		<< SearchFinished.SearchTime(Stats.SearchTime);
+}
+
+#endif
@@ -0,0 +1,118 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPUtilityScoring.h"
+
+#include "GOAPAgent.h"
+#include "GOAPGoal.h"
+#include "GOAPWorldStateFunctionLibrary.h"
+#include "GOAPWorldStatePayloads.h"
+
+void FGOAPUtilityScoringBatch::Reset()
+{
+	Inputs.Reset();
+	InputsMin.Reset();
+	InputsInvRange.Reset();
+	Slopes.Reset();
+	Exponents.Reset();
+	XShifts.Reset();
+	YShifts.Reset();
+	Weights.Reset();
+	CurveTypes.Reset();
+	CustomCurves.Reset();
+	GoalsFirstConsideration.Reset();
+}
+
+int32 FGOAPUtilityScoringBatch::AddGoal(UGOAPGoal* Goal)
+{
+	AActor* Agent = Cast<AActor>(Goal->AgentActor.GetObject());
+	return AddGoal(Goal->GetUtilityConsiderations(), [Agent](const FGameplayTag& WorldStateTag, double& OutValue)
+	{
+		const FGOAPWorldStateValue Value = UGOAPWorldStateFunctionLibrary::GetActualWorldStateValue(
+			FGOAPWorldStateKey(Agent, WorldStateTag), TArray<FGOAPWorldStateData>());
+		return Value.Payload && Value.Payload->GetNumericValue(OutValue);
+	});
+}
+
+int32 FGOAPUtilityScoringBatch::AddGoal(const TArray<FGOAPUtilityConsideration>& Considerations,
+	FGOAPUtilityInputReader InputReader)
+{
+	const int32 GoalIndex = GoalsFirstConsideration.Add(Inputs.Num());
+	
+	for(const FGOAPUtilityConsideration& Consideration : Considerations)
+	{
+		// missing or not numeric data is treated as min input
+		double InputValue;
+		if(!InputReader(Consideration.WorldStateTag, InputValue))
+		{
+			InputValue = Consideration.InputMin;
+		}
+
+		const float InputRange = Consideration.InputMax - Consideration.InputMin;
+		Inputs.Add(InputValue);
+		InputsMin.Add(Consideration.InputMin);
+		InputsInvRange.Add(FMath::IsNearlyZero(InputRange) ? 0.0f : 1.0f / InputRange);
+		Slopes.Add(Consideration.Slope);
+		Exponents.Add(Consideration.Exponent);
+		XShifts.Add(Consideration.XShift);
+		YShifts.Add(Consideration.YShift);
+		Weights.Add(Consideration.Weight);
+		CurveTypes.Add(Consideration.CurveType);
+		CustomCurves.Add(&Consideration.CustomCurve);
+	}
+	
+	return GoalIndex;
+}
+
+void FGOAPUtilityScoringBatch::Evaluate(TArray<float>& OutScores) const
+{
+	const int32 ConsiderationsNum = Inputs.Num();
+	TArray<float> Responses;
+	Responses.SetNumUninitialized(ConsiderationsNum);
+
+	// normalize inputs to <0,1>
+	for(int32 Index = 0; Index < ConsiderationsNum; ++Index)
+	{
+		Responses[Index] = FMath::Clamp((Inputs[Index] - InputsMin[Index]) * InputsInvRange[Index], 0.0f, 1.0f);
+	}
+
+	// apply response curves
+	for(int32 Index = 0; Index < ConsiderationsNum; ++Index)
+	{
+		const float X = Responses[Index] - XShifts[Index];
+		float Y;
+		switch(CurveTypes[Index])
+		{
+		case EGOAPResponseCurveType::Polynomial:
+			Y = Slopes[Index] * FMath::Pow(FMath::Max(X, 0.0f), Exponents[Index]) + YShifts[Index];
+			break;
+		case EGOAPResponseCurveType::Logistic:
+			Y = 1.0f / (1.0f + FMath::Exp(-Slopes[Index] * X)) + YShifts[Index];
+			break;
+		case EGOAPResponseCurveType::Custom:
+			Y = CustomCurves[Index]->GetRichCurveConst()->Eval(Responses[Index]);
+			break;
+		default:
+			Y = Slopes[Index] * X + YShifts[Index];
+			break;
+		}
+		Responses[Index] = FMath::Clamp(Y, 0.0f, 1.0f);
+	}
+
+	// combine considerations of each goal - weighted average of responses
+	OutScores.SetNumUninitialized(GoalsFirstConsideration.Num());
+	for(int32 GoalIndex = 0; GoalIndex < GoalsFirstConsideration.Num(); ++GoalIndex)
+	{
+		const int32 First = GoalsFirstConsideration[GoalIndex];
+		const int32 Last = GoalsFirstConsideration.IsValidIndex(GoalIndex+1) ?
+			GoalsFirstConsideration[GoalIndex+1] : ConsiderationsNum;
+		float WeightedSum = 0.0f;
+		float WeightsSum = 0.0f;
+		for(int32 Index = First; Index < Last; ++Index)
+		{
+			WeightedSum += Responses[Index] * Weights[Index];
+			WeightsSum += Weights[Index];
+		}
+		OutScores[GoalIndex] = WeightsSum > 0.0f ? WeightedSum / WeightsSum : 0.0f;
+	}
+}
@@ -3,8 +3,19 @@
 
 #include "GOAPWorldStateAtom.h"
 
+#include "GOAPWorldStateProvider.h"
+
 void UGOAPWorldStateAtom::UpdateWorldStateAtomData_Implementation()
 {
 	// have to be implemented
 	unimplemented();
+}
+
+void UGOAPWorldStateAtom::NotifyWorldStateChanged()
+{
+	// atoms are always created by provider
+	if(UGOAPWorldStateProvider* Provider = Cast<UGOAPWorldStateProvider>(GetOuter()))
+	{
+		Provider->NotifyWorldStateChanged(WorldStateAtomTag);
+	}
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 #include "GOAPWorldStateProvider.h"
 
+#include "GOAPHookProfiler.h"
+#include "GOAPStats.h"
+
 UGOAPWorldStateProvider::UGOAPWorldStateProvider()
 {
 	PrimaryComponentTick.bCanEverTick = false;
@@ -15,20 +18,43 @@ void UGOAPWorldStateProvider::BeginPlay()
 	// create atoms objects
 	for(auto AtomClass : WorldSateAtomsClasses)
 	{
-		if(!IsValid(AtomClass))
-			continue;
+		AddWorldStateAtom(AtomClass);
+	}
+}
 
-		UGOAPWorldStateAtom* NewAtom = NewObject<UGOAPWorldStateAtom>(this, AtomClass);
-		if(!NewAtom)
-		{
-			UE_LOG(LogGOAP, Error, TEXT("Cant create World State Atom of class %s!"), *AtomClass->GetName());
-			continue;
-		}
+UGOAPWorldStateAtom* UGOAPWorldStateProvider::AddWorldStateAtom(TSubclassOf<UGOAPWorldStateAtom> AtomClass)
+{
+	if(!IsValid(AtomClass))
+		return nullptr;
 
-		NewAtom->OwnerActor = GetOwner();
-		WorldSateAtoms.Add(NewAtom);
+	LLM_SCOPE_BYTAG(GOAP_Memory);
+	UGOAPWorldStateAtom* NewAtom = NewObject<UGOAPWorldStateAtom>(this, AtomClass);
+	if(!NewAtom)
+	{
+		UE_LOG(LogGOAP, Error, TEXT("Cant create World State Atom of class %s!"), *AtomClass->GetName());
+		return nullptr;
+	}
+
+	NewAtom->OwnerActor = GetOwner();
+	WorldSateAtoms.Add(NewAtom);
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_AtomUpdate);
+		GOAP_HOOK_SCOPE(NewAtom, AtomUpdate);
 		NewAtom->UpdateWorldStateAtomData();
 	}
+	return NewAtom;
+}
+
+UGOAPWorldStateAtom* UGOAPWorldStateProvider::GetWorldStateAtom(const FGameplayTag WorldStateAtomTag) const
+{
+	for(const auto Atom : WorldSateAtoms)
+	{
+		if(Atom->WorldStateAtomTag.MatchesTagExact(WorldStateAtomTag))
+		{
+			return Atom;
+		}
+	}
+	return nullptr;
 }
 
 bool UGOAPWorldStateProvider::HasWorldStateValue(const FGameplayTag WorldStateAtomTag)
@@ -45,9 +71,18 @@ FGOAPWorldStateValue UGOAPWorldStateProvider::GetWorldStateValue(const FGameplay
 	{
 		if(Atom->WorldStateAtomTag.MatchesTagExact(WorldStateAtomTag))
 		{
-			Atom->UpdateWorldStateAtomData();
+			SCOPE_CYCLE_COUNTER(STAT_GOAP_AtomUpdate);
+			{
+				GOAP_HOOK_SCOPE(Atom, AtomUpdate);
+				Atom->UpdateWorldStateAtomData();
+			}
 			return Atom->WorldStateValue;
 		}
 	}
 	return FGOAPWorldStateValue();
+}
+
+void UGOAPWorldStateProvider::NotifyWorldStateChanged(const FGameplayTag WorldStateAtomTag)
+{
+	OnWorldStateChanged.Broadcast(GetOwner(), WorldStateAtomTag);
 }
\ No newline at end of file
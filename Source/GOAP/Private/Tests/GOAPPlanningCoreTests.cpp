@@ -0,0 +1,195 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+
+#include "GOAPPlanningCore.h"
+#include "GOAPTypedSchema.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GOAPPlanningCoreTests
+{
+	/** Number of generated problems (fixed seeds, so failures can be reproduced). */
+	static constexpr int32 ProblemsNum = 50;
+	static constexpr int32 KeysNum = 4;
+	static constexpr int32 ValuesNum = 3;
+	static constexpr int32 ActionsNum = 8;
+	static constexpr int32 GoalFactsNum = 2;
+	/** Searches taking longer than this time (in seconds) are canceled and reported as failed. */
+	static constexpr double SearchTimeLimit = 10.0;
+
+	/**
+	 * Build small random problem - all keys start with value 0, actions set single key (with up to 2 preconditions on
+	 * other keys) and goal is conjunction of equalities. Each goal's fact has also action without preconditions, so
+	 * goal is always reachable (forward search doesn't end on not reachable goals).
+	 */
+	static void BuildProblem(int32 Seed, FGOAPPlanningProblem& OutProblem)
+	{
+		FRandomStream Random(Seed);
+		OutProblem.Reset();
+		OutProblem.InitialState.Init(0, KeysNum);
+		OutProblem.KeysActors.Init(0, KeysNum);
+
+		for(int32 ActionIndex = 0; ActionIndex < ActionsNum; ++ActionIndex)
+		{
+			FGOAPCoreAction& Action = OutProblem.Actions.AddDefaulted_GetRef();
+			Action.ActionIndex = ActionIndex;
+			Action.Effect = FGOAPCoreFact(Random.RandRange(0, KeysNum - 1), Random.RandRange(1, ValuesNum - 1));
+			Action.Cost = Random.RandRange(1, 3);
+			const int32 PreconditionsNum = Random.RandRange(0, 2);
+			for(int32 PreconditionIndex = 0; PreconditionIndex < PreconditionsNum; ++PreconditionIndex)
+			{
+				const FGOAPCoreFact Precondition(Random.RandRange(0, KeysNum - 1), Random.RandRange(0, ValuesNum - 1));
+				if(Precondition.Key != Action.Effect.Key && !Action.Preconditions.ContainsByPredicate(
+					[&Precondition](const FGOAPCoreFact& Fact) { return Fact.Key == Precondition.Key; }))
+				{
+					Action.Preconditions.Add(Precondition);
+				}
+			}
+		}
+
+		TArray<FGOAPCoreFact> GoalFacts;
+		for(int32 FactIndex = 0; FactIndex < GoalFactsNum; ++FactIndex)
+		{
+			const FGOAPCoreFact Fact(Random.RandRange(0, KeysNum - 1), Random.RandRange(1, ValuesNum - 1));
+			if(!GoalFacts.ContainsByPredicate([&Fact](const FGOAPCoreFact& Other) { return Other.Key == Fact.Key; }))
+			{
+				GoalFacts.Add(Fact);
+			}
+		}
+		for(const FGOAPCoreFact& Fact : GoalFacts)
+		{
+			FGOAPCoreAction& Action = OutProblem.Actions.AddDefaulted_GetRef();
+			Action.ActionIndex = OutProblem.Actions.Num() - 1;
+			Action.Effect = Fact;
+			Action.Cost = 4;
+
+			FGOAPCoreCondition& Condition = OutProblem.Conditions.AddDefaulted_GetRef();
+			Condition.Key = Fact.Key;
+			Condition.SatisfyingValues.Init(false, ValuesNum);
+			Condition.SatisfyingValues[Fact.Value] = true;
+		}
+		OutProblem.RegressionTargets.Add(GoalFacts);
+
+		for(int32 ActionIndex = 0; ActionIndex < OutProblem.Actions.Num(); ++ActionIndex)
+		{
+			OutProblem.Producers.FindOrAdd(OutProblem.Actions[ActionIndex].Effect).Add(ActionIndex);
+		}
+	}
+
+	/** Return cost of given plan applied from initial state or INDEX_NONE if plan isn't valid or doesn't reach goal. */
+	template<typename ProblemType>
+	static int32 GetPlanCost(const ProblemType& Problem, const TArray<int32>& Plan)
+	{
+		typename ProblemType::FState State = Problem.GetInitialState();
+		int32 Cost = 0;
+		for(const int32 ActionIndex : Plan)
+		{
+			if(!Problem.IsActionApplicable(State, ActionIndex))
+				return INDEX_NONE;
+
+			Problem.ApplyAction(State, ActionIndex);
+			Cost += Problem.GetActionCost(ActionIndex);
+		}
+		return Problem.GetUnsatisfiedConditionsNum(State) == 0 ? Cost : INDEX_NONE;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGOAPPlanningCoreSearchesTest, "GOAP.PlanningCore.Searches",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGOAPPlanningCoreSearchesTest::RunTest(const FString& Parameters)
+{
+	using namespace GOAPPlanningCoreTests;
+
+	FGOAPPlanningProblem Problem;
+	for(int32 Seed = 0; Seed < ProblemsNum; ++Seed)
+	{
+		BuildProblem(Seed, Problem);
+
+		FGOAPSearchCancellation Cancellation;
+		Cancellation.Deadline = FPlatformTime::Seconds() + SearchTimeLimit;
+		FGOAPPlanningCore PlanningCore;
+		PlanningCore.Cancellation = &Cancellation;
+
+		FGOAPCoreSearchResult ForwardResult;
+		FGOAPCoreSearchResult BackwardResult;
+		FGOAPCoreSearchResult BidirectionalResult;
+		FGOAPCoreSearchResult IterativeDeepeningResult;
+		PlanningCore.SearchForward(Problem, ForwardResult);
+		PlanningCore.SearchBackward(Problem, BackwardResult);
+		PlanningCore.SearchBidirectional(Problem, BidirectionalResult);
+		PlanningCore.SearchIterativeDeepening(Problem, IterativeDeepeningResult);
+
+		const int32 ForwardCost = GetPlanCost(Problem, ForwardResult.Plan);
+		const int32 BackwardCost = GetPlanCost(Problem, BackwardResult.Plan);
+		const int32 BidirectionalCost = GetPlanCost(Problem, BidirectionalResult.Plan);
+		const int32 IterativeDeepeningCost = GetPlanCost(Problem, IterativeDeepeningResult.Plan);
+		if(!TestTrue(FString::Printf(TEXT("Problem %d: forward plan is valid"), Seed), ForwardCost != INDEX_NONE) ||
+			!TestTrue(FString::Printf(TEXT("Problem %d: backward plan is valid"), Seed), BackwardCost != INDEX_NONE) ||
+			!TestTrue(FString::Printf(TEXT("Problem %d: bidirectional plan is valid"), Seed),
+				BidirectionalCost != INDEX_NONE) ||
+			!TestTrue(FString::Printf(TEXT("Problem %d: iterative deepening plan is valid"), Seed),
+				IterativeDeepeningCost != INDEX_NONE))
+		{
+			continue;
+		}
+
+		// forward, bidirectional and iterative deepening searches are optimal
+		TestEqual(FString::Printf(TEXT("Problem %d: reported forward cost"), Seed), ForwardResult.PlanCost,
+			ForwardCost);
+		TestEqual(FString::Printf(TEXT("Problem %d: bidirectional cost"), Seed), BidirectionalCost, ForwardCost);
+		TestEqual(FString::Printf(TEXT("Problem %d: iterative deepening cost"), Seed), IterativeDeepeningCost,
+			ForwardCost);
+		// backward search doesn't interleave plans of goal's facts, so its plan can only be more expensive
+		TestTrue(FString::Printf(TEXT("Problem %d: backward cost isn't lower than optimal"), Seed),
+			BackwardCost >= ForwardCost);
+	}
+	return true;
+}
+
+namespace GOAPPlanningCoreTests
+{
+	struct FPrepared : TGOAPSchemaKey<bool> {};
+	struct FHasA : TGOAPSchemaKey<bool> {};
+	struct FHasB : TGOAPSchemaKey<bool> {};
+	struct FHasC : TGOAPSchemaKey<bool> {};
+	struct FHasD : TGOAPSchemaKey<bool> {};
+	using FTestSchema = TGOAPSchema<FPrepared, FHasA, FHasB, FHasC, FHasD>;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGOAPPlanningCoreTypedSearchesTest, "GOAP.PlanningCore.TypedSearches",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGOAPPlanningCoreTypedSearchesTest::RunTest(const FString& Parameters)
+{
+	using namespace GOAPPlanningCoreTests;
+
+	// preparing (cost 1) and setting all goal's keys at once (cost 2) is cheaper than setting each key separately
+	// (cost 4), but after preparing there are still 4 unmet keys - counting them would overestimate the remaining cost
+	FTestSchema::FProblem Problem;
+	Problem.Actions.AddDefaulted_GetRef().Effects.Add<FPrepared>(true);
+	FTestSchema::FProblem::FAction& SetAll = Problem.Actions.AddDefaulted_GetRef();
+	SetAll.Preconditions.Add<FPrepared>(true);
+	SetAll.Effects.Add<FHasA>(true).Add<FHasB>(true).Add<FHasC>(true).Add<FHasD>(true);
+	SetAll.Cost = 2;
+	Problem.Actions.AddDefaulted_GetRef().Effects.Add<FHasA>(true);
+	Problem.Actions.AddDefaulted_GetRef().Effects.Add<FHasB>(true);
+	Problem.Actions.AddDefaulted_GetRef().Effects.Add<FHasC>(true);
+	Problem.Actions.AddDefaulted_GetRef().Effects.Add<FHasD>(true);
+	Problem.Goal.Add<FHasA>(true).Add<FHasB>(true).Add<FHasC>(true).Add<FHasD>(true);
+	Problem.FinalizeProblem();
+
+	FGOAPPlanningCore PlanningCore;
+	FGOAPCoreSearchResult ForwardResult;
+	FGOAPCoreSearchResult IterativeDeepeningResult;
+	PlanningCore.SearchForward(Problem, ForwardResult);
+	PlanningCore.SearchIterativeDeepening(Problem, IterativeDeepeningResult);
+
+	TestEqual(TEXT("Forward plan cost"), GetPlanCost(Problem, ForwardResult.Plan), 3);
+	TestEqual(TEXT("Iterative deepening plan cost"), GetPlanCost(Problem, IterativeDeepeningResult.Plan), 3);
+	return true;
+}
+
+#endif
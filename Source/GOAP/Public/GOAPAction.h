@@ -36,7 +36,10 @@ public:
 	void SetActionTargetData(FGOAPWorldStateData TargetData);
 
 	/** Return cost of use this ability to achieve DesiredWorldState; valid only if CanChangeWorldState returns true
-	 * for the same parameters. */
+	 * for the same parameters.
+	 * WithCurrentWorldState is deprecated and always empty: solvers ground actions once per search, so cost is
+	 * evaluated once per action and desired world state (not per search node with planned world state). Cost which
+	 * depends on world state should read actual one (e.g. from AgentActor's memory). */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
 	int32 GetActionCost(FGOAPWorldStateData DesiredWorldState, AActor* AgentActor,
 		const TArray<FGOAPWorldStateData>& WithCurrentWorldState);
@@ -4,11 +4,29 @@
 
 #include "CoreMinimal.h"
 #include "GOAPTypes.h"
+#include "GOAPGoalPredicate.h"
 #include "GOAPPlanner.h"
+#include "GOAPUtilityScoring.h"
 #include "GOAPGoal.generated.h"
 
 class IGOAPAgent;
 
+/**
+ * Defines how goal's score is calculated.
+ */
+UENUM(BlueprintType)
+enum class EGOAPGoalScoringMode : uint8
+{
+	/** Score is returned by GetGoalScore and validity by IsGoalValid (implemented in Blueprint). */
+	Blueprint,
+	/**
+	 * Score is calculated natively from UtilityConsiderations (agent's world state values passed through response
+	 * curves), without calling Blueprint. Goal is valid if its score is greater than 0 (and optionally if IsGoalValid
+	 * returns true).
+	 */
+	Utility
+};
+
 /**
  * Goal for planner. Defines what AI want to achieve and how important it is.
  */
@@ -20,6 +38,7 @@ class GOAP_API UGOAPGoal : public UObject
 public:
 
 	friend class UGOAPPlanner;
+	friend struct FGOAPUtilityScoringBatch;
 
 	/** Return true if goal is valid and can be considered in planning. */
 	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable)
@@ -32,6 +51,46 @@ public:
 	/** Return world state that satisfy goal. */
 	UFUNCTION(BlueprintCallable)
 	FGOAPWorldStateData GetDesiredWorldState();
+	/**
+	 * Update desired world state and return compiled goal's conditions (DesiredConditions or, if there aren't any,
+	 * DesiredWorldState).
+	 */
+	const FGOAPGoalPredicate& GetDesiredPredicate();
+	/**
+	 * Return goal's conditions compiled on last GetDesiredPredicate call (or from DesiredConditions defaults),
+	 * without updating desired world state.
+	 */
+	const FGOAPGoalPredicate& GetCompiledPredicate();
+	/** Return true if planner should skip this goal while its conditions are already met. */
+	FORCEINLINE bool ShouldSkipWhenSatisfied() const { return bSkipWhenSatisfied; }
+	/** Return true if goal's SearchSettings are used instead of planner's ones. */
+	FORCEINLINE bool ShouldOverrideSearchSettings() const { return bOverrideSearchSettings; }
+	/** Return quality settings of searches for this goal (used if ShouldOverrideSearchSettings). */
+	FORCEINLINE const FGOAPSearchSettings& GetSearchSettings() const { return SearchSettings; }
+
+	/** Report objects referenced by CompiledPredicate (it isn't UPROPERTY). */
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	/** Return how goal's score is calculated. */
+	FORCEINLINE EGOAPGoalScoringMode GetScoringMode() const { return ScoringMode; }
+	/** Return inputs of native goal score (used in Utility scoring mode). */
+	FORCEINLINE const TArray<FGOAPUtilityConsideration>& GetUtilityConsiderations() const { return UtilityConsiderations; }
+	/** Return true if in Utility scoring mode IsGoalValid has to be checked as well. */
+	FORCEINLINE bool ShouldCheckBlueprintValidity() const { return bCheckBlueprintValidity; }
+	/**
+	 * Return native goal's score calculated from UtilityConsiderations. To score many goals at once use
+	 * FGOAPUtilityScoringBatch.
+	 */
+	UFUNCTION(BlueprintCallable)
+	float CalculateUtilityScore();
+
+	/**
+	 * Return true if change of world state data of given tag can affect this goal's validity, score or conditions
+	 * (RelevantWorldStateTags, native score inputs and keys of goal's own conditions).
+	 */
+	bool IsDependentOnWorldState(const FGameplayTag& WorldStateAtomTag) const;
+	/** Return true if change of agent's memory can affect this goal's validity or score. */
+	FORCEINLINE bool IsDependentOnMemory() const { return bDependsOnMemory; }
 
 protected:
 	
@@ -50,5 +109,63 @@ protected:
 	/** Current desired world state. Is updated on each GetDesiredWorldState use. */
 	UPROPERTY(BlueprintReadWrite, meta = (AllowPrivateAccess = true))
 	FGOAPWorldStateData DesiredWorldState;
+
+	/**
+	 * Conditions that satisfy goal. If not empty they are used instead of DesiredWorldState. Conditions can compare
+	 * values numerically and can be joined as conjunction or disjunction (DesiredConditionsJunction). Condition's key
+	 * without actor refers to agent. Like DesiredWorldState, it can be updated in UpdateDesiredWorldState.
+	 * @warning: backward planning supports only equality conditions (not met conditions of other types can't be
+	 * achieved by backward solver).
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
+	TArray<FGOAPWorldStateCondition> DesiredConditions;
+	/** Defines how DesiredConditions are joined. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
+	EGOAPConditionJunction DesiredConditionsJunction = EGOAPConditionJunction::All;
+	/**
+	 * If true planner doesn't consider this goal (and doesn't call its IsGoalValid and GetGoalScore) while its
+	 * conditions (compiled on last planning) are already met.
+	 */
+	UPROPERTY(EditDefaultsOnly)
+	bool bSkipWhenSatisfied = false;
+
+	/** If true SearchSettings are used for this goal instead of planner's ones. */
+	UPROPERTY(EditDefaultsOnly)
+	bool bOverrideSearchSettings = false;
+	/** Quality of forward and bidirectional searches for this goal, e.g. optimal plans only for important goals. */
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "bOverrideSearchSettings"))
+	FGOAPSearchSettings SearchSettings;
+
+	/**
+	 * Tags of world state data (of any actor known by agent) which affect this goal's validity or score. Used only
+	 * by planner working in event driven mode - goals are re-evaluated when any of these values is reported as changed.
+	 */
+	UPROPERTY(EditDefaultsOnly)
+	FGameplayTagContainer RelevantWorldStateTags;
+
+	/**
+	 * If true agent's memory changes affect this goal's validity or score. Used only by planner working in event
+	 * driven mode - goals are re-evaluated when any actor is registered in or unregistered from memory.
+	 */
+	UPROPERTY(EditDefaultsOnly)
+	bool bDependsOnMemory = true;
+
+	/** Defines how goal's score is calculated. */
+	UPROPERTY(EditDefaultsOnly)
+	EGOAPGoalScoringMode ScoringMode = EGOAPGoalScoringMode::Blueprint;
+	/** Inputs of native goal score. Score is weighted average of all considerations responses. */
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "ScoringMode == EGOAPGoalScoringMode::Utility"))
+	TArray<FGOAPUtilityConsideration> UtilityConsiderations;
+	/** If true, in Utility scoring mode goal has to be also valid according to IsGoalValid. */
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "ScoringMode == EGOAPGoalScoringMode::Utility"))
+	bool bCheckBlueprintValidity = false;
+
+private:
+
+	/** Compile goal's conditions to CompiledPredicate. */
+	void CompilePredicate();
+
+	/** Goal's conditions compiled on last update. */
+	FGOAPGoalPredicate CompiledPredicate;
 	
 };
\ No newline at end of file
@@ -0,0 +1,132 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPTypes.h"
+#include "GOAPGoalPredicate.generated.h"
+
+/**
+ * Comparison used by world state condition.
+ */
+UENUM(BlueprintType)
+enum class EGOAPConditionOperator : uint8
+{
+	Equal,
+	NotEqual,
+	/** Numeric comparisons - both values have to be numeric (bool, int or float payload). */
+	Less,
+	LessOrEqual,
+	Greater,
+	GreaterOrEqual
+};
+
+/**
+ * Defines how goal's conditions are joined.
+ */
+UENUM(BlueprintType)
+enum class EGOAPConditionJunction : uint8
+{
+	/** All conditions have to be met (conjunction). */
+	All,
+	/** At least one condition has to be met (disjunction). */
+	Any
+};
+
+/**
+ * Single condition of goal - world state value compared with given value.
+ */
+USTRUCT(BlueprintType)
+struct FGOAPWorldStateCondition
+{
+	GENERATED_BODY()
+
+	FGOAPWorldStateCondition() {}
+	FGOAPWorldStateCondition(const FGOAPWorldStateData& InWorldState, EGOAPConditionOperator InOperator)
+		: WorldState(InWorldState), Operator(InOperator) {}
+
+	/** Compared world state key and value to compare with. Key without actor refers to agent. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
+	FGOAPWorldStateData WorldState;
+	/** Comparison: current value <Operator> WorldState value. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
+	EGOAPConditionOperator Operator = EGOAPConditionOperator::Equal;
+};
+
+/** Returns actual value of given world state key; lets solvers read world state from recording instead of live world. */
+using FGOAPWorldStateReader = TFunctionRef<FGOAPWorldStateValue(const FGOAPWorldStateKey&)>;
+
+/**
+ * Goal's conditions compiled to compact form: unique keys table and flat list of comparisons, evaluated without
+ * calling Blueprint. Used by solvers for goal tests and by planner for cheap "already satisfied" checks.
+ */
+struct GOAP_API FGOAPGoalPredicate
+{
+	/**
+	 * Single comparison of predicate.
+	 */
+	struct FInstruction
+	{
+		/** Index of compared key in Keys. */
+		int32 KeyIndex = -1;
+		EGOAPConditionOperator Operator = EGOAPConditionOperator::Equal;
+		/** Value to compare with. */
+		UGOAPWorldStatePayload* Value = nullptr;
+		/** Numeric value to compare with (valid only for numeric comparisons). */
+		double Number = 0.0;
+	};
+
+	/** Build predicate from given conditions. Keys without actor are bound to AgentActor. */
+	void Compile(const TArray<FGOAPWorldStateCondition>& Conditions, EGOAPConditionJunction InJunction,
+		AActor* AgentActor);
+	/** Remove all conditions. */
+	void Reset();
+	/**
+	 * Report payloads and actors referenced by predicate to garbage collector - predicate kept between frames has to
+	 * be reported by its owner.
+	 */
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+	/** Return true if predicate has no conditions. */
+	FORCEINLINE bool IsEmpty() const { return Instructions.Num() == 0; }
+	/** Return true if predicate is satisfied by actual world state. */
+	bool IsSatisfied() const;
+	/**
+	 * Return true if predicate is satisfied by given world state (values not present in WithCurrentWorldState are
+	 * taken from actual world state).
+	 */
+	bool IsSatisfied(const TArray<FGOAPWorldStateData>& WithCurrentWorldState) const;
+	bool IsSatisfied(const TArray<FGOAPWorldStateData>& WithCurrentWorldState, FGOAPWorldStateReader Reader) const;
+	/**
+	 * Return number of conditions which have to be met yet to satisfy predicate in given world state (0 - predicate
+	 * is satisfied). For disjunction it is 0 or 1. Can be used as heuristic for forward planning.
+	 */
+	int32 GetUnsatisfiedConditionsNum(const TArray<FGOAPWorldStateData>& WithCurrentWorldState) const;
+	int32 GetUnsatisfiedConditionsNum(const TArray<FGOAPWorldStateData>& WithCurrentWorldState,
+		FGOAPWorldStateReader Reader) const;
+	/**
+	 * Return sets of desired world states which satisfy predicate and can be achieved by backward planning (only
+	 * equality conditions can be regressed). For conjunction it's one set of all not actual states or nothing if
+	 * any other condition isn't met; for disjunction one set per not actual equality condition.
+	 */
+	TArray<TArray<FGOAPWorldStateData>> GetRegressionTargets() const;
+	TArray<TArray<FGOAPWorldStateData>> GetRegressionTargets(FGOAPWorldStateReader Reader) const;
+
+	/** Unique keys used by predicate. */
+	TArray<FGOAPWorldStateKey> Keys;
+	/** Comparisons joined by Junction. */
+	TArray<FInstruction> Instructions;
+	/** How comparisons are joined. */
+	EGOAPConditionJunction Junction = EGOAPConditionJunction::All;
+
+	/** Return true if given value meets given comparison. */
+	static bool EvaluateInstruction(const FInstruction& Instruction, UGOAPWorldStatePayload* CurrentValue);
+
+private:
+
+	/** Return current values of all keys. */
+	void GetCurrentValues(const TArray<FGOAPWorldStateData>& WithCurrentWorldState, FGOAPWorldStateReader Reader,
+		TArray<UGOAPWorldStatePayload*>& OutValues) const;
+	/** Read value from live world. */
+	static FGOAPWorldStateValue ReadActualWorldStateValue(const FGOAPWorldStateKey& Key);
+};
@@ -0,0 +1,103 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Optional.h"
+#include "Stats/Stats.h"
+
+#define GOAP_HOOK_PROFILER_ENABLED !UE_BUILD_SHIPPING
+
+/**
+ * User callbacks (usually implemented in Blueprint) called by plugin.
+ */
+enum class EGOAPHook : uint8
+{
+	AtomUpdate,
+	GoalValidity,
+	GoalScore,
+	GoalDesiredWorldState,
+	ActionCanChangeWorldState,
+	ActionPreconditions,
+	ActionCost,
+	ActionEffect,
+	ActionSetTargetData,
+	ActionCanBeCanceled,
+	ExecutorActivateAction,
+	ExecutorGetActiveAction,
+	ExecutorCancelAction,
+	Num
+};
+
+#if GOAP_HOOK_PROFILER_ENABLED
+
+/** GOAP user callbacks stats, use "stat GOAPHooks" console command (with GOAP.HookProfiler.Enable 1) to see them. */
+DECLARE_STATS_GROUP(TEXT("GOAPHooks"), STATGROUP_GOAPHooks, STATCAT_Advanced);
+
+/**
+ * Measures time and number of calls of user callbacks per class of called object. Disabled by default, enable it by
+ * GOAP.HookProfiler.Enable console variable and print ranking by GOAP.HookProfiler.Dump console command.
+ */
+struct GOAP_API FGOAPHookProfiler
+{
+	/** Return true if hooks are profiled. */
+	FORCEINLINE static bool IsEnabled() { return bEnabled; }
+
+	/** Return stat of given hook of given class (used for "stat GOAPHooks"). */
+	static TStatId GetStatId(const UClass* Class, EGOAPHook Hook);
+	/** Add single call of given hook of given class lasting given number of cycles. */
+	static void RecordCall(const UClass* Class, EGOAPHook Hook, uint64 Cycles);
+	/** Remove all gathered data. */
+	static void Reset();
+	/** Print classes hooks ranked by total time (or by time per call if bSortByTimePerCall is true). */
+	static void Dump(FOutputDevice& Ar, bool bSortByTimePerCall);
+
+	/** Return name of given hook. */
+	static const TCHAR* GetHookName(EGOAPHook Hook);
+
+	static bool bEnabled;
+};
+
+/**
+ * Scope measuring single call of user callback, does nothing if hook profiler is disabled.
+ */
+class GOAP_API FGOAPHookScope
+{
+public:
+
+	FGOAPHookScope(const UObject* Object, EGOAPHook InHook)
+	{
+		if(FGOAPHookProfiler::IsEnabled() && Object)
+		{
+			Start(Object->GetClass(), InHook);
+		}
+	}
+
+	~FGOAPHookScope()
+	{
+		if(Class)
+		{
+			Stop();
+		}
+	}
+
+private:
+
+	void Start(const UClass* InClass, EGOAPHook InHook);
+	void Stop();
+
+	const UClass* Class = nullptr;
+	EGOAPHook Hook = EGOAPHook::Num;
+	uint64 StartCycles = 0;
+#if STATS
+	TOptional<FScopeCycleCounter> CycleCounter;
+#endif
+};
+
+#define GOAP_HOOK_SCOPE(Object, Hook) FGOAPHookScope PREPROCESSOR_JOIN(GOAPHookScope, __LINE__)(Object, EGOAPHook::Hook)
+
+#else
+
+#define GOAP_HOOK_SCOPE(Object, Hook)
+
+#endif
@@ -6,6 +6,7 @@
 #include "GOAPTypes.h"
 #include "GOAPMemoryComponent.h"
 #include "GOAPSolver_Backward.h"
+#include "GOAPUtilityScoring.h"
 #include "Components/ActorComponent.h"
 #include "GOAPPlanner.generated.h"
 
@@ -14,6 +15,21 @@ class UGOAPGoal;
 class IGOAPAction;
 class UGOAPAction;
 
+/**
+ * Defines when planner checks which goal should be pursued.
+ */
+UENUM(BlueprintType)
+enum class EGOAPGoalsEvaluationMode : uint8
+{
+	/** Goals are evaluated on each planner tick (every TickInterval). */
+	Polling,
+	/**
+	 * Goals are evaluated only when any world state or memory change they depend on is reported, current plan ends,
+	 * or MaxGoalsEvaluationInterval expires. Planner doesn't tick when there is nothing to evaluate.
+	 */
+	EventDriven
+};
+
 /**
  * Helper struct for storing planned actions and theirs target data.
  */
@@ -33,6 +49,27 @@ struct FGOAPActionWithTargetData
 	FGOAPWorldStateData TargetData;
 };
 
+/**
+ * World state which has to be met to execute planned action and isn't achieved by any previous action of plan.
+ */
+USTRUCT()
+struct FGOAPPlanDependency
+{
+	GENERATED_BODY()
+
+	FGOAPPlanDependency() {}
+	FGOAPPlanDependency(const FGOAPWorldStateData& InRequiredWorldState, int32 InStepIndex, bool bInMet)
+		: RequiredWorldState(InRequiredWorldState), StepIndex(InStepIndex), bMet(bInMet) {}
+
+	/** Required world state (action's precondition). */
+	UPROPERTY()
+	FGOAPWorldStateData RequiredWorldState;
+	/** Index of action in plan which requires this world state. */
+	int32 StepIndex = -1;
+	/** True if required world state was met when its value was checked last time. */
+	bool bMet = true;
+};
+
 /**
  * GOAP heart. Manage world state, goals and actions. Make decisions what goal will be considered and after
  * that how to achieve this goal. Planning sequence of few actions and execute them. Check validity of goals
@@ -71,15 +108,90 @@ public:
 
 	/** Return all actions available for planner. */
 	TArray<UObject*> GetActions();
+
+	/** Return currently realized plan. Empty if isn't realized any plan. */
+	FORCEINLINE const TArray<FGOAPActionWithTargetData>& GetExecutingPlan() const { return ExecutingPlan; }
+	/** Return index of currently executed action of plan, -1 if isn't realized any plan. */
+	FORCEINLINE int32 GetExecutingPlanActionIndex() const { return ExecutingPlanActionIndex; }
+	/** Return world states on which currently realized plan depends. */
+	FORCEINLINE const TArray<FGOAPPlanDependency>& GetExecutingPlanDependencies() const { return ExecutingPlanDependencies; }
+
+	/** Return solver used by planner. */
+	FORCEINLINE UGOAPSolver* GetSolver() const { return Solver; }
+	/** Return quality settings of planner's searches (goals can override them). */
+	FORCEINLINE const FGOAPSearchSettings& GetSearchSettings() const { return SearchSettings; }
+	/** Return all goals of planner. */
+	FORCEINLINE const TArray<UGOAPGoal*>& GetGoals() const { return Goals; }
+	/**
+	 * Return goals scores from last goals evaluation (in order of GetGoals). Score is 0 for invalid goals and -1 for
+	 * goals skipped because they were already satisfied.
+	 */
+	FORCEINLINE const TArray<float>& GetLastGoalsScores() const { return LastGoalsScores; }
+	/** Return number of plans searches made by planner. */
+	FORCEINLINE int32 GetSearchesNum() const { return SearchesNum; }
+
+	/**
+	 * Force planner to check which goal should be pursued on the nearest tick. In polling mode goals are checked
+	 * on each tick anyway.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void RequestGoalsEvaluation();
+
+	/**
+	 * Evaluate goals and plan if needed. Called on planner's tick or, if planner uses scheduler, by
+	 * UGOAPPlannerSubsystem when frame budget allows.
+	 */
+	void UpdatePlanner();
+	/**
+	 * Add considerations of planner's native (utility) goals to given batch, shared by all planners updated by
+	 * UGOAPPlannerSubsystem in current frame. Return false if planner has no such goals.
+	 */
+	bool AddUtilityGoalsToBatch(FGOAPUtilityScoringBatch& Batch);
+	/**
+	 * Take scores of goals added by AddUtilityGoalsToBatch from evaluated batch. They are used instead of planner's
+	 * own batch by goals evaluation in current frame.
+	 */
+	void SetUtilityGoalsScores(const TArray<float>& BatchScores);
+
+	/** Return gameplay priority of this agent used by planner scheduler. */
+	UFUNCTION(BlueprintCallable)
+	FORCEINLINE float GetSchedulingPriority() const { return SchedulingPriority; }
+	/** Set gameplay priority of this agent used by planner scheduler. Higher value - sooner update. */
+	UFUNCTION(BlueprintCallable)
+	void SetSchedulingPriority(float InSchedulingPriority) { SchedulingPriority = InSchedulingPriority; }
+	/** Return true if agent is marked as being in combat. */
+	UFUNCTION(BlueprintCallable)
+	FORCEINLINE bool IsInCombat() const { return bInCombat; }
+	/** Mark agent as being in combat, which increases its priority in planner scheduler. */
+	UFUNCTION(BlueprintCallable)
+	void SetInCombat(bool bInInCombat) { bInCombat = bInInCombat; }
+
+	/** Set when planner checks which goal should be pursued. Has to be called before InitializePlanner. */
+	void SetGoalsEvaluationMode(EGOAPGoalsEvaluationMode InGoalsEvaluationMode) { GoalsEvaluationMode = InGoalsEvaluationMode; }
+	/** Set if planner is updated by UGOAPPlannerSubsystem (within frame budget) instead of on its own tick. */
+	void SetUseScheduler(bool bInUseScheduler);
 	
 protected:
 
+	/**
+	 * Validate if current goal is best goal and switch to other goal if needed. Return false if goal should be
+	 * changed but it isn't possible at this moment (active action can't be canceled).
+	 */
+	bool EvaluateGoals();
 	/** Searches all available goals and return goal with best score. */
 	UFUNCTION(BlueprintCallable)
 	UGOAPGoal* FindBestScoredGoal();
 	/** Set pursued goal, try build plan for it and execute. */
 	UFUNCTION(BlueprintCallable)
 	void SetPursuedGoal(UGOAPGoal* Goal);
+	/**
+	 * Plan for MultiGoalPlanningCount best scored goals (scores from last goals evaluation) by single search and pursue
+	 * goal of the best trade-off between score and plan cost. If none of them can be achieved, BestGoal is pursued
+	 * without plan (as by SetPursuedGoal).
+	 */
+	void SetPursuedGoalOfBestGoals(UGOAPGoal* BestGoal);
+	/** Start executing plan found for pursued goal (if any). */
+	void StartPursuedGoalPlan(const TArray<FGOAPActionWithTargetData>& Plan);
 	/** Start performing given plan. Return true if successfully started. */
 	bool ExecutePlan(TArray<FGOAPActionWithTargetData> Plan);
 	/** Activate action of index ExecutingPlanActionIndex from ExecutingPlan. Return true if successfully activated. */
@@ -88,12 +200,40 @@ protected:
 	bool IsCurrentlyExecutingPlan() const;
 	/** Called to finish executing plan. */
 	void FinishExecutePlan();
+	/**
+	 * Collect world states which plan's actions require and which aren't achieved by plan itself, and start listening
+	 * to their changes. Return false if any of them is not met already.
+	 */
+	bool CollectPlanDependencies();
+	/** Update plan dependencies of given key after change. Invalidate plan if any dependency of next actions isn't met. */
+	void UpdatePlanDependencies(AActor* Actor, const FGameplayTag& WorldStateAtomTag);
+	/** Stop executing plan which can't be finished; new plan will be searched immediately. */
+	void InvalidateExecutingPlan();
+	/** Return true if given actor's world state provider has to be observed to evaluate goals. */
+	bool IsWorldStateObservedForGoals(AActor* Actor) const;
+
+	/** User callbacks wrappers (measured by hook profiler, see GOAP.HookProfiler.Enable). */
+	bool IsGoalValid(UGOAPGoal* Goal) const;
+	UObject* GetExecutorActiveAction() const;
+	bool CanActionBeCanceled(UObject* Action) const;
+	void CancelExecutorAction(UObject* Action) const;
 	
 	/** Called when ability finished (properly or canceled). */
 	UFUNCTION()
 	void OnAbilityEnded(const UObject* Action, bool bSuccess);
 
+	/** Called when agent's memory changed; in event driven mode keeps world state subscriptions up to date. */
+	UFUNCTION()
+	void OnMemoryChanged(AActor* Actor, bool bRegistered);
+	/** Called when any subscribed world state provider reports changed value. */
+	void OnWorldStateChanged(AActor* Actor, const FGameplayTag& WorldStateAtomTag);
+	/** Start listening to world state changes of given actor (if it has world state provider). */
+	void SubscribeWorldStateProvider(AActor* Actor);
+	/** Stop listening to world state changes of given actor. */
+	void UnsubscribeWorldStateProvider(AActor* Actor);
+
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 
@@ -110,6 +250,25 @@ private:
 	/** Solver which will be used to finding plan. */
 	UPROPERTY(EditDefaultsOnly)
 	TSubclassOf<UGOAPSolver> SolverImplementationClass = UGOAPSolver_Backward::StaticClass();
+	/**
+	 * Quality of searches of forward and bidirectional solvers - optimal plans or cheaper searches (weighted, beam,
+	 * anytime). Goal classes can override it (bOverrideSearchSettings).
+	 */
+	UPROPERTY(EditDefaultsOnly)
+	FGOAPSearchSettings SearchSettings;
+	/**
+	 * Number of the best scored valid goals planned together by single search (UGOAPSolver::FindPlanForGoals) when
+	 * pursued goal is changed, so goal which can't be achieved is replaced by the next one at once. 1 - only the best
+	 * scored goal is planned.
+	 */
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = 1))
+	int32 MultiGoalPlanningCount = 1;
+	/**
+	 * Score lost per unit of plan cost when goals planned together are compared - goal of max Score -
+	 * PlanCostScoreWeight * PlanCost is pursued. 0 - the best scored goal which can be achieved.
+	 */
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = 0.0, EditCondition = "MultiGoalPlanningCount > 1"))
+	float PlanCostScoreWeight = 0.0f;
 	/** Reference to solver, which is created on BeginPlay by planner. */
 	UPROPERTY()
 	UGOAPSolver* Solver;
@@ -122,9 +281,31 @@ private:
 	UPROPERTY()
 	TArray<UGOAPGoal*> Goals;
 
+	/**
+	 * Batch used to evaluate native goals scores when they weren't evaluated by scheduler's shared batch; kept between
+	 * evaluations to reuse allocated memory.
+	 */
+	FGOAPUtilityScoringBatch UtilityScoringBatch;
+	/** Index of each goal in batch it was added to by AddUtilityGoalsToBatch (INDEX_NONE if not added). */
+	TArray<int32> UtilityGoalsBatchIndexes;
+	/** Native goals scores (in order of Goals) taken from scheduler's shared batch in frame UtilityScoresFrame. */
+	TArray<float> BatchedUtilityScores;
+	/** Frame (GFrameCounter) of BatchedUtilityScores; they aren't used in other frames. */
+	uint64 UtilityScoresFrame = 0;
+	/** Goals scores from last evaluation, see GetLastGoalsScores. */
+	TArray<float> LastGoalsScores;
+	/** Number of plans searches made by planner. */
+	int32 SearchesNum = 0;
+
 	/** Currently realised goal. */
 	UPROPERTY()
 	UGOAPGoal* PursuedGoal = nullptr;
+	/**
+	 * The best scored goal when pursued goal was set - with multi-goal planning pursued goal can be worse scored one,
+	 * so goals are switched only when the best scored goal changes.
+	 */
+	UPROPERTY()
+	UGOAPGoal* PursuedGoalBestGoal = nullptr;
 
 	/** If currently is executing plan, here is current action index; -1 otherwise. */
 	int32 ExecutingPlanActionIndex = -1;
@@ -134,5 +315,46 @@ private:
 
 	/** Delegate handle for ability end. Can also be used to check if currently is realizing any action. */
 	FDelegateHandle CurrentActionHandle;
+
+	/** World states on which currently realized plan depends. */
+	UPROPERTY()
+	TArray<FGOAPPlanDependency> ExecutingPlanDependencies;
+	/** True if plan can't be continued, but current action can't be canceled - plan is finished after this action. */
+	bool bExecutingPlanInvalidated = false;
+
+	/** Defines when planner checks which goal should be pursued. */
+	UPROPERTY(EditDefaultsOnly)
+	EGOAPGoalsEvaluationMode GoalsEvaluationMode = EGOAPGoalsEvaluationMode::Polling;
+	/**
+	 * In event driven mode goals are evaluated at least once per this time (in seconds), even if nothing changed.
+	 * Also the longest time goal which plan failed to start isn't pursued (in both modes), see FailedGoal.
+	 */
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = 0.1))
+	float MaxGoalsEvaluationInterval = 5.0f;
+
+	/**
+	 * If true planner doesn't update on its own tick, but requests update from UGOAPPlannerSubsystem, which
+	 * processes requests of all planners within per frame time budget.
+	 */
+	UPROPERTY(EditDefaultsOnly)
+	bool bUseScheduler = false;
+	/** Gameplay priority of this agent used by planner scheduler. Higher value - sooner update. */
+	UPROPERTY(EditAnywhere)
+	float SchedulingPriority = 0.0f;
+	/** If true agent is in combat, which increases its priority in planner scheduler. */
+	bool bInCombat = false;
+
+	/** In event driven mode true if something changed since last goals evaluation. */
+	bool bGoalsEvaluationPending = false;
+	/** Timer forcing goals evaluation after MaxGoalsEvaluationInterval in event driven mode. */
+	FTimerHandle GoalsEvaluationTimerHandle;
+	/**
+	 * Goal which plan failed to start. It isn't pursued until any world state (or memory) it depends on changes or
+	 * MaxGoalsEvaluationInterval expires, so the same plan isn't searched and dropped again on each evaluation.
+	 */
+	UPROPERTY()
+	UGOAPGoal* FailedGoal = nullptr;
+	/** World time (in seconds) after which FailedGoal can be pursued again. */
+	double FailedGoalRetryTime = 0.0;
 	
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPUtilityScoring.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GOAPPlannerSubsystem.generated.h"
+
+class UGOAPPlanner;
+
+/**
+ * Planner scheduler metrics.
+ */
+USTRUCT(BlueprintType)
+struct FGOAPSchedulerMetrics
+{
+	GENERATED_BODY()
+
+	/** Number of planners waiting for update. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 QueueDepth = 0;
+	/** Number of planners updated in last frame. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 UpdatedPlannersLastFrame = 0;
+	/** Time (in milliseconds) spent on updating planners in last frame. */
+	UPROPERTY(BlueprintReadOnly)
+	float UpdateTimeLastFrameMs = 0.0f;
+	/** Smoothed time (in seconds) between request and update of planner. */
+	UPROPERTY(BlueprintReadOnly)
+	float AverageLatency = 0.0f;
+	/** Max time (in seconds) between request and update of planner in last frame. */
+	UPROPERTY(BlueprintReadOnly)
+	float MaxLatencyLastFrame = 0.0f;
+	/** Number of requests processed over frame budget because they were waiting too long. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 StarvedRequestsLastFrame = 0;
+};
+
+/**
+ * Owns planners updates (goals evaluation and planning) for planners using scheduler. Instead of updating on their own
+ * timers planners put requests to the queue, which is processed in order of agents significance within configured
+ * per frame time budget (see UGOAPSettings). Native (utility) goals scores of all planners updated in a frame are
+ * evaluated by one shared batch.
+ */
+UCLASS()
+class GOAP_API UGOAPPlannerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Add planner to update queue. Does nothing if planner is already waiting for update. */
+	void RequestPlannerUpdate(UGOAPPlanner* Planner);
+	/** Remove planner from update queue (e.g. when planner is destroyed). */
+	void CancelPlannerUpdate(UGOAPPlanner* Planner);
+
+	/** Return current scheduler metrics. */
+	UFUNCTION(BlueprintCallable)
+	FORCEINLINE FGOAPSchedulerMetrics GetSchedulerMetrics() const { return Metrics; }
+
+private:
+
+	/**
+	 * Helper struct for planner waiting for update.
+	 */
+	struct FGOAPPlannerUpdateRequest
+	{
+		FGOAPPlannerUpdateRequest() {}
+		FGOAPPlannerUpdateRequest(UGOAPPlanner* InPlanner, double InRequestTime)
+			: Planner(InPlanner), RequestTime(InRequestTime) {}
+		
+		/** Planner to update. */
+		TWeakObjectPtr<UGOAPPlanner> Planner;
+		/** Time when update was requested. */
+		double RequestTime = 0.0;
+		/** Priority of request, calculated each frame. */
+		float Priority = 0.0f;
+		/** True if request waits longer than max wait time and has to be processed regardless of budget. */
+		bool bStarving = false;
+	};
+
+	/** Return significance of given planner's agent (distance to viewers, combat state, gameplay priority). */
+	float CalculateSignificance(const UGOAPPlanner* Planner, const TArray<FVector>& ViewLocations) const;
+	/**
+	 * Evaluate native goals scores of planners of sorted Requests expected to be updated in this frame (starving ones
+	 * and ExpectedUpdatesNum first ones) by one batch, and pass scores to planners.
+	 */
+	void ScoreUtilityGoals(int32 ExpectedUpdatesNum);
+	
+	/** Planners waiting for update. */
+	TArray<FGOAPPlannerUpdateRequest> Requests;
+	/**
+	 * Requests processed by current Tick - they are moved out of Requests, so planners updates can add and cancel
+	 * requests safely.
+	 */
+	TArray<FGOAPPlannerUpdateRequest> ProcessedRequests;
+	/** Current scheduler metrics. */
+	FGOAPSchedulerMetrics Metrics;
+	/** Batch of native goals of all planners updated in a frame; kept between frames to reuse allocated memory. */
+	FGOAPUtilityScoringBatch UtilityScoringBatch;
+	
+};
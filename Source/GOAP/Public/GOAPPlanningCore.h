@@ -0,0 +1,725 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+#include "GOAPGoalPredicate.h"
+#include "GOAPStats.h"
+#include "GOAPTrace.h"
+#include <atomic>
+
+/*
+ * Planning core - problem description and search algorithms working only on indexes, without UObjects and Blueprint
+ * calls. Solvers ground the problem on game thread (all actions queries are made then) and translate found plan back
+ * to actions, so search itself is reentrant and one problem can be searched by many threads at once.
+ */
+
+/**
+ * Single world state value in planning problem - key index with value index (values are interned, so equal payloads
+ * have the same index).
+ */
+struct FGOAPCoreFact
+{
+	FGOAPCoreFact() {}
+	FGOAPCoreFact(int32 InKey, int32 InValue) : Key(InKey), Value(InValue) {}
+
+	int32 Key = INDEX_NONE;
+	int32 Value = INDEX_NONE;
+
+	FORCEINLINE bool operator==(const FGOAPCoreFact& Other) const { return Key == Other.Key && Value == Other.Value; }
+	FORCEINLINE bool operator!=(const FGOAPCoreFact& Other) const { return !(*this == Other); }
+	friend FORCEINLINE uint32 GetTypeHash(const FGOAPCoreFact& Fact)
+	{
+		return HashCombine(::GetTypeHash(Fact.Key), ::GetTypeHash(Fact.Value));
+	}
+};
+
+/** Complete world state in planning problem - value index for each key index. */
+using FGOAPCoreState = TArray<int32>;
+
+/**
+ * Grounded action - planning action bound to single effect (e.g. to single context actor) with its preconditions
+ * and cost.
+ */
+struct FGOAPCoreAction
+{
+	/** Index of source action in solver's planning actions. */
+	int32 ActionIndex = INDEX_NONE;
+	FGOAPCoreFact Effect;
+	TArray<FGOAPCoreFact> Preconditions;
+	int32 Cost = 1;
+};
+
+/**
+ * Goal's condition with result precomputed for each value of problem, so numeric comparisons are evaluated once,
+ * during grounding.
+ */
+struct FGOAPCoreCondition
+{
+	int32 Key = INDEX_NONE;
+	/** Bit for each value index - set if condition is met when key has that value. */
+	TBitArray<> SatisfyingValues;
+
+	FORCEINLINE bool IsSatisfied(int32 Value) const
+	{
+		return SatisfyingValues.IsValidIndex(Value) && SatisfyingValues[Value];
+	}
+};
+
+/**
+ * Alternative goal of multi-goal search - its conditions with score of goal.
+ */
+struct FGOAPCoreGoal
+{
+	TArray<FGOAPCoreCondition> Conditions;
+	/** How Conditions are joined. */
+	EGOAPConditionJunction Junction = EGOAPConditionJunction::All;
+	/** Goal's score; plans of goals are compared by Score - PlanCostScoreWeight * PlanCost. */
+	float Score = 0.0f;
+};
+
+/**
+ * Grounded planning problem: initial state, actions and goal described only by indexes. Built by solvers from
+ * planning context (see UGOAPSolver::InternFact) and never modified by searches.
+ */
+struct GOAP_API FGOAPPlanningProblem
+{
+	/** Actual value of each key. */
+	FGOAPCoreState InitialState;
+	/** Index of world state actor for each key (keys of the same actor have the same index). */
+	TArray<int32> KeysActors;
+	/** Grounded actions, in planning actions order. */
+	TArray<FGOAPCoreAction> Actions;
+
+	/** Goal's conditions (used by forward and bidirectional searches). */
+	TArray<FGOAPCoreCondition> Conditions;
+	/** How Conditions are joined. */
+	EGOAPConditionJunction Junction = EGOAPConditionJunction::All;
+	/**
+	 * Sets of facts satisfying goal (used by backward and bidirectional searches), see
+	 * FGOAPGoalPredicate::GetRegressionTargets.
+	 */
+	TArray<TArray<FGOAPCoreFact>> RegressionTargets;
+	/** Indexes of actions achieving each fact, in actions order (used by backward and bidirectional searches). */
+	TMap<FGOAPCoreFact, TArray<int32>> Producers;
+	/** Alternative goals (used by multi-goal search instead of Conditions). */
+	TArray<FGOAPCoreGoal> Goals;
+
+	/** Remove all data (allocations are kept for next problem). */
+	void Reset();
+	/** Number of goal's conditions not met in given state (0 - goal is satisfied), like in FGOAPGoalPredicate. */
+	FORCEINLINE int32 GetUnsatisfiedConditionsNum(const FGOAPCoreState& State) const
+	{
+		return GetUnsatisfiedConditionsNum(Conditions, Junction, State);
+	}
+	/** Number of given conditions not met in given state (0 - conditions are satisfied). */
+	static int32 GetUnsatisfiedConditionsNum(const TArray<FGOAPCoreCondition>& Conditions,
+		EGOAPConditionJunction Junction, const FGOAPCoreState& State);
+	/** Return true if given fact is met in given state. */
+	FORCEINLINE bool IsFactMet(const FGOAPCoreState& State, const FGOAPCoreFact& Fact) const
+	{
+		return State[Fact.Key] == Fact.Value;
+	}
+	/** Return size of memory allocated by problem. */
+	SIZE_T GetAllocatedSize() const;
+
+	/*
+	 * Problem interface used by FGOAPPlanningCore::SearchForward (other problem types, e.g. TGOAPTypedProblem,
+	 * provide the same functions).
+	 */
+	using FState = FGOAPCoreState;
+	FORCEINLINE const FState& GetInitialState() const { return InitialState; }
+	FORCEINLINE int32 GetActionsNum() const { return Actions.Num(); }
+	FORCEINLINE bool IsActionApplicable(const FState& State, int32 ActionIndex) const
+	{
+		for(const FGOAPCoreFact& Precondition : Actions[ActionIndex].Preconditions)
+		{
+			if(!IsFactMet(State, Precondition))
+				return false;
+		}
+		return true;
+	}
+	FORCEINLINE void ApplyAction(FState& State, int32 ActionIndex) const
+	{
+		State[Actions[ActionIndex].Effect.Key] = Actions[ActionIndex].Effect.Value;
+	}
+	FORCEINLINE int32 GetActionCost(int32 ActionIndex) const { return Actions[ActionIndex].Cost; }
+	FORCEINLINE static SIZE_T GetStateAllocatedSize(const FState& State) { return State.GetAllocatedSize(); }
+};
+
+/**
+ * Result of single planning core search.
+ */
+struct FGOAPCoreSearchResult
+{
+	/** Indexes of problem's actions in execution order; empty if goal is already satisfied or plan wasn't found. */
+	TArray<int32> Plan;
+	/** Summary cost of Plan's actions. */
+	int32 PlanCost = 0;
+
+	/** The same meaning as in FGOAPSearchStats. */
+	int32 NodesExpanded = 0;
+	int32 NodesGenerated = 0;
+	int32 NodesDeduplicated = 0;
+	int64 SearchMemory = 0;
+	int32 ForwardFrontierSize = 0;
+	int32 BackwardFrontierSize = 0;
+	int32 NodesReexpanded = 0;
+	/** Index of problem's goal achieved by Plan (multi-goal search only; INDEX_NONE if plan wasn't found). */
+	int32 GoalIndex = INDEX_NONE;
+};
+
+/**
+ * Which not satisfied desired facts (subgoals) of backward search node are expanded.
+ */
+enum class EGOAPSubgoalSelection : uint8
+{
+	/**
+	 * All subgoals; independent subgoals are solved only in one order (partial order pruning), dependent ones in all
+	 * orders.
+	 */
+	All,
+	/**
+	 * Only the most constrained subgoal (with the fewest actions able to solve it), so each set of actions is explored
+	 * in single order and node with subgoal which can't be achieved is dropped at once.
+	 */
+	MostConstrained
+};
+
+/**
+ * Cooperative cancellation of searches running on other threads - searches check it once per expanded node and a
+ * canceled search ends at once without plan (anytime searches keep the best plan found before).
+ */
+struct FGOAPSearchCancellation
+{
+	/** Set to cancel searches at once. */
+	std::atomic<bool> bCanceled{false};
+	/** Time (FPlatformTime::Seconds) when searches are canceled (0 - never). */
+	std::atomic<double> Deadline{0.0};
+
+	/** Return true if searches should end. */
+	bool IsCanceled() const
+	{
+		const double CancelTime = Deadline.load(std::memory_order_relaxed);
+		return bCanceled.load(std::memory_order_relaxed) ||
+			(CancelTime > 0.0 && FPlatformTime::Seconds() >= CancelTime);
+	}
+};
+
+namespace GOAPPlanningCore
+{
+	/**
+	 * Node of forward search tree.
+	 */
+	template<typename StateType>
+	struct TForwardNode
+	{
+		/** World state in this node. */
+		StateType State;
+		/** Index of parent node (INDEX_NONE for initial node). */
+		int32 ParentIndex = INDEX_NONE;
+		/** Problem's action performed to get to this node from the parent. */
+		int32 ActionIndex = INDEX_NONE;
+		/** Total cost of the need to reach this node from init node. */
+		int32 Cost = 0;
+		/** Heuristic (for A*) which is equal to number of not met goal's conditions. */
+		int32 Heuristic = 0;
+
+		/** Return true if this node satisfy goal. */
+		bool IsGoalSatisfiedInNode() const { return Heuristic == 0; }
+		/** Return f(x) value for A* (f(x)=g(x)+h(x)). */
+		int32 GetNodeFx() const { return Cost + Heuristic; }
+		/** Return f(x) value for weighted A* (f(x)=g(x)+w*h(x)). */
+		float GetWeightedNodeFx(float HeuristicWeight) const { return Cost + HeuristicWeight * Heuristic; }
+	};
+
+	/**
+	 * Parameters of single forward search, see EGOAPSearchQuality.
+	 */
+	struct FForwardSearchParams
+	{
+		/** Weight of heuristic in nodes' f(x). */
+		float HeuristicWeight = 1.0f;
+		/**
+		 * Max number of open nodes (0 - no limit). Limited search could cycle forever after dropping nodes leading to
+		 * goal, so nodes repeating state of their ancestor are skipped then.
+		 */
+		int32 BeamWidth = 0;
+		/** Nodes which f(x) (not weighted) isn't lower than this cost are pruned. */
+		int32 CostBound = MAX_int32;
+		/** Time (FPlatformTime::Seconds) when search is aborted (0 - never). */
+		double Deadline = 0.0;
+		/** If true actions of each node are evaluated in parallel (see ExpandForwardNodeParallel). */
+		bool bParallelExpansion = false;
+		/** Cancellation of search (optional). */
+		const FGOAPSearchCancellation* Cancellation = nullptr;
+	};
+
+	/** Return true if given state is state of given node or any of its ancestors. */
+	template<typename StateType>
+	bool IsStateOnPath(const TArray<TForwardNode<StateType>>& Nodes, int32 NodeIndex, const StateType& State)
+	{
+		for(; NodeIndex != INDEX_NONE; NodeIndex = Nodes[NodeIndex].ParentIndex)
+		{
+			if(Nodes[NodeIndex].State == State)
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Create node of given action applied in given node. Return false if action isn't applicable or node is pruned
+	 * (see ExpandForwardNode). Only reads Nodes, so it can be called by many threads at once.
+	 */
+	template<typename ProblemType>
+	bool CreateForwardNode(const ProblemType& Problem, int32 NodeIndex, int32 ActionIndex,
+		const TArray<TForwardNode<typename ProblemType::FState>>& Nodes, int32 CostBound, bool bSkipCycles,
+		TForwardNode<typename ProblemType::FState>& OutNode)
+	{
+		if(!Problem.IsActionApplicable(Nodes[NodeIndex].State, ActionIndex))
+			return false;
+
+		OutNode.State = Nodes[NodeIndex].State;
+		Problem.ApplyAction(OutNode.State, ActionIndex);
+		OutNode.ParentIndex = NodeIndex;
+		OutNode.ActionIndex = ActionIndex;
+		OutNode.Cost = Nodes[NodeIndex].Cost + Problem.GetActionCost(ActionIndex);
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GOAP_Heuristic);
+			OutNode.Heuristic = Problem.GetUnsatisfiedConditionsNum(OutNode.State);
+		}
+		return OutNode.GetNodeFx() < CostBound && !(bSkipCycles && IsStateOnPath(Nodes, NodeIndex, OutNode.State));
+	}
+
+	/**
+	 * Create nodes for all actions applicable in given node and add them to Nodes and OpenNodes. Nodes which f(x)
+	 * isn't lower than CostBound can't lead to plan cheaper than already known one and aren't created.
+	 */
+	template<typename ProblemType>
+	void ExpandForwardNode(const ProblemType& Problem, int32 NodeIndex,
+		TArray<TForwardNode<typename ProblemType::FState>>& Nodes, TArray<int32>& OpenNodes,
+		int32 CostBound = MAX_int32, bool bSkipCycles = false)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_ExpandNode);
+
+		for(int32 ActionIndex = 0; ActionIndex < Problem.GetActionsNum(); ++ActionIndex)
+		{
+			// Nodes can be reallocated by adding new node, so new node is built aside
+			TForwardNode<typename ProblemType::FState> NewNode;
+			if(CreateForwardNode(Problem, NodeIndex, ActionIndex, Nodes, CostBound, bSkipCycles, NewNode))
+			{
+				OpenNodes.Add(Nodes.Add(MoveTemp(NewNode)));
+			}
+		}
+	}
+
+	/** Min number of actions per batch of ExpandForwardNodeParallel; smaller batches aren't worth own task. */
+	static constexpr int32 ParallelExpansionMinBatchActions = 32;
+
+	/**
+	 * ExpandForwardNode with actions evaluated in parallel. Actions are split into batches (up to one per core, of at
+	 * least ParallelExpansionMinBatchActions actions - node with fewer actions is expanded serially); each batch
+	 * creates its nodes in own scratch array of BatchesNodes (kept between expansions to reuse allocated memory) and
+	 * batches are merged in actions order, so nodes are the same and in the same order as of serial expansion,
+	 * regardless of threads timing.
+	 */
+	template<typename ProblemType>
+	void ExpandForwardNodeParallel(const ProblemType& Problem, int32 NodeIndex,
+		TArray<TForwardNode<typename ProblemType::FState>>& Nodes, TArray<int32>& OpenNodes,
+		TArray<TArray<TForwardNode<typename ProblemType::FState>>>& BatchesNodes, int32 CostBound = MAX_int32,
+		bool bSkipCycles = false)
+	{
+		const int32 ActionsNum = Problem.GetActionsNum();
+		const int32 BatchesNum = FMath::Clamp(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1,
+			FMath::Max(ActionsNum / ParallelExpansionMinBatchActions, 1));
+		if(BatchesNum == 1)
+		{
+			ExpandForwardNode(Problem, NodeIndex, Nodes, OpenNodes, CostBound, bSkipCycles);
+			return;
+		}
+
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_ExpandNode);
+		const int32 BatchSize = FMath::DivideAndRoundUp(ActionsNum, BatchesNum);
+		BatchesNodes.SetNum(BatchesNum, EAllowShrinking::No);
+
+		// Nodes are only read until all batches are finished
+		const TArray<TForwardNode<typename ProblemType::FState>>& ParentNodes = Nodes;
+		ParallelFor(BatchesNum, [&](int32 BatchIndex)
+		{
+			TArray<TForwardNode<typename ProblemType::FState>>& BatchNodes = BatchesNodes[BatchIndex];
+			BatchNodes.Reset();
+			const int32 LastActionIndex = FMath::Min((BatchIndex + 1) * BatchSize, ActionsNum);
+			for(int32 ActionIndex = BatchIndex * BatchSize; ActionIndex < LastActionIndex; ++ActionIndex)
+			{
+				TForwardNode<typename ProblemType::FState> NewNode;
+				if(CreateForwardNode(Problem, NodeIndex, ActionIndex, ParentNodes, CostBound, bSkipCycles, NewNode))
+				{
+					BatchNodes.Add(MoveTemp(NewNode));
+				}
+			}
+		});
+
+		for(TArray<TForwardNode<typename ProblemType::FState>>& BatchNodes : BatchesNodes)
+		{
+			for(TForwardNode<typename ProblemType::FState>& NewNode : BatchNodes)
+			{
+				OpenNodes.Add(Nodes.Add(MoveTemp(NewNode)));
+			}
+		}
+	}
+
+	/** Return index of best node (node of min value of weighted A* f(x)=g(x)+w*h(x)). */
+	template<typename StateType>
+	int32 FindBestNode(const TArray<TForwardNode<StateType>>& Nodes, const TArray<int32>& OpenNodes,
+		float HeuristicWeight = 1.0f)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GOAP_SelectNode);
+
+		int32 BestIndex = INDEX_NONE;
+		float MinFx = MAX_flt;
+		for(const int32 NodeIndex : OpenNodes)
+		{
+			const float NodeFx = Nodes[NodeIndex].GetWeightedNodeFx(HeuristicWeight);
+			if(NodeFx < MinFx)
+			{
+				BestIndex = NodeIndex;
+				MinFx = NodeFx;
+			}
+		}
+		return BestIndex;
+	}
+
+	/** Keep only BeamWidth open nodes of min f(x) (the rest is dropped). */
+	template<typename StateType>
+	void LimitOpenNodes(const TArray<TForwardNode<StateType>>& Nodes, TArray<int32>& OpenNodes, int32 BeamWidth,
+		float HeuristicWeight)
+	{
+		if(BeamWidth <= 0 || OpenNodes.Num() <= BeamWidth)
+			return;
+
+		OpenNodes.StableSort([&Nodes, HeuristicWeight](int32 NodeOne, int32 NodeTwo)
+		{
+			return Nodes[NodeOne].GetWeightedNodeFx(HeuristicWeight) <
+				Nodes[NodeTwo].GetWeightedNodeFx(HeuristicWeight);
+		});
+		OpenNodes.SetNum(BeamWidth);
+	}
+
+	/**
+	 * Single A* search from initial state with given parameters. Return true if plan was found (it's set to
+	 * InOutResult); search statistics are added to InOutResult.
+	 */
+	template<typename ProblemType>
+	bool SearchForwardWithParams(const ProblemType& Problem, const FForwardSearchParams& Params,
+		FGOAPCoreSearchResult& InOutResult, const UObject* TraceOwner)
+	{
+		using FNode = TForwardNode<typename ProblemType::FState>;
+
+		TArray<FNode> Nodes;
+		TArray<int32> OpenNodes;
+		TArray<TArray<FNode>> BatchesNodes;
+		const auto Expand = [&](int32 NodeIndex)
+		{
+			if(Params.bParallelExpansion)
+			{
+				ExpandForwardNodeParallel(Problem, NodeIndex, Nodes, OpenNodes, BatchesNodes, Params.CostBound,
+					Params.BeamWidth > 0);
+			}
+			else
+			{
+				ExpandForwardNode(Problem, NodeIndex, Nodes, OpenNodes, Params.CostBound, Params.BeamWidth > 0);
+			}
+		};
+
+		FNode& InitNode = Nodes.AddDefaulted_GetRef();
+		InitNode.State = Problem.GetInitialState();
+		InitNode.Heuristic = Problem.GetUnsatisfiedConditionsNum(InitNode.State);
+
+		int32 CurrentNodeIndex = 0;
+		Expand(CurrentNodeIndex);
+		LimitOpenNodes(Nodes, OpenNodes, Params.BeamWidth, Params.HeuristicWeight);
+		int32 VisitedNodesNum = 1;
+		while(OpenNodes.Num() > 0)
+		{
+			CurrentNodeIndex = FindBestNode(Nodes, OpenNodes, Params.HeuristicWeight);
+			if(Nodes[CurrentNodeIndex].IsGoalSatisfiedInNode())
+				break;
+			if(Params.Deadline > 0.0 && FPlatformTime::Seconds() >= Params.Deadline)
+				break;
+			if(Params.Cancellation && Params.Cancellation->IsCanceled())
+				break;
+			OpenNodes.Remove(CurrentNodeIndex);
+			Expand(CurrentNodeIndex);
+			LimitOpenNodes(Nodes, OpenNodes, Params.BeamWidth, Params.HeuristicWeight);
+
+			if(TraceOwner)
+			{
+				GOAP_TRACE_NODE_VISITED(TraceOwner, VisitedNodesNum, Nodes[CurrentNodeIndex].Cost,
+					Nodes[CurrentNodeIndex].Heuristic);
+			}
+
+			++VisitedNodesNum;
+		}
+		UE_LOG(LogGOAP, Verbose, TEXT("Summary visited nodes number: %d"), VisitedNodesNum);
+
+		InOutResult.NodesExpanded += VisitedNodesNum;
+		InOutResult.NodesGenerated += Nodes.Num();
+		int64 SearchMemory = Nodes.GetAllocatedSize() + OpenNodes.GetAllocatedSize() + BatchesNodes.GetAllocatedSize();
+		for(const FNode& Node : Nodes)
+		{
+			SearchMemory += ProblemType::GetStateAllocatedSize(Node.State);
+		}
+		for(const TArray<FNode>& BatchNodes : BatchesNodes)
+		{
+			SearchMemory += BatchNodes.GetAllocatedSize();
+		}
+		InOutResult.SearchMemory = FMath::Max(InOutResult.SearchMemory, SearchMemory);
+
+		if(!Nodes[CurrentNodeIndex].IsGoalSatisfiedInNode())
+			return false;
+
+		InOutResult.Plan.Reset();
+		InOutResult.PlanCost = Nodes[CurrentNodeIndex].Cost;
+		for(int32 NodeIndex = CurrentNodeIndex; Nodes[NodeIndex].ParentIndex != INDEX_NONE;
+			NodeIndex = Nodes[NodeIndex].ParentIndex)
+		{
+			InOutResult.Plan.Add(Nodes[NodeIndex].ActionIndex);
+		}
+		Algo::Reverse(InOutResult.Plan);
+		return true;
+	}
+
+	/**
+	 * Node on path of iterative deepening search (the only nodes kept in memory).
+	 */
+	template<typename StateType>
+	struct TDepthFirstNode
+	{
+		StateType State;
+		/** Problem's action performed to get to this node from the previous one on path. */
+		int32 ActionIndex = INDEX_NONE;
+		/** Next problem's action to try in this node. */
+		int32 NextActionIndex = 0;
+		/** Total cost of the need to reach this node from init node. */
+		int32 Cost = 0;
+	};
+}
+
+/**
+ * Search algorithms of planning core. All state of search lives on stack of search function, so one core can serve
+ * many agents (and threads) at once.
+ */
+struct GOAP_API FGOAPPlanningCore
+{
+	/** Subgoals expanded by backward search. */
+	EGOAPSubgoalSelection SubgoalSelection = EGOAPSubgoalSelection::MostConstrained;
+	/** Quality of forward and bidirectional searches. */
+	FGOAPSearchSettings SearchSettings;
+	/**
+	 * Cancellation of single goal searches (optional) - lets searches running on other threads be ended early (e.g.
+	 * by portfolio solver when other search found plan first).
+	 */
+	const FGOAPSearchCancellation* Cancellation = nullptr;
+
+	/** Return true if search should end because of Cancellation. */
+	FORCEINLINE bool IsSearchCanceled() const { return Cancellation && Cancellation->IsCanceled(); }
+
+	/**
+	 * A* search from initial state to state satisfying goal's conditions; heuristic is problem's
+	 * GetUnsatisfiedConditionsNum (number of not met conditions, for typed problems divided by the most effects of
+	 * action), so plain A* finds the cheapest plan if action costs are at least 1. SearchSettings select weighted
+	 * A*, beam search or anytime search (repeated weighted A* with decreasing weight, each bounded by cost of the last
+	 * plan) instead and can expand nodes in parallel (for problems with at least
+	 * SearchSettings.ParallelExpansionMinActions actions). Works with any problem type providing FGOAPPlanningProblem's
+	 * problem interface (FGOAPPlanningProblem, TGOAPTypedProblem). TraceOwner is only used to identify search in GOAP
+	 * trace.
+	 */
+	template<typename ProblemType>
+	void SearchForward(const ProblemType& Problem, FGOAPCoreSearchResult& OutResult,
+		const UObject* TraceOwner = nullptr) const;
+	/**
+	 * Iterative deepening A* from initial state - depth first searches bounded by f(x) (heuristic as in
+	 * SearchForward), where each next search has the bound raised to the lowest f(x) exceeding the last one. Only the
+	 * current path is kept, so memory is linear in plan's length (and limited by SearchSettings.MaxSearchMemory) at
+	 * cost of nodes expanded again by each iteration (NodesReexpanded). Found plan is the cheapest one (of plans
+	 * fitting the memory ceiling) if action costs are at least 1. Works with the same problem types as SearchForward.
+	 */
+	template<typename ProblemType>
+	void SearchIterativeDeepening(const ProblemType& Problem, FGOAPCoreSearchResult& OutResult) const;
+	/**
+	 * Regression search for each of problem's regression targets - all plans achieving target are found, actions
+	 * which effects are already met are removed from them and the cheapest plan of all targets is returned.
+	 */
+	void SearchBackward(const FGOAPPlanningProblem& Problem, FGOAPCoreSearchResult& OutResult) const;
+	/**
+	 * Bidirectional search - A* progression from initial state (like SearchForward) and A* regression from problem's
+	 * regression targets (through Producers, which have to contain all actions) at once, expanding the smaller
+	 * frontier. Frontiers are joined where forward state meets all facts of regression state; search ends when no plan
+	 * through frontiers can be cheaper than the best join. Without regression targets it's plain forward search.
+	 * With SearchSettings search ends when the best join costs at most Weight times the lower bound (weighted), each
+	 * frontier keeps only BeamWidth best nodes (beam) or search ends with the best join when time budget is exceeded
+	 * (anytime).
+	 */
+	void SearchBidirectional(const FGOAPPlanningProblem& Problem, FGOAPCoreSearchResult& OutResult) const;
+	/**
+	 * A* from initial state with single frontier shared by all problem's Goals - each expanded node is tested against
+	 * all goals not reached yet and heuristic is the lowest number of not met conditions of them. As nodes are
+	 * expanded in order of f(x), the first node satisfying goal gives its cheapest plan; search ends when no goal not
+	 * reached yet can beat the best Score - PlanCostScoreWeight * PlanCost found so far (or all goals are reached).
+	 * Goals satisfied in initial state are skipped (there is nothing to plan for them).
+	 */
+	void SearchMultiGoal(const FGOAPPlanningProblem& Problem, float PlanCostScoreWeight,
+		FGOAPCoreSearchResult& OutResult) const;
+};
+
+template<typename ProblemType>
+void FGOAPPlanningCore::SearchForward(const ProblemType& Problem, FGOAPCoreSearchResult& OutResult,
+	const UObject* TraceOwner) const
+{
+	OutResult = FGOAPCoreSearchResult();
+	if(Problem.GetUnsatisfiedConditionsNum(Problem.GetInitialState()) == 0)
+	{
+		// goal is satisfied without any actions
+		return;
+	}
+
+	GOAPPlanningCore::FForwardSearchParams Params;
+	Params.Cancellation = Cancellation;
+	Params.bParallelExpansion = SearchSettings.ParallelExpansionMinActions > 0 &&
+		Problem.GetActionsNum() >= SearchSettings.ParallelExpansionMinActions;
+	switch(SearchSettings.Quality)
+	{
+	case EGOAPSearchQuality::Weighted:
+		Params.HeuristicWeight = FMath::Max(SearchSettings.Weight, 1.0f);
+		break;
+	case EGOAPSearchQuality::Beam:
+		Params.BeamWidth = FMath::Max(SearchSettings.BeamWidth, 1);
+		break;
+	case EGOAPSearchQuality::Anytime:
+		{
+			// each next search has lower weight and prunes nodes which can't beat the last plan, so it only looks for
+			// better plan - search which doesn't find one proves the last plan is optimal (as does search of weight 1)
+			const double Deadline = FPlatformTime::Seconds() + SearchSettings.AnytimeTimeBudget;
+			Params.HeuristicWeight = FMath::Max(SearchSettings.AnytimeInitialWeight, 1.0f);
+			while(GOAPPlanningCore::SearchForwardWithParams(Problem, Params, OutResult, TraceOwner) &&
+				Params.HeuristicWeight > 1.0f && FPlatformTime::Seconds() < Deadline)
+			{
+				Params.HeuristicWeight = FMath::Max(Params.HeuristicWeight -
+					FMath::Max(SearchSettings.AnytimeWeightStep, KINDA_SMALL_NUMBER), 1.0f);
+				Params.CostBound = OutResult.PlanCost;
+				Params.Deadline = Deadline;
+			}
+			return;
+		}
+	default:
+		break;
+	}
+	GOAPPlanningCore::SearchForwardWithParams(Problem, Params, OutResult, TraceOwner);
+}
+
+template<typename ProblemType>
+void FGOAPPlanningCore::SearchIterativeDeepening(const ProblemType& Problem, FGOAPCoreSearchResult& OutResult) const
+{
+	using FNode = GOAPPlanningCore::TDepthFirstNode<typename ProblemType::FState>;
+
+	OutResult = FGOAPCoreSearchResult();
+	int32 Threshold = Problem.GetUnsatisfiedConditionsNum(Problem.GetInitialState());
+	if(Threshold == 0)
+	{
+		// goal is satisfied without any actions
+		return;
+	}
+
+	// memory ceiling is converted to max path length (all states have the same size)
+	const int64 NodeSize = sizeof(FNode) + ProblemType::GetStateAllocatedSize(Problem.GetInitialState());
+	const int32 MaxPathLength = SearchSettings.MaxSearchMemory > 0 ?
+		static_cast<int32>(FMath::Max<int64>(SearchSettings.MaxSearchMemory / NodeSize, 2)) : MAX_int32;
+
+	TArray<FNode> Path;
+	int32 PreviousThreshold = INDEX_NONE;
+	bool bFound = false;
+	while(!bFound && Threshold != MAX_int32)
+	{
+		int32 NextThreshold = MAX_int32;
+		Path.Reset();
+		FNode& InitNode = Path.AddDefaulted_GetRef();
+		InitNode.State = Problem.GetInitialState();
+		++OutResult.NodesExpanded;
+		OutResult.NodesReexpanded += PreviousThreshold != INDEX_NONE ? 1 : 0;
+
+		while(Path.Num() > 0 && !bFound)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GOAP_ExpandNode);
+
+			if(IsSearchCanceled())
+				return;
+
+			const int32 NodeIndex = Path.Num() - 1;
+			int32& ActionIndex = Path[NodeIndex].NextActionIndex;
+			while(ActionIndex < Problem.GetActionsNum() &&
+				!Problem.IsActionApplicable(Path[NodeIndex].State, ActionIndex))
+			{
+				++ActionIndex;
+			}
+			if(ActionIndex == Problem.GetActionsNum())
+			{
+				Path.Pop();
+				continue;
+			}
+
+			// Path can be reallocated by adding new node, so new node is built aside
+			FNode NewNode;
+			NewNode.State = Path[NodeIndex].State;
+			Problem.ApplyAction(NewNode.State, ActionIndex);
+			NewNode.ActionIndex = ActionIndex;
+			NewNode.Cost = Path[NodeIndex].Cost + Problem.GetActionCost(ActionIndex);
+			++ActionIndex;
+			++OutResult.NodesGenerated;
+
+			int32 Heuristic;
+			{
+				SCOPE_CYCLE_COUNTER(STAT_GOAP_Heuristic);
+				Heuristic = Problem.GetUnsatisfiedConditionsNum(NewNode.State);
+			}
+			const int32 NodeFx = NewNode.Cost + Heuristic;
+			if(NodeFx > Threshold)
+			{
+				NextThreshold = FMath::Min(NextThreshold, NodeFx);
+				continue;
+			}
+			if(Heuristic == 0)
+			{
+				// nodes are tried in order of f(x) bounds and heuristic never overestimates (for costs of at least 1),
+				// so the first goal within threshold is the cheapest one
+				bFound = true;
+				OutResult.PlanCost = NewNode.Cost;
+				for(int32 PathIndex = 1; PathIndex < Path.Num(); ++PathIndex)
+				{
+					OutResult.Plan.Add(Path[PathIndex].ActionIndex);
+				}
+				OutResult.Plan.Add(NewNode.ActionIndex);
+				break;
+			}
+			// state repeated on path can't lead to cheaper plan
+			if(Path.ContainsByPredicate([&NewNode](const FNode& Node) { return Node.State == NewNode.State; }))
+			{
+				++OutResult.NodesDeduplicated;
+				continue;
+			}
+			if(Path.Num() >= MaxPathLength)
+				continue;
+
+			++OutResult.NodesExpanded;
+			OutResult.NodesReexpanded += NodeFx <= PreviousThreshold ? 1 : 0;
+			OutResult.SearchMemory = FMath::Max<int64>(OutResult.SearchMemory, (Path.Num() + 1) * NodeSize);
+			Path.Add(MoveTemp(NewNode));
+		}
+
+		UE_LOG(LogGOAP, Verbose, TEXT("Iteration with threshold %d: %d nodes expanded in total"), Threshold,
+			OutResult.NodesExpanded);
+		PreviousThreshold = Threshold;
+		Threshold = NextThreshold;
+	}
+}
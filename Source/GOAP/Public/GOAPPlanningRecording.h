@@ -0,0 +1,194 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPTypes.h"
+#include "GOAPGoalPredicate.h"
+#include "UObject/GCObject.h"
+#include "GOAPPlanningRecording.generated.h"
+
+/**
+ * Stand-in for recorded action used during replay. It isn't IGOAPAction - during replay all action queries are
+ * answered by recording.
+ */
+UCLASS()
+class GOAP_API UGOAPRecordedAction : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Name of original action. */
+	UPROPERTY()
+	FString RecordedName;
+};
+
+/**
+ * Planning problem captured during single search: agent, memory, actions, goal and results of all world state reads and
+ * action queries made by solver. Can be saved to compact binary file and replayed by solver without live world
+ * (see UGOAPSolver::ReplayRecording). During replay actors are represented by spawned stand-in actors and actions by
+ * UGOAPRecordedAction objects.
+ */
+struct GOAP_API FGOAPPlanningRecording : public FGCObject
+{
+	/// Recording (used by solver during live search)
+
+	/** Start capturing problem. */
+	void BeginRecording(AActor* Agent, const TArray<AActor*>& Memory, const TArray<UObject*>& Actions,
+		const UClass* SolverClass, const UObject* Goal);
+	/** Store goal's predicate; search of many goals stores predicate of each goal (in goals order). */
+	void RecordGoalPredicate(const FGOAPGoalPredicate& Predicate);
+	/** Store scores of goals planned together (UGOAPSolver::FindPlanForGoals) and weight of plans costs. */
+	void RecordGoalsScores(const TArray<float>& Scores, float InPlanCostScoreWeight);
+	/** Store result of actual world state read. */
+	void RecordWorldStateValue(const FGOAPWorldStateKey& Key, const FGOAPWorldStateValue& Value);
+	/** Store result of IGOAPAction::CanChangeWorldState. */
+	void RecordCanChangeWorldState(UObject* Action, const FGOAPWorldStateData& DesiredWorldState, bool bResult);
+	/** Store result of IGOAPAction::GetWorldStatePreconditions. */
+	void RecordPreconditions(UObject* Action, const FGOAPWorldStateData& ForDesiredWorldState,
+		const TArray<FGOAPWorldStateData>& Preconditions);
+	/** Store result of IGOAPAction::GetActionCost. */
+	void RecordActionCost(UObject* Action, const FGOAPWorldStateData& DesiredWorldState,
+		const TArray<FGOAPWorldStateData>& WithCurrentWorldState, int32 Cost);
+	/** Store result of IGOAPAction::GetActionEffectWithContextActor. */
+	void RecordActionEffect(UObject* Action, AActor* ContextActor, bool bResult, const FGOAPWorldStateData& Effect);
+	/** Store search result and its duration. */
+	void FinishRecording(int32 InPlanLength, int32 InPlanCost, double InSearchTime);
+
+	/// Replay (used by solver during replay; return false if query wasn't recorded)
+
+	bool FindWorldStateValue(const FGOAPWorldStateKey& Key, FGOAPWorldStateValue& OutValue);
+	bool FindCanChangeWorldState(UObject* Action, const FGOAPWorldStateData& DesiredWorldState, bool& bOutResult);
+	bool FindPreconditions(UObject* Action, const FGOAPWorldStateData& ForDesiredWorldState,
+		TArray<FGOAPWorldStateData>& OutPreconditions);
+	bool FindActionCost(UObject* Action, const FGOAPWorldStateData& DesiredWorldState,
+		const TArray<FGOAPWorldStateData>& WithCurrentWorldState, int32& OutCost);
+	bool FindActionEffect(UObject* Action, AActor* ContextActor, bool& bOutResult, FGOAPWorldStateData& OutEffect);
+
+	/** Goal's predicate bound to replay objects (predicate of goal of given index for search of many goals). */
+	const FGOAPGoalPredicate& GetReplayPredicate(int32 GoalIndex = 0) const;
+	FORCEINLINE AActor* GetReplayAgent() const { return Actors.IsValidIndex(AgentIndex) ? Actors[AgentIndex] : nullptr; }
+	FORCEINLINE const TArray<AActor*>& GetReplayMemory() const { return ReplayMemory; }
+	FORCEINLINE const TArray<UObject*>& GetReplayActions() const { return Actions; }
+	/** Number of replay queries which weren't found in recording (replay diverged from recorded search). */
+	FORCEINLINE int32 GetMissedQueriesNum() const { return MissedQueriesNum; }
+	FORCEINLINE void ResetMissedQueriesNum() { MissedQueriesNum = 0; }
+
+	/// Recorded search info
+
+	FORCEINLINE const FString& GetSolverClassPath() const { return SolverClassPath; }
+	FORCEINLINE const FString& GetGoalName() const { return GoalName; }
+	/** Return true if recorded search planned many goals together (UGOAPSolver::FindPlanForGoals). */
+	FORCEINLINE bool IsMultiGoal() const { return bMultiGoal; }
+	FORCEINLINE const TArray<float>& GetGoalsScores() const { return GoalsScores; }
+	FORCEINLINE float GetPlanCostScoreWeight() const { return PlanCostScoreWeight; }
+	FORCEINLINE int32 GetPlanLength() const { return PlanLength; }
+	FORCEINLINE int32 GetPlanCost() const { return PlanCost; }
+	FORCEINLINE double GetSearchTime() const { return SearchTime; }
+	FORCEINLINE int32 GetQueriesNum() const { return Queries.Num(); }
+
+	/// Serialization
+
+	/** Save recording to binary file. */
+	bool SaveToFile(const FString& FilePath);
+	/** Load recording from binary file; stand-in actors are spawned in ReplayWorld. */
+	bool LoadFromFile(const FString& FilePath, UWorld* ReplayWorld);
+
+	// FGCObject implementation
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("FGOAPPlanningRecording"); }
+	// FGCObject implementation
+
+private:
+
+	/**
+	 * Recorded query: query type followed by its arguments encoded as indexes of recorded actors, actions, keys and
+	 * values.
+	 */
+	struct FRecordedQuery
+	{
+		TArray<int32> Data;
+
+		bool operator==(const FRecordedQuery& Other) const { return Data == Other.Data; }
+		friend uint32 GetTypeHash(const FRecordedQuery& Query)
+		{
+			return FCrc::MemCrc32(Query.Data.GetData(), Query.Data.Num() * sizeof(int32));
+		}
+		friend FArchive& operator<<(FArchive& Ar, FRecordedQuery& Query)
+		{
+			return Ar << Query.Data;
+		}
+	};
+
+	enum class EQueryType : int32
+	{
+		WorldStateValue,
+		CanChangeWorldState,
+		Preconditions,
+		ActionCost,
+		ActionEffect
+	};
+
+	/** Return index of given actor; INDEX_NONE if actor isn't known and bAdd is false. */
+	int32 GetActorIndex(AActor* Actor, bool bAdd);
+	/** Return index of given key; INDEX_NONE if key isn't known and bAdd is false. */
+	int32 GetKeyIndex(const FGOAPWorldStateKey& Key, bool bAdd);
+	/** Return index of given value (values are compared, copy is stored); INDEX_NONE if unknown and bAdd is false. */
+	int32 GetValueIndex(UGOAPWorldStatePayload* Value, bool bAdd);
+	/** Append encoded world state data to query data. Return false if data isn't known and bAdd is false. */
+	bool EncodeData(const FGOAPWorldStateData& Data, bool bAdd, TArray<int32>& OutQueryData);
+	/** Decode world state data starting at given index of query data. */
+	FGOAPWorldStateData DecodeData(const TArray<int32>& QueryData, int32 Index) const;
+	/** Build query for given action and data. */
+	bool MakeActionQuery(EQueryType Type, UObject* Action, const FGOAPWorldStateData& Data, bool bAdd,
+		FRecordedQuery& OutQuery);
+	/** Find result of given query during replay. */
+	const TArray<int32>* FindQueryResult(const FRecordedQuery& Query);
+
+	/** Serialize whole recording; during loading stand-in objects are created in ReplayWorld. */
+	bool Serialize(FArchive& Ar, UWorld* ReplayWorld);
+
+	/** Recorded actors (stand-ins during replay) and their names. */
+	TArray<AActor*> Actors;
+	TArray<FString> ActorsNames;
+	TMap<AActor*, int32> ActorsIndexes;
+	int32 AgentIndex = INDEX_NONE;
+	TArray<int32> MemoryIndexes;
+	/** Memory actors used during replay. */
+	TArray<AActor*> ReplayMemory;
+
+	/** Recorded actions (UGOAPRecordedAction during replay) and their names. */
+	TArray<UObject*> Actions;
+	TArray<FString> ActionsNames;
+	TMap<UObject*, int32> ActionsIndexes;
+
+	/** World state keys as actor index and tag. */
+	TArray<int32> KeysActors;
+	TArray<FGameplayTag> KeysTags;
+	TMap<FGOAPWorldStateKey, int32> KeysIndexes;
+
+	/** Unique values (copies of recorded payloads). */
+	TArray<UGOAPWorldStatePayload*> Values;
+	/** Cache of already matched payload objects. */
+	TMap<UGOAPWorldStatePayload*, int32> ValuesIndexes;
+
+	/** Goals' predicates, each encoded as [KeyIndex, Operator, ValueIndex] for each instruction. */
+	TArray<TArray<int32>> PredicatesData;
+	TArray<int32> PredicatesJunctions;
+	TArray<FGOAPGoalPredicate> ReplayPredicates;
+	/** Goals scores and weight of plans costs of search of many goals. */
+	bool bMultiGoal = false;
+	TArray<float> GoalsScores;
+	float PlanCostScoreWeight = 0.0f;
+
+	/** Query results. */
+	TMap<FRecordedQuery, TArray<int32>> Queries;
+	int32 MissedQueriesNum = 0;
+
+	FString SolverClassPath;
+	FString GoalName;
+	int32 PlanLength = 0;
+	int32 PlanCost = 0;
+	double SearchTime = 0.0;
+};
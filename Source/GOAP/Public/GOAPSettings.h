@@ -0,0 +1,51 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "GOAPSettings.generated.h"
+
+/**
+ * Project wide GOAP settings (Project Settings -> Plugins -> GOAP).
+ */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "GOAP"))
+class GOAP_API UGOAPSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPSettings();
+
+	/** Time (in milliseconds) which planner scheduler can spend on updating planners in one frame. */
+	UPROPERTY(config, EditAnywhere, Category = "Scheduler", meta = (ClampMin = 0.01))
+	float SchedulerFrameBudgetMs = 2.0f;
+
+	/**
+	 * Planner update request waiting longer than this time (in seconds) is processed even if frame budget is
+	 * already exhausted. Guarantees that low significance agents are never starved.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Scheduler", meta = (ClampMin = 0.0))
+	float SchedulerMaxRequestWaitTime = 2.0f;
+
+	/** Significance added to request for each second it waits in queue. */
+	UPROPERTY(config, EditAnywhere, Category = "Scheduler", meta = (ClampMin = 0.0))
+	float SchedulerWaitTimeSignificance = 1.0f;
+
+	/**
+	 * Distance from nearest viewer at which distance significance drops to zero. Agents closer to viewer get up to
+	 * SchedulerDistanceSignificance significance.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Scheduler", meta = (ClampMin = 1.0))
+	float SchedulerSignificanceDistance = 5000.0f;
+
+	/** Max significance added to agent standing just next to viewer. */
+	UPROPERTY(config, EditAnywhere, Category = "Scheduler", meta = (ClampMin = 0.0))
+	float SchedulerDistanceSignificance = 1.0f;
+
+	/** Significance added to agents which are in combat. */
+	UPROPERTY(config, EditAnywhere, Category = "Scheduler", meta = (ClampMin = 0.0))
+	float SchedulerCombatSignificance = 2.0f;
+	
+};
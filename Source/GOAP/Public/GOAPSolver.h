@@ -3,10 +3,62 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GOAPPlanningCore.h"
+#include "GOAPTypes.h"
 #include "UObject/NoExportTypes.h"
 #include "GOAPSolver.generated.h"
 
 class UGOAPGoal;
+struct FGOAPGoalPredicate;
+struct FGOAPPlanningRecording;
+
+/**
+ * Statistics of single search for plan.
+ */
+USTRUCT(BlueprintType)
+struct FGOAPSearchStats
+{
+	GENERATED_BODY()
+
+	/** Number of nodes which were expanded (visited). */
+	UPROPERTY(BlueprintReadOnly)
+	int32 NodesExpanded = 0;
+	/** Number of nodes which were created. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 NodesGenerated = 0;
+	/** Number of nodes (or solutions) which were rejected as duplicates. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 NodesDeduplicated = 0;
+	/** Number of actions in found plan (0 if plan wasn't found). */
+	UPROPERTY(BlueprintReadOnly)
+	int32 PlanLength = 0;
+	/** Cost of found plan. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 PlanCost = 0;
+	/** Search duration in seconds. */
+	UPROPERTY(BlueprintReadOnly)
+	double SearchTime = 0.0;
+	/**
+	 * Memory allocated for search nodes and grounded problem (in bytes); for many searches in one query - the biggest
+	 * one.
+	 */
+	UPROPERTY(BlueprintReadOnly)
+	int64 SearchMemory = 0;
+	/** Number of open nodes of forward frontier when search finished (bidirectional solver only). */
+	UPROPERTY(BlueprintReadOnly)
+	int32 ForwardFrontierSize = 0;
+	/** Number of open nodes of backward frontier when search finished (bidirectional solver only). */
+	UPROPERTY(BlueprintReadOnly)
+	int32 BackwardFrontierSize = 0;
+	/**
+	 * Number of nodes expanded again by next iteration of iterative deepening search (included in NodesExpanded) -
+	 * overhead paid for memory linear in plan's length.
+	 */
+	UPROPERTY(BlueprintReadOnly)
+	int32 NodesReexpanded = 0;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FGOAPSearchFinishedDelegate, const class UGOAPSolver*, const FGOAPSearchStats&);
 
 /**
  * Solver for finding solution (plan) for specified problem (goal). Used by BHPlanner.
@@ -24,9 +76,165 @@ public:
 	/** Return complete plan for specified goal. Can return empty array if goal can't be satisfied. */
 	virtual TArray<struct FGOAPActionWithTargetData> FindPlanForGoal(UGOAPGoal* Goal);
 
+	/**
+	 * Return plan for the best of given goals (Scores are theirs scores) - goal of max Score - PlanCostScoreWeight *
+	 * PlanCost of goals which can be achieved; its index is set to OutGoalIndex (INDEX_NONE if none of goals can be
+	 * achieved). All goals are planned by single search with shared frontier (FGOAPPlanningCore::SearchMultiGoal) on
+	 * problem grounded like for forward searches, with solver's actions costs (see UsesSimplifiedActionCost).
+	 */
+	virtual TArray<struct FGOAPActionWithTargetData> FindPlanForGoals(const TArray<UGOAPGoal*>& Goals,
+		const TArray<float>& Scores, float PlanCostScoreWeight, int32& OutGoalIndex);
+
+	/** Return statistics of last FindPlanForGoal call. */
+	FORCEINLINE const FGOAPSearchStats& GetLastSearchStats() const { return LastSearchStats; }
+
+	/** Called after each search of any solver (on game thread); lets tools gather searches statistics. */
+	static FGOAPSearchFinishedDelegate OnSearchFinished;
+
+	/**
+	 * Search for plan for recorded problem instead of live world. Solver doesn't need to be initialized; plan contains
+	 * recording's stand-in objects.
+	 */
+	TArray<struct FGOAPActionWithTargetData> ReplayRecording(FGOAPPlanningRecording& Recording);
+
 protected:
 
+	/*
+	 * Planning context - solvers should access agent, memory, actions and world state only by these functions, so
+	 * searches can be recorded (GOAP.Recording.Enable) and replayed without live world.
+	 */
+	
+	/**
+	 * Return goal's predicate (recorded one during replay). GoalIndex is index of goal in search of many goals, so
+	 * predicates of all goals are recorded and replayed in order.
+	 */
+	const FGOAPGoalPredicate& GetGoalPredicate(UGOAPGoal* Goal, int32 GoalIndex = 0) const;
+	FORCEINLINE AActor* GetPlanningAgent() const { return PlanningAgent; }
+	FORCEINLINE const TArray<AActor*>& GetPlanningMemory() const { return PlanningMemory; }
+	FORCEINLINE const TArray<UObject*>& GetPlanningActions() const { return PlanningActions; }
+	/** Return actual value of given world state. */
+	FGOAPWorldStateValue QueryWorldStateValue(const FGOAPWorldStateKey& Key) const;
+	/** Return true if given world state is currently met. */
+	bool QueryIsWorldStateActual(const FGOAPWorldStateData& DesiredWorldState) const;
+	/** IGOAPAction::CanChangeWorldState of given action. */
+	bool QueryCanChangeWorldState(UObject* Action, const FGOAPWorldStateData& DesiredWorldState) const;
+	/** IGOAPAction::GetWorldStatePreconditions of given action. */
+	TArray<FGOAPWorldStateData> QueryPreconditions(UObject* Action, const FGOAPWorldStateData& ForDesiredWorldState) const;
+	/** IGOAPAction::GetActionCost of given action. */
+	int32 QueryActionCost(UObject* Action, const FGOAPWorldStateData& DesiredWorldState,
+		const TArray<FGOAPWorldStateData>& WithCurrentWorldState) const;
+	/**
+	 * Return summary real cost (IGOAPAction::GetActionCost, evaluated like during grounding) of given plan, so plans
+	 * of solvers with different cost models (e.g. simplified costs of forward solver) can be compared.
+	 */
+	int32 QueryPlanCost(const TArray<struct FGOAPActionWithTargetData>& Plan) const;
+	/** IGOAPAction::GetActionEffectWithContextActor of given action. */
+	bool QueryActionEffect(UObject* Action, AActor* ContextActor, FGOAPWorldStateData& OutEffectWorldState) const;
+
+	/**
+	 * Should be called by solvers at the beginning of search; resets LastSearchStats. Searches which can't be replayed
+	 * (e.g. portfolio, which runs searches of other solvers) should pass bRecordable false.
+	 */
+	void BeginSearch(const UGOAPGoal* Goal, bool bRecordable = true);
+	/** Should be called by solvers after search (when LastSearchStats counters are set); updates stats and traces. */
+	void FinishSearch(int32 PlanLength, int32 PlanCost);
+	/** Copy planning core search statistics to LastSearchStats and finish search. */
+	void FinishSearch(const FGOAPCoreSearchResult& Result);
+
+	/*
+	 * Planning core problem - solvers ground Problem from planning context (all actions queries are made here, on game
+	 * thread), search it by FGOAPPlanningCore and translate found plan back to actions.
+	 */
+
+	/** Remove previous problem (with its keys and values tables). */
+	void ResetProblem();
+	/** Return fact of given world state; its key and value are added to problem's tables if needed. */
+	FGOAPCoreFact InternFact(const FGOAPWorldStateData& WorldState);
+	/** Return world state of given fact. */
+	FGOAPWorldStateData GetFactWorldState(const FGOAPCoreFact& Fact) const;
+	/** Add grounded action (planning action of given index with given effect) to Problem and return its index. */
+	int32 AddProblemAction(int32 ActionIndex, const FGOAPWorldStateData& Effect,
+		const TArray<FGOAPWorldStateData>& Preconditions, int32 Cost);
+	/**
+	 * Add each planning action on each context actor (memory) to Problem, with action's effect, preconditions and cost
+	 * (1 for all actions if bSimplifiedCost is set) - grounding of forward searches.
+	 */
+	void AddActionsOnContextActors(bool bSimplifiedCost);
+	/**
+	 * Read actual values of all problem's keys and compile goal's conditions (if GoalPredicate is given). Has to be
+	 * called after all actions and facts are added.
+	 */
+	void FinalizeProblem(const FGOAPGoalPredicate* GoalPredicate);
+	/**
+	 * Read actual values of all problem's keys and compile conditions of given goals to problem's Goals (with given
+	 * scores). Has to be called after all actions and facts are added.
+	 */
+	void FinalizeProblem(const TArray<const FGOAPGoalPredicate*>& GoalsPredicates, const TArray<float>& Scores);
+	/** Return actions with target data for given plan of planning core. */
+	TArray<struct FGOAPActionWithTargetData> TranslatePlan(const FGOAPCoreSearchResult& Result) const;
+
+	/*
+	 * Search of single goal split into grounding and searching (FindPlanForGoal calls both of them), so portfolio
+	 * solver can ground problems of many solvers on game thread and search them in parallel.
+	 */
+
+	/** Ground Problem for given goal (on game thread, after BeginSearch); return false if solver doesn't support it. */
+	virtual bool BuildProblemForGoal(UGOAPGoal* Goal) { return false; }
+	/**
+	 * Return true if solver searches with cost 1 of all actions instead of their real costs (also in searches of many
+	 * goals).
+	 */
+	virtual bool UsesSimplifiedActionCost() const { return false; }
+	/** Search grounded Problem by PlanningCore; only reads solver's data, so it can be run on any thread. */
+	virtual void SearchProblem(FGOAPCoreSearchResult& OutResult) const {}
+
+	/** Problem of current search. */
+	FGOAPPlanningProblem Problem;
+	/** Search algorithms, shared by all searches. */
+	FGOAPPlanningCore PlanningCore;
+
+	/** Statistics of last search. */
+	FGOAPSearchStats LastSearchStats;
+	/** Time when current search started. */
+	double SearchStartTime = 0.0;
+
 	/** Reference to planner for which this solver is working. */
 	UGOAPPlanner* Planner;
+
+	/** Portfolio solver runs searches of its solvers. */
+	friend class UGOAPSolver_Portfolio;
+
+private:
+
+	/** Planning context of current search. */
+	UPROPERTY()
+	AActor* PlanningAgent = nullptr;
+	UPROPERTY()
+	TArray<AActor*> PlanningMemory;
+	UPROPERTY()
+	TArray<UObject*> PlanningActions;
+
+	/** Return index of given key in problem's tables, add it if needed. */
+	int32 InternKey(const FGOAPWorldStateKey& Key);
+	/** Return index of value equal to given one in problem's tables, add it if needed. */
+	int32 InternValue(UGOAPWorldStatePayload* Payload);
+	/** Read actual values of all problem's keys to its initial state. */
+	void ReadInitialState();
+	/** Compile given predicate's instructions to conditions on problem's keys and values. */
+	void CompileConditions(const FGOAPGoalPredicate& GoalPredicate, TArray<FGOAPCoreCondition>& OutConditions);
+
+	/** Keys, actors and values of Problem (fact's indexes refer to them). */
+	TArray<FGOAPWorldStateKey> ProblemKeys;
+	TMap<FGOAPWorldStateKey, int32> ProblemKeysIndexes;
+	TArray<AActor*> ProblemActors;
+	TArray<UGOAPWorldStatePayload*> ProblemValues;
+
+	/** Recording of current search (if recording is enabled). */
+	TSharedPtr<FGOAPPlanningRecording> ActiveRecording;
+	/** Recording replayed by current search; nullptr when searching in live world. */
+	FGOAPPlanningRecording* ReplayedRecording = nullptr;
+	/** Goals passed to FindPlanForGoal (or FindPlanForGoals) during replay. */
+	UPROPERTY()
+	TArray<UGOAPGoal*> ReplayGoals;
 	
 };
\ No newline at end of file
@@ -0,0 +1,61 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGOAPSearchStats;
+
+/**
+ * Summary statistics of searches of one solver class for one goal class.
+ */
+struct FGOAPSolverRecord
+{
+	/** Number of recorded searches. */
+	int32 SearchesNum = 0;
+	/** Number of searches which found plan. */
+	int32 PlansNum = 0;
+	/** Total time (in seconds) of all searches. */
+	double SearchTime = 0.0;
+	/** Total number of expanded nodes of all searches. */
+	int64 NodesExpanded = 0;
+	/**
+	 * Total real cost (sum of actions' GetActionCost) of found plans - solvers can search with simplified costs, so
+	 * only real costs are comparable across solvers.
+	 */
+	int64 PlanCost = 0;
+
+	/** Return search time per found plan - searches without plan make solver slower (MAX_dbl if none plan found). */
+	double GetTimePerPlan() const { return PlansNum > 0 ? SearchTime / PlansNum : MAX_dbl; }
+	/** Return mean real cost of found plans (MAX_dbl if none plan found). */
+	double GetCostPerPlan() const { return PlansNum > 0 ? static_cast<double>(PlanCost) / PlansNum : MAX_dbl; }
+
+	friend FArchive& operator<<(FArchive& Ar, FGOAPSolverRecord& Record)
+	{
+		return Ar << Record.SearchesNum << Record.PlansNum << Record.SearchTime << Record.NodesExpanded <<
+			Record.PlanCost;
+	}
+};
+
+/**
+ * Searches statistics per goal class and solver class, used by adaptive solver to select solver. Statistics persist
+ * across sessions in Saved/GOAP/SolverStatistics.bin - they are loaded on first use and saved on module shutdown
+ * (or by GOAP.SolverStatistics.Save console command). Game thread only.
+ */
+struct GOAP_API FGOAPSolverStatistics
+{
+	/** Add search of given solver class for given goal class. */
+	static void RecordSearch(const UClass* GoalClass, const UClass* SolverClass, const FGOAPSearchStats& Stats);
+	/** Return statistics of given solver class for given goal class (nullptr if there are no its searches). */
+	static const FGOAPSolverRecord* FindRecord(const UClass* GoalClass, const UClass* SolverClass);
+
+	/** Save statistics if they changed since they were loaded; return false if file can't be written. */
+	static bool Save();
+	/** Remove all statistics (also from file on next save). */
+	static void Reset();
+	/** Print statistics of each goal class and solver class. */
+	static void Dump(FOutputDevice& Ar);
+
+	/** Return path of statistics file. */
+	static FString GetFilePath();
+};
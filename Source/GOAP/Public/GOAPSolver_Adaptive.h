@@ -0,0 +1,69 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPSolver.h"
+#include "GOAPSolver_Adaptive.generated.h"
+
+/**
+ * Adaptive planning - each search is routed to one of SolversClasses, the one which historically finds the best plans
+ * the fastest for goal's class (search time per found plan and mean real plan cost in FGOAPSolverStatistics, weighted
+ * by PlanCostWeight). Each solver is first tried
+ * MinSearchesPerSolver times per goal class and later a random solver is used with ExplorationRate probability, so
+ * statistics follow changes of the game. Statistics persist across sessions, so production learns the best choice.
+ * Solvers are configured by Blueprint subclass.
+ */
+UCLASS(Blueprintable)
+class GOAP_API UGOAPSolver_Adaptive : public UGOAPSolver
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPSolver_Adaptive();
+
+	/** Prepare solver and its solvers to works for specified planner. */
+	virtual void InitializeSolver(class UGOAPPlanner* ForPlanner) override;
+
+	/** Return complete plan for specified goal. Can return empty array if goal can't be satisfied. */
+	virtual TArray<FGOAPActionWithTargetData> FindPlanForGoal(UGOAPGoal* Goal) override;
+
+	/** Return solver used by last search. */
+	FORCEINLINE UGOAPSolver* GetLastSolver() const { return LastSolver; }
+
+protected:
+
+	/** Solvers to choose from. */
+	UPROPERTY(EditDefaultsOnly)
+	TArray<TSubclassOf<UGOAPSolver>> SolversClasses;
+
+	/** Number of searches of each solver for goal class before the fastest one is selected. */
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = 1))
+	int32 MinSearchesPerSolver = 3;
+
+	/** Probability of using random solver instead of the best ranked one. */
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = 0.0, ClampMax = 1.0))
+	float ExplorationRate = 0.05f;
+
+	/**
+	 * Weight of plan quality in solvers ranking. Solver's rank is its time per plan divided by the lowest one plus
+	 * PlanCostWeight * its mean real plan cost divided by the lowest one - solver of the lowest rank is used. 0 - only
+	 * search time is compared.
+	 */
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = 0.0))
+	float PlanCostWeight = 1.0f;
+
+	/** Return solver which should search for plan for given goal. */
+	UGOAPSolver* SelectSolver(const UGOAPGoal* Goal) const;
+
+private:
+
+	/** Instances of SolversClasses. */
+	UPROPERTY()
+	TArray<UGOAPSolver*> Solvers;
+
+	/** Solver used by last search. */
+	UPROPERTY()
+	UGOAPSolver* LastSolver = nullptr;
+};
@@ -0,0 +1,33 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPSolver.h"
+#include "GOAPGoalPredicate.h"
+#include "GOAPSolver_Bidirectional.generated.h"
+
+/**
+ * Bidirectional planning implementation (adapter of FGOAPPlanningCore::SearchBidirectional) - forward search from
+ * actual world state and regression from goal's desired world states meet in the middle, so both of them stay
+ * shallow. Frontiers sizes of last search are reported in search statistics.
+ */
+UCLASS()
+class GOAP_API UGOAPSolver_Bidirectional : public UGOAPSolver
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual bool BuildProblemForGoal(UGOAPGoal* Goal) override;
+	virtual void SearchProblem(FGOAPCoreSearchResult& OutResult) const override;
+
+private:
+
+	/**
+	 * Ground Problem - each action on each context actor with its effect, preconditions and cost (like forward
+	 * solver), actions achieving each fact and goal's regression targets (like backward solver).
+	 */
+	void BuildProblem(const FGOAPGoalPredicate& GoalPredicate,
+		const TArray<TArray<FGOAPWorldStateData>>& RegressionTargets);
+};
@@ -0,0 +1,30 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPSolver.h"
+#include "GOAPGoalPredicate.h"
+#include "GOAPSolver_IterativeDeepening.generated.h"
+
+/**
+ * Memory bounded forward planning implementation (adapter of FGOAPPlanningCore::SearchIterativeDeepening) - search
+ * keeps only the current path instead of all generated nodes, so it suits low memory platforms and large numbers of
+ * agents. Memory ceiling is set by MaxSearchMemory of planner's (or goal's) search settings; nodes expanded again by
+ * each iteration are reported as NodesReexpanded of search statistics.
+ */
+UCLASS()
+class GOAP_API UGOAPSolver_IterativeDeepening : public UGOAPSolver
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual bool BuildProblemForGoal(UGOAPGoal* Goal) override;
+	virtual void SearchProblem(FGOAPCoreSearchResult& OutResult) const override;
+
+private:
+
+	/** Ground Problem - each action on each context actor with its effect, preconditions and cost. */
+	void BuildProblem(const FGOAPGoalPredicate& GoalPredicate);
+};
@@ -0,0 +1,85 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPSolver.h"
+#include "GOAPSolver_Portfolio.generated.h"
+
+/**
+ * Number of searches won by each solver of portfolio (by solver class name).
+ */
+USTRUCT(BlueprintType)
+struct FGOAPPortfolioWins
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	TMap<FName, int32> WinsPerSolver;
+};
+
+/**
+ * Portfolio planning - problems of all SolversClasses are grounded on game thread (in the same frame, so they share
+ * world state snapshot) and then searched in parallel. The first plan found wins and other searches are canceled
+ * cooperatively (or they get BestPlanTimeBudget to find cheaper plan). All searches end after MaxSearchTime even if
+ * none of them found plan. Solver which won is recorded per goal class.
+ * Useful when the best solver depends on goal and can't be predicted ahead of time. Solvers are configured by
+ * Blueprint subclass.
+ */
+UCLASS(Blueprintable)
+class GOAP_API UGOAPSolver_Portfolio : public UGOAPSolver
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPSolver_Portfolio();
+
+	/** Prepare solver and its solvers to works for specified planner. */
+	virtual void InitializeSolver(class UGOAPPlanner* ForPlanner) override;
+
+	/** Return complete plan for specified goal. Can return empty array if goal can't be satisfied. */
+	virtual TArray<FGOAPActionWithTargetData> FindPlanForGoal(UGOAPGoal* Goal) override;
+
+	/** Return solver which plan was used by last search (nullptr if plan wasn't found). */
+	FORCEINLINE UGOAPSolver* GetLastWinner() const { return LastWinner; }
+	/** Return wins of solvers per goal class name. */
+	FORCEINLINE const TMap<FName, FGOAPPortfolioWins>& GetWinsPerGoalClass() const { return WinsPerGoalClass; }
+
+protected:
+
+	/**
+	 * Solvers searching in parallel; they have to support grounding separated from searching (all built-in solvers
+	 * do).
+	 */
+	UPROPERTY(EditDefaultsOnly)
+	TArray<TSubclassOf<UGOAPSolver>> SolversClasses;
+
+	/**
+	 * Time (in seconds) which other searches get to find cheaper plan after the first plan is found (0 - the first
+	 * plan wins at once). Plans are compared by real actions' costs (solvers can use simplified costs).
+	 */
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = 0.0))
+	float BestPlanTimeBudget = 0.0f;
+
+	/**
+	 * Max time (in seconds) of the whole race - searches are canceled after it even if none of them found plan (e.g.
+	 * forward search doesn't end on unreachable goal by itself).
+	 */
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = 0.0001))
+	float MaxSearchTime = 0.05f;
+
+private:
+
+	/** Instances of SolversClasses. */
+	UPROPERTY()
+	TArray<UGOAPSolver*> Solvers;
+
+	/** Solver which plan was used by last search. */
+	UPROPERTY()
+	UGOAPSolver* LastWinner = nullptr;
+
+	/** Wins of solvers per goal class name. */
+	UPROPERTY()
+	TMap<FName, FGOAPPortfolioWins> WinsPerGoalClass;
+};
@@ -0,0 +1,38 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Stats/Stats.h"
+
+/** GOAP stats, use "stat GOAP" console command to see them. */
+DECLARE_STATS_GROUP(TEXT("GOAP"), STATGROUP_GOAP, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Goals scoring"), STAT_GOAP_GoalsScoring, STATGROUP_GOAP, GOAP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find plan"), STAT_GOAP_FindPlan, STATGROUP_GOAP, GOAP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Expand node"), STAT_GOAP_ExpandNode, STATGROUP_GOAP, GOAP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Heuristic"), STAT_GOAP_Heuristic, STATGROUP_GOAP, GOAP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Select node"), STAT_GOAP_SelectNode, STATGROUP_GOAP, GOAP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Prepare solutions"), STAT_GOAP_PrepareSolutions, STATGROUP_GOAP, GOAP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pick best solution"), STAT_GOAP_PickBestSolution, STATGROUP_GOAP, GOAP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Atom update"), STAT_GOAP_AtomUpdate, STATGROUP_GOAP, GOAP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Plan execution"), STAT_GOAP_PlanExecution, STATGROUP_GOAP, GOAP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scheduler update"), STAT_GOAP_SchedulerUpdate, STATGROUP_GOAP, GOAP_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Searches"), STAT_GOAP_Searches, STATGROUP_GOAP, GOAP_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nodes expanded"), STAT_GOAP_NodesExpanded, STATGROUP_GOAP, GOAP_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nodes generated"), STAT_GOAP_NodesGenerated, STATGROUP_GOAP, GOAP_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nodes deduplicated"), STAT_GOAP_NodesDeduplicated, STATGROUP_GOAP, GOAP_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Scheduler queue depth"), STAT_GOAP_SchedulerQueueDepth, STATGROUP_GOAP, GOAP_API);
+
+/**
+ * GOAP Low-Level Memory tracker tags, run with -llm and use "stat LLMFULL" console command to see them. GOAP tag
+ * covers planners and goals, child tags cover solvers' search nodes, world state payloads, memory components with
+ * world state providers and atoms, and executed plans.
+ */
+LLM_DECLARE_TAG_API(GOAP, GOAP_API);
+LLM_DECLARE_TAG_API(GOAP_Solver, GOAP_API);
+LLM_DECLARE_TAG_API(GOAP_Payloads, GOAP_API);
+LLM_DECLARE_TAG_API(GOAP_Memory, GOAP_API);
+LLM_DECLARE_TAG_API(GOAP_Plans, GOAP_API);
@@ -0,0 +1,44 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+struct FGOAPSearchStats;
+
+#define GOAP_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+#if GOAP_TRACE_ENABLED
+
+/** Trace channel for GOAP search events, enable it by -trace=GOAP (or "Trace.Enable GOAP" console command). */
+UE_TRACE_CHANNEL_EXTERN(GOAPChannel, GOAP_API);
+
+/**
+ * Emits GOAP search events to Unreal Insights.
+ */
+struct GOAP_API FGOAPTrace
+{
+	/** Return true if GOAP trace channel is enabled. */
+	static bool IsEnabled();
+	
+	static void OutputSearchStarted(const UObject* Solver, const UObject* Goal);
+	static void OutputNodeVisited(const UObject* Solver, int32 VisitedNodesNum, int32 Cost, int32 Heuristic);
+	static void OutputSearchFinished(const UObject* Solver, const FGOAPSearchStats& Stats);
+};
+
+#define GOAP_TRACE_SEARCH_STARTED(Solver, Goal) \
+	do { if(FGOAPTrace::IsEnabled()) { FGOAPTrace::OutputSearchStarted(Solver, Goal); } } while(0)
+#define GOAP_TRACE_NODE_VISITED(Solver, VisitedNodesNum, Cost, Heuristic) \
+	do { if(FGOAPTrace::IsEnabled()) { FGOAPTrace::OutputNodeVisited(Solver, VisitedNodesNum, Cost, Heuristic); } } \
+	while(0)
+#define GOAP_TRACE_SEARCH_FINISHED(Solver, Stats) \
+	do { if(FGOAPTrace::IsEnabled()) { FGOAPTrace::OutputSearchFinished(Solver, Stats); } } while(0)
+
+#else
+
+#define GOAP_TRACE_SEARCH_STARTED(Solver, Goal) do {} while(0)
+#define GOAP_TRACE_NODE_VISITED(Solver, VisitedNodesNum, Cost, Heuristic) do {} while(0)
+#define GOAP_TRACE_SEARCH_FINISHED(Solver, Stats) do {} while(0)
+
+#endif
@@ -0,0 +1,310 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GOAPPlanningCore.h"
+#include <type_traits>
+
+/*
+ * Compile-time typed world state schemas for domains written in C++. Keys and their value types are declared as
+ * types, so state is fixed-size bit-packed struct, key indexes and offsets are constants and state comparison, hashing
+ * and applying effects are few word operations. Typed problems are searched by the same FGOAPPlanningCore as grounded
+ * (dynamic) ones, e.g.:
+ *
+ *	struct FHasWeapon : TGOAPSchemaKey<bool> {};
+ *	struct FAmmo : TGOAPSchemaKey<uint8, 4> {};
+ *	using FSoldierSchema = TGOAPSchema<FHasWeapon, FAmmo>;
+ *
+ *	FSoldierSchema::FProblem Problem;
+ *	Problem.InitialState.Set<FAmmo>(0);
+ *	auto& Reload = Problem.Actions.AddDefaulted_GetRef();
+ *	Reload.Preconditions.Add<FHasWeapon>(true);
+ *	Reload.Effects.Add<FAmmo>(8);
+ *	Problem.Goal.Add<FAmmo>(8);
+ *	Problem.FinalizeProblem();
+ *	FGOAPPlanningCore().SearchForward(Problem, Result);
+ */
+
+/**
+ * Key of typed schema - derive from it to declare key. ValueType has to be bool, integer or enum type; values are
+ * stored on Bits bits, so they have to be non-negative and fit in them.
+ */
+template<typename InValueType, uint32 InBits = std::is_same_v<InValueType, bool> ? 1 : sizeof(InValueType) * 8>
+struct TGOAPSchemaKey
+{
+	static_assert(std::is_integral_v<InValueType> || std::is_enum_v<InValueType>,
+		"Schema key's value has to be bool, integer or enum.");
+	static_assert(InBits > 0 && InBits <= 64, "Schema key's value has to be stored on 1-64 bits.");
+
+	using ValueType = InValueType;
+	static constexpr uint32 Bits = InBits;
+};
+
+namespace GOAPTypedSchema
+{
+	/**
+	 * Layout of schema's state - offset (in bits) and mask of each key. Keys never straddle 64-bit words, so each one
+	 * is read by single shift and mask.
+	 */
+	template<int32 KeysNum>
+	struct TLayout
+	{
+		uint32 Offsets[KeysNum] = {};
+		uint64 Masks[KeysNum] = {};
+		int32 WordsNum = 0;
+	};
+
+	template<int32 KeysNum>
+	constexpr TLayout<KeysNum> MakeLayout(const uint32 (&KeysBits)[KeysNum])
+	{
+		TLayout<KeysNum> Layout;
+		uint32 Offset = 0;
+		for(int32 KeyIndex = 0; KeyIndex < KeysNum; ++KeyIndex)
+		{
+			if(Offset % 64 + KeysBits[KeyIndex] > 64)
+			{
+				Offset += 64 - Offset % 64;
+			}
+			Layout.Offsets[KeyIndex] = Offset;
+			Layout.Masks[KeyIndex] = KeysBits[KeyIndex] == 64 ? ~0ull : (1ull << KeysBits[KeyIndex]) - 1;
+			Offset += KeysBits[KeyIndex];
+		}
+		Layout.WordsNum = static_cast<int32>((Offset + 63) / 64);
+		return Layout;
+	}
+
+	/** Return index of KeyType in KeyTypes or INDEX_NONE. */
+	template<typename KeyType, typename... KeyTypes>
+	constexpr int32 IndexOf()
+	{
+		constexpr bool Matches[] = { std::is_same_v<KeyType, KeyTypes>... };
+		for(int32 Index = 0; Index < static_cast<int32>(sizeof...(KeyTypes)); ++Index)
+		{
+			if(Matches[Index])
+				return Index;
+		}
+		return INDEX_NONE;
+	}
+}
+
+template<typename SchemaType> struct TGOAPSchemaState;
+template<typename SchemaType> struct TGOAPSchemaFacts;
+template<typename SchemaType> struct TGOAPTypedProblem;
+
+/**
+ * World state schema - list of keys (types derived from TGOAPSchemaKey).
+ */
+template<typename... KeyTypes>
+struct TGOAPSchema
+{
+	static_assert(sizeof...(KeyTypes) > 0, "Schema needs at least one key.");
+
+	static constexpr int32 KeysNum = sizeof...(KeyTypes);
+	static constexpr uint32 KeysBits[] = { KeyTypes::Bits... };
+	static constexpr GOAPTypedSchema::TLayout<KeysNum> Layout = GOAPTypedSchema::MakeLayout(KeysBits);
+
+	/** Return index of given key (compilation error if key isn't part of this schema). */
+	template<typename KeyType>
+	static constexpr int32 IndexOf()
+	{
+		constexpr int32 KeyIndex = GOAPTypedSchema::IndexOf<KeyType, KeyTypes...>();
+		static_assert(KeyIndex != INDEX_NONE, "Key isn't part of schema.");
+		return KeyIndex;
+	}
+
+	using FState = TGOAPSchemaState<TGOAPSchema>;
+	using FFacts = TGOAPSchemaFacts<TGOAPSchema>;
+	using FProblem = TGOAPTypedProblem<TGOAPSchema>;
+};
+
+/**
+ * Complete world state of schema, bit-packed into 64-bit words.
+ */
+template<typename SchemaType>
+struct TGOAPSchemaState
+{
+	static constexpr int32 WordsNum = SchemaType::Layout.WordsNum;
+
+	uint64 Words[WordsNum] = {};
+
+	template<typename KeyType>
+	FORCEINLINE typename KeyType::ValueType Get() const
+	{
+		return static_cast<typename KeyType::ValueType>(GetBits(SchemaType::template IndexOf<KeyType>()));
+	}
+
+	template<typename KeyType>
+	FORCEINLINE void Set(typename KeyType::ValueType Value)
+	{
+		SetBits(SchemaType::template IndexOf<KeyType>(), static_cast<uint64>(Value));
+	}
+
+	/** Return raw bits of key of given index. */
+	FORCEINLINE uint64 GetBits(int32 KeyIndex) const
+	{
+		const uint32 Offset = SchemaType::Layout.Offsets[KeyIndex];
+		return (Words[Offset / 64] >> (Offset % 64)) & SchemaType::Layout.Masks[KeyIndex];
+	}
+
+	/** Set raw bits of key of given index. */
+	FORCEINLINE void SetBits(int32 KeyIndex, uint64 Bits)
+	{
+		const uint32 Offset = SchemaType::Layout.Offsets[KeyIndex];
+		const uint64 Mask = SchemaType::Layout.Masks[KeyIndex];
+		uint64& Word = Words[Offset / 64];
+		Word = (Word & ~(Mask << (Offset % 64))) | ((Bits & Mask) << (Offset % 64));
+	}
+
+	FORCEINLINE bool operator==(const TGOAPSchemaState& Other) const
+	{
+		for(int32 WordIndex = 0; WordIndex < WordsNum; ++WordIndex)
+		{
+			if(Words[WordIndex] != Other.Words[WordIndex])
+				return false;
+		}
+		return true;
+	}
+	FORCEINLINE bool operator!=(const TGOAPSchemaState& Other) const { return !(*this == Other); }
+
+	friend FORCEINLINE uint32 GetTypeHash(const TGOAPSchemaState& State)
+	{
+		uint32 Hash = ::GetTypeHash(State.Words[0]);
+		for(int32 WordIndex = 1; WordIndex < WordsNum; ++WordIndex)
+		{
+			Hash = HashCombine(Hash, ::GetTypeHash(State.Words[WordIndex]));
+		}
+		return Hash;
+	}
+};
+
+/**
+ * Set of key values of schema (action's preconditions or effects, goal) - mask of used keys with their values.
+ */
+template<typename SchemaType>
+struct TGOAPSchemaFacts
+{
+	using FState = TGOAPSchemaState<SchemaType>;
+
+	/** All bits of used keys are set. */
+	FState Mask;
+	FState Values;
+
+	template<typename KeyType>
+	TGOAPSchemaFacts& Add(typename KeyType::ValueType Value)
+	{
+		constexpr int32 KeyIndex = SchemaType::template IndexOf<KeyType>();
+		Mask.SetBits(KeyIndex, SchemaType::Layout.Masks[KeyIndex]);
+		Values.template Set<KeyType>(Value);
+		return *this;
+	}
+
+	/** Return true if all facts are met in given state. */
+	FORCEINLINE bool IsMetIn(const FState& State) const
+	{
+		for(int32 WordIndex = 0; WordIndex < FState::WordsNum; ++WordIndex)
+		{
+			if((State.Words[WordIndex] & Mask.Words[WordIndex]) != Values.Words[WordIndex])
+				return false;
+		}
+		return true;
+	}
+
+	/** Set all facts in given state. */
+	FORCEINLINE void ApplyTo(FState& State) const
+	{
+		for(int32 WordIndex = 0; WordIndex < FState::WordsNum; ++WordIndex)
+		{
+			State.Words[WordIndex] = (State.Words[WordIndex] & ~Mask.Words[WordIndex]) | Values.Words[WordIndex];
+		}
+	}
+
+	/** Return number of keys which values in given state differ from facts. */
+	int32 GetUnmetNum(const FState& State) const
+	{
+		int32 UnmetNum = 0;
+		for(int32 KeyIndex = 0; KeyIndex < SchemaType::KeysNum; ++KeyIndex)
+		{
+			if(Mask.GetBits(KeyIndex) != 0 && State.GetBits(KeyIndex) != Values.GetBits(KeyIndex))
+			{
+				++UnmetNum;
+			}
+		}
+		return UnmetNum;
+	}
+
+	/** Return number of used keys. */
+	int32 GetNum() const
+	{
+		int32 Num = 0;
+		for(int32 KeyIndex = 0; KeyIndex < SchemaType::KeysNum; ++KeyIndex)
+		{
+			Num += Mask.GetBits(KeyIndex) != 0 ? 1 : 0;
+		}
+		return Num;
+	}
+};
+
+/**
+ * Planning problem of typed schema, searched by FGOAPPlanningCore::SearchForward. Goal is conjunction of equalities;
+ * domains needing other comparisons or backward search use grounded FGOAPPlanningProblem (dynamic path).
+ */
+template<typename SchemaType>
+struct TGOAPTypedProblem
+{
+	using FState = TGOAPSchemaState<SchemaType>;
+	using FFacts = TGOAPSchemaFacts<SchemaType>;
+
+	/**
+	 * Action of typed problem; unlike grounded actions it can have many effects.
+	 */
+	struct FAction
+	{
+		/** Project's identifier of action (e.g. index in its actions table), not used by search. */
+		int32 ActionIndex = INDEX_NONE;
+		FFacts Preconditions;
+		FFacts Effects;
+		int32 Cost = 1;
+	};
+
+	FState InitialState;
+	TArray<FAction> Actions;
+	FFacts Goal;
+	/**
+	 * The most effects of single action, set by FinalizeProblem. One action can set many unmet goal's keys, so
+	 * heuristic divides number of unmet keys by it - without that search could overestimate the remaining cost and
+	 * miss the cheapest plan. Defaults to number of schema's keys (always admissible, but weak).
+	 */
+	int32 MaxEffectsNum = SchemaType::KeysNum;
+
+	/** Prepare heuristic for actions of problem - call after all actions are added. */
+	void FinalizeProblem()
+	{
+		MaxEffectsNum = 1;
+		for(const FAction& Action : Actions)
+		{
+			MaxEffectsNum = FMath::Max(MaxEffectsNum, Action.Effects.GetNum());
+		}
+	}
+
+	/*
+	 * Problem interface used by FGOAPPlanningCore::SearchForward (see FGOAPPlanningProblem).
+	 */
+	FORCEINLINE const FState& GetInitialState() const { return InitialState; }
+	FORCEINLINE int32 GetActionsNum() const { return Actions.Num(); }
+	FORCEINLINE bool IsActionApplicable(const FState& State, int32 ActionIndex) const
+	{
+		return Actions[ActionIndex].Preconditions.IsMetIn(State);
+	}
+	FORCEINLINE void ApplyAction(FState& State, int32 ActionIndex) const { Actions[ActionIndex].Effects.ApplyTo(State); }
+	FORCEINLINE int32 GetActionCost(int32 ActionIndex) const { return Actions[ActionIndex].Cost; }
+	/**
+	 * Lower bound of number of actions needed to satisfy goal (0 - goal is satisfied), so heuristic is admissible
+	 * for action costs of at least 1.
+	 */
+	FORCEINLINE int32 GetUnsatisfiedConditionsNum(const FState& State) const
+	{
+		return (Goal.GetUnmetNum(State) + MaxEffectsNum - 1) / MaxEffectsNum;
+	}
+	FORCEINLINE static SIZE_T GetStateAllocatedSize(const FState& State) { return 0; }
+};
@@ -92,3 +92,79 @@ struct FGOAPWorldStateData
 	FGOAPWorldStateValue WorldStateValue;
 };
 
+
+/**
+ * Trade-off between plan's cost and search's cost.
+ */
+UENUM(BlueprintType)
+enum class EGOAPSearchQuality : uint8
+{
+	/** A* - the cheapest plan is found. */
+	Optimal,
+	/** Weighted A* - heuristic is multiplied by Weight, so found plan costs at most Weight times the cheapest one. */
+	Weighted,
+	/**
+	 * Only BeamWidth best open nodes are kept - search uses bounded memory, but plan can be far from the cheapest one
+	 * (or not found at all).
+	 */
+	Beam,
+	/**
+	 * Anytime repairing A* - first plan is found quickly by weighted A* (AnytimeInitialWeight) and then improved with
+	 * decreasing weight while AnytimeTimeBudget remains.
+	 */
+	Anytime
+};
+
+/**
+ * Quality settings of forward and bidirectional searches (backward search always enumerates all plans) and memory
+ * ceiling of iterative deepening search and parallel expansion of forward search. Set per planner and optionally
+ * overridden per goal class.
+ */
+USTRUCT(BlueprintType)
+struct FGOAPSearchSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EGOAPSearchQuality Quality = EGOAPSearchQuality::Optimal;
+
+	/** Heuristic weight of weighted A* - upper bound of found plan's cost relatively to the cheapest plan. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 1.0,
+		EditCondition = "Quality == EGOAPSearchQuality::Weighted"))
+	float Weight = 2.0f;
+
+	/** Max number of open nodes (of each frontier) of beam search. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 1,
+		EditCondition = "Quality == EGOAPSearchQuality::Beam"))
+	int32 BeamWidth = 16;
+
+	/** Heuristic weight of first anytime search. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 1.0,
+		EditCondition = "Quality == EGOAPSearchQuality::Anytime"))
+	float AnytimeInitialWeight = 3.0f;
+	/** Weight is decreased by this value after each plan found by anytime search, until it reaches 1 (optimal). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0.01,
+		EditCondition = "Quality == EGOAPSearchQuality::Anytime"))
+	float AnytimeWeightStep = 0.5f;
+	/**
+	 * Time (in seconds) in which anytime search improves its plan; the first plan is always searched till the end.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0.0,
+		EditCondition = "Quality == EGOAPSearchQuality::Anytime"))
+	float AnytimeTimeBudget = 0.002f;
+
+	/**
+	 * Max memory (in bytes) of iterative deepening search (0 - no limit). Its memory is linear in plan's length, so
+	 * the ceiling limits length of plans which can be found.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0))
+	int32 MaxSearchMemory = 0;
+
+	/**
+	 * Min number of grounded actions for which forward search evaluates actions of each expanded node in parallel
+	 * (0 - always serially). Nodes are merged in actions order, so plans don't depend on threads timing; parallel
+	 * expansion pays off only for many actions (e.g. many actions on many context actors).
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = 0))
+	int32 ParallelExpansionMinActions = 0;
+};
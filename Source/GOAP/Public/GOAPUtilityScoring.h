@@ -0,0 +1,104 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Curves/CurveFloat.h"
+#include "GOAPUtilityScoring.generated.h"
+
+class UGOAPGoal;
+
+/**
+ * Shape of response curve which maps normalized input value to score.
+ */
+UENUM(BlueprintType)
+enum class EGOAPResponseCurveType : uint8
+{
+	/** Slope * (x - XShift) + YShift */
+	Linear,
+	/** Slope * (x - XShift)^Exponent + YShift */
+	Polynomial,
+	/** 1 / (1 + e^(-Slope * (x - XShift))) + YShift */
+	Logistic,
+	/** Value of CustomCurve for x. */
+	Custom
+};
+
+/**
+ * One input of native goal score - agent's world state value passed through response curve.
+ */
+USTRUCT(BlueprintType)
+struct FGOAPUtilityConsideration
+{
+	GENERATED_BODY()
+
+	/** Tag of agent's world state data used as input. Data has to be numeric (bool, int or float payload). */
+	UPROPERTY(EditDefaultsOnly)
+	FGameplayTag WorldStateTag;
+
+	/** Input value mapped to 0. Values out of <InputMin,InputMax> range are clamped. */
+	UPROPERTY(EditDefaultsOnly)
+	float InputMin = 0.0f;
+	/** Input value mapped to 1. Values out of <InputMin,InputMax> range are clamped. */
+	UPROPERTY(EditDefaultsOnly)
+	float InputMax = 1.0f;
+
+	/** Shape of response curve. */
+	UPROPERTY(EditDefaultsOnly)
+	EGOAPResponseCurveType CurveType = EGOAPResponseCurveType::Linear;
+	/** Curve parameters, see EGOAPResponseCurveType. */
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "CurveType != EGOAPResponseCurveType::Custom"))
+	float Slope = 1.0f;
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "CurveType == EGOAPResponseCurveType::Polynomial"))
+	float Exponent = 2.0f;
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "CurveType != EGOAPResponseCurveType::Custom"))
+	float XShift = 0.0f;
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "CurveType != EGOAPResponseCurveType::Custom"))
+	float YShift = 0.0f;
+	/** Response curve used if CurveType is Custom. Should map <0,1> to <0,1>. */
+	UPROPERTY(EditDefaultsOnly, meta = (EditCondition = "CurveType == EGOAPResponseCurveType::Custom"))
+	FRuntimeFloatCurve CustomCurve;
+
+	/** Importance of this consideration in relation to other goal's considerations. */
+	UPROPERTY(EditDefaultsOnly, meta = (ClampMin = 0.0))
+	float Weight = 1.0f;
+};
+
+/** Return numeric value of agent's world state data of given tag (false if data is missing or isn't numeric). */
+using FGOAPUtilityInputReader = TFunctionRef<bool(const FGameplayTag&, double&)>;
+
+/**
+ * Evaluates native (utility) scores of many goals at once. Data of all considerations is stored as structure of
+ * arrays, so each evaluation step is one tight loop over all considerations of all goals in batch.
+ */
+struct GOAP_API FGOAPUtilityScoringBatch
+{
+	/** Remove all goals from batch (keeps allocated memory). */
+	void Reset();
+	/** Add goal's considerations to batch, gathering input values from goal's agent world state. Return goal index in batch. */
+	int32 AddGoal(UGOAPGoal* Goal);
+	/** Add goal of given considerations to batch, gathering input values by InputReader. Return goal index in batch. */
+	int32 AddGoal(const TArray<FGOAPUtilityConsideration>& Considerations, FGOAPUtilityInputReader InputReader);
+	/** Return number of goals in batch. */
+	FORCEINLINE int32 Num() const { return GoalsFirstConsideration.Num(); }
+	/** Evaluate scores of all goals in batch; OutScores[i] is score of goal of index i (in range <0,1>). */
+	void Evaluate(TArray<float>& OutScores) const;
+
+private:
+
+	/** Per consideration data. */
+	TArray<float> Inputs;
+	TArray<float> InputsMin;
+	TArray<float> InputsInvRange;
+	TArray<float> Slopes;
+	TArray<float> Exponents;
+	TArray<float> XShifts;
+	TArray<float> YShifts;
+	TArray<float> Weights;
+	TArray<EGOAPResponseCurveType> CurveTypes;
+	TArray<const FRuntimeFloatCurve*> CustomCurves;
+
+	/** Per goal index of first consideration; goal's considerations are stored continuously. */
+	TArray<int32> GoalsFirstConsideration;
+};
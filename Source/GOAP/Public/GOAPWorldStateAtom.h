@@ -29,6 +29,16 @@ public:
 
 protected:
 
+	/**
+	 * Inform owning provider that data represented by this atom has changed. Call it each time when checked actor's
+	 * parameter changes, so event driven planners can react to it.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void NotifyWorldStateChanged();
+
+	/** Return reference to atom's value, so native atoms can update it in UpdateWorldStateAtomData. */
+	FORCEINLINE FGOAPWorldStateValue& GetWorldStateValueRef() { return WorldStateValue; }
+
 	/** Tag which identify which type of data is this atom return. */
 	UPROPERTY(EditDefaultsOnly)
 	FGameplayTag WorldStateAtomTag;
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GOAPStats.h"
 #include "GOAPTypes.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "GOAPWorldStateFunctionLibrary.generated.h"
@@ -48,6 +49,7 @@ public:
 		// There isn't payload object or is of other type - create new payload and set value
 		else
 		{
+			LLM_SCOPE_BYTAG(GOAP_Payloads);
 			UGOAPWorldStatePayload* Payload = NewObject<UGOAPWorldStatePayload>(GetTransientPackage(), PayloadType);
 			Payload->SetPayloadValueFromRawData(&InValue);
 			WorldStateValue.Payload = Payload;
@@ -26,6 +26,9 @@ public:
 	
 	/** Check if given payload has the same value as this payload. */
 	virtual bool IsEqual(UGOAPWorldStatePayload* OtherPayload) PURE_VIRTUAL(UBHWorldStatePayload::IsEqual, return false; ); 
+
+	/** Return true if payload value can be represented as number and if so return it in OutValue. */
+	virtual bool GetNumericValue(double& OutValue) const { return false; }
 	
 	/** Return true if given world state value is of given type. */
 	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
@@ -42,7 +45,7 @@ public:
  * Payload to store a bool variable.
  */
 UCLASS()
-class UGOAPWorldStatePayloadBool : public UGOAPWorldStatePayload
+class GOAP_API UGOAPWorldStatePayloadBool : public UGOAPWorldStatePayload
 {
 	GENERATED_BODY()
 
@@ -62,6 +65,11 @@ public:
 			return false;
 		return Value == Other->Value;
 	}
+	virtual bool GetNumericValue(double& OutValue) const override
+	{
+		OutValue = Value ? 1.0 : 0.0;
+		return true;
+	}
 	
 	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
 	static bool GetPayloadValue(FGOAPWorldStateValue WorldStateValue)
@@ -79,7 +87,7 @@ public:
  * Payload to store a int32 variable.
  */
 UCLASS()
-class UGOAPWorldStatePayloadInt : public UGOAPWorldStatePayload
+class GOAP_API UGOAPWorldStatePayloadInt : public UGOAPWorldStatePayload
 {
 	GENERATED_BODY()
 
@@ -99,6 +107,11 @@ public:
 			return false;
 		return Value == Other->Value;
 	}
+	virtual bool GetNumericValue(double& OutValue) const override
+	{
+		OutValue = Value;
+		return true;
+	}
 
 	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
 	static int32 GetPayloadValue(FGOAPWorldStateValue WorldStateValue)
@@ -118,7 +131,7 @@ public:
  * variable is really of type double.
  */
 UCLASS()
-class UGOAPWorldStatePayloadFloat : public UGOAPWorldStatePayload
+class GOAP_API UGOAPWorldStatePayloadFloat : public UGOAPWorldStatePayload
 {
 	GENERATED_BODY()
 	
@@ -138,6 +151,11 @@ public:
 			return false;
 		return Value == Other->Value;
 	}
+	virtual bool GetNumericValue(double& OutValue) const override
+	{
+		OutValue = Value;
+		return true;
+	}
 
 	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
 	static double GetPayloadValue(FGOAPWorldStateValue WorldStateValue)
@@ -183,7 +201,7 @@ public:
  * Payload to store a FVector variable.
  */
 UCLASS()
-class UGOAPWorldStatePayloadVector : public UGOAPWorldStatePayload
+class GOAP_API UGOAPWorldStatePayloadVector : public UGOAPWorldStatePayload
 {
 	GENERATED_BODY()
 	
@@ -220,7 +238,7 @@ public:
  * Payload to store a FString variable.
  */
 UCLASS()
-class UGOAPWorldStatePayloadString : public UGOAPWorldStatePayload
+class GOAP_API UGOAPWorldStatePayloadString : public UGOAPWorldStatePayload
 {
 	GENERATED_BODY()
 	
@@ -257,7 +275,7 @@ public:
  * Payload to store a AActor reference.
  */
 UCLASS()
-class UGOAPWorldStatePayloadActor : public UGOAPWorldStatePayload
+class GOAP_API UGOAPWorldStatePayloadActor : public UGOAPWorldStatePayload
 {
 	GENERATED_BODY()
 	
@@ -8,6 +8,8 @@
 #include "Components/ActorComponent.h"
 #include "GOAPWorldStateProvider.generated.h"
 
+DECLARE_MULTICAST_DELEGATE_TwoParams(FWorldStateChangedDelegate, AActor*, const FGameplayTag&);
+
 /**
 * Each actor which can be considered by planner need has this component. Contains all world state data associated
 * with owner actor. Manage world state atoms.
@@ -21,6 +23,9 @@ public:
 
 	UGOAPWorldStateProvider();
 
+	/** Called every time when owner's world state value is reported as changed (see NotifyWorldStateChanged). */
+	FWorldStateChangedDelegate OnWorldStateChanged;
+
 	/** Return true if provider has specified data (has specified world state atom). */
 	UFUNCTION(BlueprintCallable)
 	bool HasWorldStateValue(const FGameplayTag WorldStateAtomTag);
@@ -28,6 +33,19 @@ public:
 	 * GetWorldStateValue node. */
 	UFUNCTION(BlueprintCallable)
 	FGOAPWorldStateValue GetWorldStateValue(const FGameplayTag WorldStateAtomTag);
+	/**
+	 * Inform listeners (e.g. event driven planners) that specified world state value of owner actor has changed.
+	 * Should be called by gameplay code or atoms every time when data represented by atom is changed.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void NotifyWorldStateChanged(const FGameplayTag WorldStateAtomTag);
+
+	/** Create atom of given class and add it to provider at runtime. Return created atom or nullptr. */
+	UFUNCTION(BlueprintCallable)
+	UGOAPWorldStateAtom* AddWorldStateAtom(TSubclassOf<UGOAPWorldStateAtom> AtomClass);
+	/** Return atom providing specified data or nullptr if provider hasn't such atom. */
+	UFUNCTION(BlueprintCallable)
+	UGOAPWorldStateAtom* GetWorldStateAtom(const FGameplayTag WorldStateAtomTag) const;
 	
 protected:
 	
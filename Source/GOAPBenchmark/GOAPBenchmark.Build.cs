@@ -0,0 +1,29 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+using UnrealBuildTool;
+
+public class GOAPBenchmark : ModuleRules
+{
+	public GOAPBenchmark(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"GameplayTags",
+				"GOAP"
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Json"
+			}
+			);
+	}
+}
@@ -0,0 +1,17 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPBenchmark.h"
+
+#define LOCTEXT_NAMESPACE "FGOAPBenchmarkModule"
+
+void FGOAPBenchmarkModule::StartupModule()
+{
+}
+
+void FGOAPBenchmarkModule::ShutdownModule()
+{
+}
+
+#undef LOCTEXT_NAMESPACE
+	
+IMPLEMENT_MODULE(FGOAPBenchmarkModule, GOAPBenchmark)
@@ -0,0 +1,306 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPBenchmarkCommandlet.h"
+
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "GOAPPlanner.h"
+#include "GOAPSolver_Backward.h"
+#include "GOAPSolver_Bidirectional.h"
+#include "GOAPSolver_Forward.h"
+#include "GOAPSolver_IterativeDeepening.h"
+#include "GOAPSolver_Portfolio.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UObject/UObjectArray.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGOAPBenchmark, Log, All);
+
+UGOAPBenchmarkCommandlet::UGOAPBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UGOAPBenchmarkCommandlet::Main(const FString& Params)
+{
+	// single scenario if any of domain parameters is given, default scenarios matrix otherwise
+	TArray<FGOAPSyntheticDomainSettings> Scenarios;
+	FGOAPSyntheticDomainSettings CustomSettings;
+	const bool bCustomScenario =
+		FParse::Value(*Params, TEXT("Actions="), CustomSettings.ActionsNum) |
+		FParse::Value(*Params, TEXT("Actors="), CustomSettings.MemoryActorsNum) |
+		FParse::Value(*Params, TEXT("Depth="), CustomSettings.PlanDepth);
+	if(bCustomScenario)
+	{
+		Scenarios.Add(CustomSettings);
+	}
+	else
+	{
+		const int32 DefaultScenarios[][3] = { {4, 2, 2}, {6, 3, 3}, {8, 4, 3}, {8, 2, 4}, {12, 4, 4} };
+		for(const auto& DefaultScenario : DefaultScenarios)
+		{
+			FGOAPSyntheticDomainSettings& Settings = Scenarios.AddDefaulted_GetRef();
+			Settings.ActionsNum = DefaultScenario[0];
+			Settings.MemoryActorsNum = DefaultScenario[1];
+			Settings.PlanDepth = DefaultScenario[2];
+		}
+	}
+
+	int32 Seed = 0, CostMin = 1, CostMax = 10;
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("CostMin="), CostMin);
+	FParse::Value(*Params, TEXT("CostMax="), CostMax);
+	for(FGOAPSyntheticDomainSettings& Settings : Scenarios)
+	{
+		Settings.Seed = Seed;
+		Settings.MinActionCost = CostMin;
+		Settings.MaxActionCost = CostMax;
+	}
+
+	int32 Iterations = 20;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	FString SolversParam = TEXT("Forward,Backward");
+	FParse::Value(*Params, TEXT("Solvers="), SolversParam, false);
+	TArray<TSubclassOf<UGOAPSolver>> SolversClasses;
+	if(SolversParam.Contains(TEXT("Forward")))
+	{
+		SolversClasses.Add(UGOAPSolver_Forward::StaticClass());
+	}
+	if(SolversParam.Contains(TEXT("Backward")))
+	{
+		SolversClasses.Add(UGOAPSolver_Backward::StaticClass());
+	}
+	if(SolversParam.Contains(TEXT("Bidirectional")))
+	{
+		SolversClasses.Add(UGOAPSolver_Bidirectional::StaticClass());
+	}
+	if(SolversParam.Contains(TEXT("IterativeDeepening")))
+	{
+		SolversClasses.Add(UGOAPSolver_IterativeDeepening::StaticClass());
+	}
+	if(SolversParam.Contains(TEXT("Portfolio")))
+	{
+		SolversClasses.Add(UGOAPSolver_Portfolio::StaticClass());
+	}
+
+	const FString DefaultDirectory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("GOAP"));
+	FString OutputPath = FPaths::Combine(DefaultDirectory, TEXT("Benchmark.json"));
+	FString CsvPath = FPaths::Combine(DefaultDirectory, TEXT("Benchmark.csv"));
+	FString BaselinePath;
+	double Tolerance = 0.15;
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+	FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+	// per search logs would dominate measured times
+	GEngine->Exec(nullptr, TEXT("log LogGOAP Warning"));
+
+	TArray<FGOAPBenchmarkResult> Results;
+	for(const FGOAPSyntheticDomainSettings& Settings : Scenarios)
+	{
+		for(const TSubclassOf<UGOAPSolver>& SolverClass : SolversClasses)
+		{
+			const FGOAPBenchmarkResult& Result = Results.Add_GetRef(RunScenario(Settings, SolverClass, Iterations));
+			UE_LOG(LogGOAPBenchmark, Display, TEXT("%s %s: median %.3f ms, mean %.3f ms, min %.3f ms, expanded %d, "
+				"generated %d, reexpanded %d, plan length %d, plan cost %d, objects per search %.1f, "
+				"memory delta %lld B"),
+				*Result.Scenario, *Result.Solver, Result.MedianTimeMs, Result.MeanTimeMs, Result.MinTimeMs,
+				Result.NodesExpanded, Result.NodesGenerated, Result.NodesReexpanded, Result.PlanLength, Result.PlanCost,
+				Result.ObjectsPerSearch, Result.MemoryDelta);
+		}
+	}
+
+	if(!WriteJson(Results, OutputPath) || !WriteCsv(Results, CsvPath))
+	{
+		UE_LOG(LogGOAPBenchmark, Error, TEXT("Can't write benchmark results!"));
+		return 1;
+	}
+
+	if(!BaselinePath.IsEmpty() && CompareWithBaseline(Results, BaselinePath, Tolerance) > 0)
+		return 1;
+	
+	return 0;
+}
+
+FGOAPBenchmarkResult UGOAPBenchmarkCommandlet::RunScenario(const FGOAPSyntheticDomainSettings& Settings,
+	TSubclassOf<UGOAPSolver> SolverClass, int32 Iterations) const
+{
+	FGOAPBenchmarkResult Result;
+	Result.Scenario = Settings.ToString();
+	Result.Solver = SolverClass->GetName();
+	Result.Iterations = Iterations;
+	
+	UWorld* World = FGOAPSyntheticDomain::CreateWorld(TEXT("GOAPBenchmarkWorld"));
+	FGOAPSyntheticDomain Domain;
+	Domain.Build(World, Settings);
+	AGOAPSyntheticAgent* Agent = Domain.Agents[0];
+
+	TStrongObjectPtr<UGOAPSolver> Solver(NewObject<UGOAPSolver>(GetTransientPackage(), SolverClass));
+	Solver->InitializeSolver(IGOAPAgent::Execute_GetGOAPPlanner(Agent));
+	TStrongObjectPtr<UGOAPSyntheticGoal> Goal(UGOAPSyntheticGoal::CreateForAgent(Agent));
+
+	// warm up
+	Solver->FindPlanForGoal(Goal.Get());
+
+	TArray<double> Times;
+	Times.Reserve(Iterations);
+	const int32 ObjectsNumBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	const uint64 UsedMemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+	for(int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Solver->FindPlanForGoal(Goal.Get());
+		Times.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+	Result.MemoryDelta = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) -
+		static_cast<int64>(UsedMemoryBefore);
+	Result.ObjectsPerSearch =
+		static_cast<double>(GUObjectArray.GetObjectArrayNumMinusAvailable() - ObjectsNumBefore) / Iterations;
+
+	Times.Sort();
+	Result.MedianTimeMs = Times[Times.Num() / 2];
+	Result.MinTimeMs = Times[0];
+	double TimesSum = 0.0;
+	for(const double Time : Times)
+	{
+		TimesSum += Time;
+	}
+	Result.MeanTimeMs = TimesSum / Times.Num();
+
+	// searches are deterministic, so stats of last search describe all of them
+	const FGOAPSearchStats& Stats = Solver->GetLastSearchStats();
+	Result.NodesExpanded = Stats.NodesExpanded;
+	Result.NodesGenerated = Stats.NodesGenerated;
+	Result.NodesReexpanded = Stats.NodesReexpanded;
+	Result.PlanLength = Stats.PlanLength;
+	Result.PlanCost = Stats.PlanCost;
+
+	Goal.Reset();
+	Solver.Reset();
+	FGOAPSyntheticDomain::DestroyWorld(World);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	
+	return Result;
+}
+
+bool UGOAPBenchmarkCommandlet::WriteJson(const TArray<FGOAPBenchmarkResult>& Results, const FString& FilePath)
+{
+	TArray<TSharedPtr<FJsonValue>> ResultsValues;
+	for(const FGOAPBenchmarkResult& Result : Results)
+	{
+		TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+		ResultObject->SetStringField(TEXT("Scenario"), Result.Scenario);
+		ResultObject->SetStringField(TEXT("Solver"), Result.Solver);
+		ResultObject->SetNumberField(TEXT("Iterations"), Result.Iterations);
+		ResultObject->SetNumberField(TEXT("MedianTimeMs"), Result.MedianTimeMs);
+		ResultObject->SetNumberField(TEXT("MeanTimeMs"), Result.MeanTimeMs);
+		ResultObject->SetNumberField(TEXT("MinTimeMs"), Result.MinTimeMs);
+		ResultObject->SetNumberField(TEXT("NodesExpanded"), Result.NodesExpanded);
+		ResultObject->SetNumberField(TEXT("NodesGenerated"), Result.NodesGenerated);
+		ResultObject->SetNumberField(TEXT("NodesReexpanded"), Result.NodesReexpanded);
+		ResultObject->SetNumberField(TEXT("PlanLength"), Result.PlanLength);
+		ResultObject->SetNumberField(TEXT("PlanCost"), Result.PlanCost);
+		ResultObject->SetNumberField(TEXT("ObjectsPerSearch"), Result.ObjectsPerSearch);
+		ResultObject->SetNumberField(TEXT("MemoryDelta"), Result.MemoryDelta);
+		ResultsValues.Add(MakeShared<FJsonValueObject>(ResultObject));
+	}
+
+	const TSharedRef<FJsonObject> RootObject = MakeShared<FJsonObject>();
+	RootObject->SetArrayField(TEXT("Results"), ResultsValues);
+
+	FString JsonString;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+	if(!FJsonSerializer::Serialize(RootObject, Writer))
+		return false;
+
+	UE_LOG(LogGOAPBenchmark, Display, TEXT("Writing results to %s"), *FilePath);
+	return FFileHelper::SaveStringToFile(JsonString, *FilePath);
+}
+
+bool UGOAPBenchmarkCommandlet::WriteCsv(const TArray<FGOAPBenchmarkResult>& Results, const FString& FilePath)
+{
+	FString CsvString = TEXT("Scenario,Solver,Iterations,MedianTimeMs,MeanTimeMs,MinTimeMs,NodesExpanded,"
+		"NodesGenerated,NodesReexpanded,PlanLength,PlanCost,ObjectsPerSearch,MemoryDelta\n");
+	for(const FGOAPBenchmarkResult& Result : Results)
+	{
+		CsvString += FString::Printf(TEXT("%s,%s,%d,%.4f,%.4f,%.4f,%d,%d,%d,%d,%d,%.2f,%lld\n"),
+			*Result.Scenario, *Result.Solver, Result.Iterations, Result.MedianTimeMs, Result.MeanTimeMs,
+			Result.MinTimeMs, Result.NodesExpanded, Result.NodesGenerated, Result.NodesReexpanded,
+			Result.PlanLength, Result.PlanCost, Result.ObjectsPerSearch, Result.MemoryDelta);
+	}
+
+	UE_LOG(LogGOAPBenchmark, Display, TEXT("Writing results to %s"), *FilePath);
+	return FFileHelper::SaveStringToFile(CsvString, *FilePath);
+}
+
+int32 UGOAPBenchmarkCommandlet::CompareWithBaseline(const TArray<FGOAPBenchmarkResult>& Results,
+	const FString& FilePath, double Tolerance)
+{
+	FString JsonString;
+	if(!FFileHelper::LoadFileToString(JsonString, *FilePath))
+	{
+		UE_LOG(LogGOAPBenchmark, Error, TEXT("Can't read baseline %s!"), *FilePath);
+		return 1;
+	}
+
+	TSharedPtr<FJsonObject> RootObject;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+	if(!FJsonSerializer::Deserialize(Reader, RootObject) || !RootObject.IsValid())
+	{
+		UE_LOG(LogGOAPBenchmark, Error, TEXT("Can't parse baseline %s!"), *FilePath);
+		return 1;
+	}
+
+	int32 RegressionsNum = 0;
+	for(const TSharedPtr<FJsonValue>& BaselineValue : RootObject->GetArrayField(TEXT("Results")))
+	{
+		const TSharedPtr<FJsonObject>& Baseline = BaselineValue->AsObject();
+		const FString Scenario = Baseline->GetStringField(TEXT("Scenario"));
+		const FString Solver = Baseline->GetStringField(TEXT("Solver"));
+		const FGOAPBenchmarkResult* Result = Results.FindByPredicate([&](const FGOAPBenchmarkResult& Item)
+		{
+			return Item.Scenario == Scenario && Item.Solver == Solver;
+		});
+		if(!Result)
+			continue;
+
+		const double BaselineTime = Baseline->GetNumberField(TEXT("MedianTimeMs"));
+		if(Result->MedianTimeMs > BaselineTime * (1.0 + Tolerance))
+		{
+			UE_LOG(LogGOAPBenchmark, Error, TEXT("%s %s: median time regressed from %.3f ms to %.3f ms!"),
+				*Scenario, *Solver, BaselineTime, Result->MedianTimeMs);
+			++RegressionsNum;
+		}
+		
+		const int32 BaselineExpanded = static_cast<int32>(Baseline->GetNumberField(TEXT("NodesExpanded")));
+		if(Result->NodesExpanded > BaselineExpanded * (1.0 + Tolerance))
+		{
+			UE_LOG(LogGOAPBenchmark, Error, TEXT("%s %s: expanded nodes regressed from %d to %d!"),
+				*Scenario, *Solver, BaselineExpanded, Result->NodesExpanded);
+			++RegressionsNum;
+		}
+
+		const int32 BaselineCost = static_cast<int32>(Baseline->GetNumberField(TEXT("PlanCost")));
+		if(Result->PlanCost > BaselineCost)
+		{
+			UE_LOG(LogGOAPBenchmark, Error, TEXT("%s %s: plan cost regressed from %d to %d!"),
+				*Scenario, *Solver, BaselineCost, Result->PlanCost);
+			++RegressionsNum;
+		}
+	}
+
+	UE_LOG(LogGOAPBenchmark, Display, TEXT("Compared with baseline %s: %d regression(s)."), *FilePath, RegressionsNum);
+	return RegressionsNum;
+}
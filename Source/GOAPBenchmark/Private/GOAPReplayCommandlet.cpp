@@ -0,0 +1,161 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPReplayCommandlet.h"
+
+#include "Engine/Engine.h"
+#include "GOAPPlanner.h"
+#include "GOAPPlanningRecording.h"
+#include "GOAPSolver_Backward.h"
+#include "GOAPSolver_Bidirectional.h"
+#include "GOAPSolver_Forward.h"
+#include "GOAPSolver_IterativeDeepening.h"
+#include "GOAPSyntheticDomain.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/StrongObjectPtr.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGOAPReplay, Log, All);
+
+UGOAPReplayCommandlet::UGOAPReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UGOAPReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingPath;
+	if(!FParse::Value(*Params, TEXT("Recording="), RecordingPath))
+	{
+		UE_LOG(LogGOAPReplay, Error, TEXT("Missing -Recording=<file or directory> argument!"));
+		return 1;
+	}
+
+	TArray<FString> FilesPaths;
+	if(IFileManager::Get().DirectoryExists(*RecordingPath))
+	{
+		TArray<FString> FilesNames;
+		IFileManager::Get().FindFiles(FilesNames, *FPaths::Combine(RecordingPath, TEXT("*.goaprec")), true, false);
+		for(const FString& FileName : FilesNames)
+		{
+			FilesPaths.Add(FPaths::Combine(RecordingPath, FileName));
+		}
+	}
+	else
+	{
+		FilesPaths.Add(RecordingPath);
+	}
+
+	TArray<UClass*> SolversClasses;
+	FString SolversParam;
+	if(FParse::Value(*Params, TEXT("Solvers="), SolversParam, false))
+	{
+		if(SolversParam.Contains(TEXT("Forward")))
+		{
+			SolversClasses.Add(UGOAPSolver_Forward::StaticClass());
+		}
+		if(SolversParam.Contains(TEXT("Backward")))
+		{
+			SolversClasses.Add(UGOAPSolver_Backward::StaticClass());
+		}
+		if(SolversParam.Contains(TEXT("Bidirectional")))
+		{
+			SolversClasses.Add(UGOAPSolver_Bidirectional::StaticClass());
+		}
+		if(SolversParam.Contains(TEXT("IterativeDeepening")))
+		{
+			SolversClasses.Add(UGOAPSolver_IterativeDeepening::StaticClass());
+		}
+	}
+
+	int32 Iterations = 20;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	// per search logs would dominate measured times
+	GEngine->Exec(nullptr, TEXT("log LogGOAP Warning"));
+
+	int32 FailedNum = 0;
+	for(const FString& FilePath : FilesPaths)
+	{
+		if(!ReplayFile(FilePath, SolversClasses, Iterations))
+		{
+			++FailedNum;
+		}
+	}
+	return FailedNum > 0 ? 1 : 0;
+}
+
+bool UGOAPReplayCommandlet::ReplayFile(const FString& FilePath, const TArray<UClass*>& SolversClasses,
+	int32 Iterations) const
+{
+	UWorld* World = FGOAPSyntheticDomain::CreateWorld(TEXT("GOAPReplayWorld"));
+	FGOAPPlanningRecording Recording;
+	if(!Recording.LoadFromFile(FilePath, World))
+	{
+		UE_LOG(LogGOAPReplay, Error, TEXT("Can't load recording %s!"), *FilePath);
+		FGOAPSyntheticDomain::DestroyWorld(World);
+		return false;
+	}
+
+	UE_LOG(LogGOAPReplay, Display, TEXT("%s: goal %s, recorded with %s in %.3f ms (plan length %d, cost %d, %d queries)"),
+		*FPaths::GetCleanFilename(FilePath), *Recording.GetGoalName(), *FPackageName::ObjectPathToObjectName(Recording.GetSolverClassPath()),
+		Recording.GetSearchTime() * 1000.0, Recording.GetPlanLength(), Recording.GetPlanCost(),
+		Recording.GetQueriesNum());
+
+	TArray<UClass*> ReplayedSolversClasses = SolversClasses;
+	if(ReplayedSolversClasses.Num() == 0)
+	{
+		UClass* RecordedSolverClass = FindObject<UClass>(nullptr, *Recording.GetSolverClassPath());
+		if(RecordedSolverClass && RecordedSolverClass->IsChildOf(UGOAPSolver::StaticClass()))
+		{
+			ReplayedSolversClasses.Add(RecordedSolverClass);
+		}
+		else
+		{
+			UE_LOG(LogGOAPReplay, Error, TEXT("Unknown recorded solver %s!"), *Recording.GetSolverClassPath());
+		}
+	}
+
+	for(UClass* SolverClass : ReplayedSolversClasses)
+	{
+		TStrongObjectPtr<UGOAPSolver> Solver(NewObject<UGOAPSolver>(GetTransientPackage(), SolverClass));
+		Recording.ResetMissedQueriesNum();
+		
+		TArray<double> Times;
+		int32 PlanLength = 0;
+		// first search is warm up
+		for(int32 Iteration = 0; Iteration <= Iterations; ++Iteration)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			PlanLength = Solver->ReplayRecording(Recording).Num();
+			if(Iteration > 0)
+			{
+				Times.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+			}
+		}
+		Times.Sort();
+
+		const FGOAPSearchStats& Stats = Solver->GetLastSearchStats();
+		UE_LOG(LogGOAPReplay, Display, TEXT("	%s: median %.3f ms, min %.3f ms, expanded %d, generated %d, plan length %d, "
+			"plan cost %d"), *SolverClass->GetName(), Times[Times.Num() / 2], Times[0], Stats.NodesExpanded,
+			Stats.NodesGenerated, PlanLength, Stats.PlanCost);
+		if(Recording.GetMissedQueriesNum() > 0)
+		{
+			UE_LOG(LogGOAPReplay, Warning, TEXT("	%s asked %d not recorded queries - replay diverged from recorded search, "
+				"results are not reliable."), *SolverClass->GetName(), Recording.GetMissedQueriesNum() / (Iterations + 1));
+		}
+		else if(Stats.PlanCost != Recording.GetPlanCost())
+		{
+			UE_LOG(LogGOAPReplay, Warning, TEXT("	%s found plan of different cost than recorded one."),
+				*SolverClass->GetName());
+		}
+	}
+
+	FGOAPSyntheticDomain::DestroyWorld(World);
+	return true;
+}
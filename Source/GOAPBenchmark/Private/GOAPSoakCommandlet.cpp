@@ -0,0 +1,208 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPSoakCommandlet.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GOAPPlanner.h"
+#include "GOAPPlannerSubsystem.h"
+#include "GOAPSolver.h"
+#include "HAL/PlatformMemory.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGOAPSoak, Log, All);
+
+CSV_DEFINE_CATEGORY(GOAPSoak, true);
+
+UGOAPSoakCommandlet::UGOAPSoakCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UGOAPSoakCommandlet::Main(const FString& Params)
+{
+	int32 AgentsNum = 1000;
+	FGOAPSyntheticDomainSettings Settings;
+	Settings.MemoryActorsNum = 16;
+	FParse::Value(*Params, TEXT("Agents="), AgentsNum);
+	FParse::Value(*Params, TEXT("Actions="), Settings.ActionsNum);
+	FParse::Value(*Params, TEXT("Actors="), Settings.MemoryActorsNum);
+	FParse::Value(*Params, TEXT("Depth="), Settings.PlanDepth);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	Settings.bUseScheduler = FParse::Param(*Params, TEXT("UseScheduler"));
+	Settings.GoalsEvaluationMode = FParse::Param(*Params, TEXT("EventDriven")) ?
+		EGOAPGoalsEvaluationMode::EventDriven : EGOAPGoalsEvaluationMode::Polling;
+	AgentsNum = FMath::Max(AgentsNum, 1);
+
+	float Duration = 60.0f, FPS = 30.0f, ChangesPerSecond = 100.0f;
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("FPS="), FPS);
+	FParse::Value(*Params, TEXT("ChangesPerSecond="), ChangesPerSecond);
+	FPS = FMath::Max(FPS, 1.0f);
+	const float DeltaTime = 1.0f / FPS;
+	const int32 FramesNum = FMath::Max(FMath::CeilToInt(Duration * FPS), 1);
+
+	// per search logs would dominate measured times
+	GEngine->Exec(nullptr, TEXT("log LogGOAP Warning"));
+
+	UWorld* World = FGOAPSyntheticDomain::CreateWorld(TEXT("GOAPSoakWorld"));
+	FGOAPSyntheticDomain Domain;
+	Domain.Build(World, Settings, AgentsNum);
+	UE_LOG(LogGOAPSoak, Display, TEXT("Soak test %s: %d agents, %d frames at %.0f FPS, %.0f changes per second, %s%s"),
+		*Domain.Settings.ToString(), AgentsNum, FramesNum, FPS, ChangesPerSecond,
+		Settings.bUseScheduler ? TEXT("scheduler, ") : TEXT(""),
+		Settings.GoalsEvaluationMode == EGOAPGoalsEvaluationMode::EventDriven ? TEXT("event driven") : TEXT("polling"));
+
+	const FDelegateHandle SearchFinishedHandle = UGOAPSolver::OnSearchFinished.AddUObject(this,
+		&UGOAPSoakCommandlet::OnSearchFinished);
+	SearchTimes.Reset();
+
+#if CSV_PROFILER
+	FString CsvName;
+	const bool bCaptureCsv = FParse::Value(*Params, TEXT("Csv="), CsvName);
+	if(bCaptureCsv)
+	{
+		FCsvProfiler::Get()->BeginCapture(-1, FString(), CsvName);
+	}
+#endif
+
+	const UGOAPPlannerSubsystem* Scheduler = World->GetSubsystem<UGOAPPlannerSubsystem>();
+	FRandomStream Random(Settings.Seed);
+	TArray<double> FrameTimes;
+	TArray<double> SchedulerLatencies;
+	FrameTimes.Reserve(FramesNum);
+	uint64 PeakUsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	float ChangesToApply = 0.0f;
+	for(int32 Frame = 0; Frame < FramesNum; ++Frame)
+	{
+#if CSV_PROFILER
+		if(bCaptureCsv)
+		{
+			FCsvProfiler::Get()->BeginFrame();
+		}
+#endif
+		FrameSearchesNum = 0;
+		FrameMaxSearchTime = 0.0;
+
+		// world changes are made before tick, like gameplay events
+		ChangesToApply += ChangesPerSecond * DeltaTime;
+		for(; ChangesToApply >= 1.0f; ChangesToApply -= 1.0f)
+		{
+			ApplyRandomChange(Domain, Random);
+		}
+
+		// only GOAP (planners, scheduler, mock executors) ticks in this world, so whole tick is GOAP time
+		const double StartTime = FPlatformTime::Seconds();
+		World->Tick(LEVELTICK_All, DeltaTime);
+		const double FrameTime = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		FrameTimes.Add(FrameTime);
+		++GFrameCounter;
+
+		const uint64 UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+		PeakUsedMemory = FMath::Max(PeakUsedMemory, UsedMemory);
+
+		if(Scheduler)
+		{
+			SchedulerLatencies.Add(Scheduler->GetSchedulerMetrics().MaxLatencyLastFrame * 1000.0);
+		}
+
+		CSV_CUSTOM_STAT(GOAPSoak, FrameMs, static_cast<float>(FrameTime), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GOAPSoak, Searches, FrameSearchesNum, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GOAPSoak, SearchMsMax, static_cast<float>(FrameMaxSearchTime), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GOAPSoak, UsedMemoryMB, static_cast<float>(UsedMemory / (1024.0 * 1024.0)),
+			ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GOAPSoak, SchedulerQueueDepth, Scheduler ? Scheduler->GetSchedulerMetrics().QueueDepth : 0,
+			ECsvCustomStatOp::Set);
+#if CSV_PROFILER
+		if(bCaptureCsv)
+		{
+			FCsvProfiler::Get()->EndFrame();
+		}
+#endif
+	}
+
+#if CSV_PROFILER
+	if(bCaptureCsv)
+	{
+		const FString CsvPath = FCsvProfiler::Get()->EndCapture().Get();
+		UE_LOG(LogGOAPSoak, Display, TEXT("CSV profile written to %s"), *CsvPath);
+	}
+#endif
+
+	UGOAPSolver::OnSearchFinished.Remove(SearchFinishedHandle);
+
+	SearchTimes.Sort();
+	FrameTimes.Sort();
+	UE_LOG(LogGOAPSoak, Display, TEXT("Searches: %d (%.1f replans per second)"), SearchTimes.Num(),
+		SearchTimes.Num() / (FramesNum * DeltaTime));
+	UE_LOG(LogGOAPSoak, Display, TEXT("Search time: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms"),
+		GetPercentile(SearchTimes, 0.5), GetPercentile(SearchTimes, 0.95), GetPercentile(SearchTimes, 0.99),
+		GetPercentile(SearchTimes, 1.0));
+	UE_LOG(LogGOAPSoak, Display, TEXT("GOAP time per frame: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms"),
+		GetPercentile(FrameTimes, 0.5), GetPercentile(FrameTimes, 0.95), GetPercentile(FrameTimes, 0.99),
+		GetPercentile(FrameTimes, 1.0));
+	if(Settings.bUseScheduler)
+	{
+		SchedulerLatencies.Sort();
+		UE_LOG(LogGOAPSoak, Display, TEXT("Scheduler max latency per frame: p50 %.1f ms, p95 %.1f ms, p99 %.1f ms"),
+			GetPercentile(SchedulerLatencies, 0.5), GetPercentile(SchedulerLatencies, 0.95),
+			GetPercentile(SchedulerLatencies, 0.99));
+	}
+	UE_LOG(LogGOAPSoak, Display, TEXT("Peak used memory: %.1f MB"),
+		static_cast<double>(PeakUsedMemory) / (1024.0 * 1024.0));
+
+	FGOAPSyntheticDomain::DestroyWorld(World);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	return 0;
+}
+
+void UGOAPSoakCommandlet::ApplyRandomChange(FGOAPSyntheticDomain& Domain, FRandomStream& Random) const
+{
+	switch(Random.RandHelper(3))
+	{
+	case 0:
+		{
+			// undo agents' work on memory actor
+			AGOAPSyntheticActor* MemoryActor = Domain.MemoryActors[Random.RandHelper(Domain.MemoryActors.Num())];
+			MemoryActor->ResetLevels();
+			break;
+		}
+	case 1:
+		{
+			// change goal's score
+			AGOAPSyntheticAgent* Agent = Domain.Agents[Random.RandHelper(Domain.Agents.Num())];
+			Agent->SetNeed(Random.FRand());
+			break;
+		}
+	default:
+		{
+			// change goal's desired world state; it isn't world state change, so goals evaluation has to be requested
+			AGOAPSyntheticAgent* Agent = Domain.Agents[Random.RandHelper(Domain.Agents.Num())];
+			Agent->SetTargetActor(Domain.MemoryActors[Random.RandHelper(Domain.MemoryActors.Num())]);
+			IGOAPAgent::Execute_GetGOAPPlanner(Agent)->RequestGoalsEvaluation();
+			break;
+		}
+	}
+}
+
+void UGOAPSoakCommandlet::OnSearchFinished(const UGOAPSolver* Solver, const FGOAPSearchStats& Stats)
+{
+	const double SearchTime = Stats.SearchTime * 1000.0;
+	SearchTimes.Add(SearchTime);
+	++FrameSearchesNum;
+	FrameMaxSearchTime = FMath::Max(FrameMaxSearchTime, SearchTime);
+}
+
+double UGOAPSoakCommandlet::GetPercentile(const TArray<double>& SortedValues, double Percentile)
+{
+	if(SortedValues.Num() == 0)
+		return 0.0;
+
+	const int32 Index = FMath::CeilToInt(Percentile * SortedValues.Num()) - 1;
+	return SortedValues[FMath::Clamp(Index, 0, SortedValues.Num() - 1)];
+}
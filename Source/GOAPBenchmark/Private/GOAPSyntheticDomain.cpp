@@ -0,0 +1,398 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#include "GOAPSyntheticDomain.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GOAPMemoryComponent.h"
+#include "GOAPPlanner.h"
+#include "GOAPWorldStatePayloads.h"
+#include "GOAPWorldStateProvider.h"
+#include "NativeGameplayTags.h"
+
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Need, "GOAP.Synthetic.Need");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level0, "GOAP.Synthetic.Level0");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level1, "GOAP.Synthetic.Level1");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level2, "GOAP.Synthetic.Level2");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level3, "GOAP.Synthetic.Level3");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level4, "GOAP.Synthetic.Level4");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level5, "GOAP.Synthetic.Level5");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level6, "GOAP.Synthetic.Level6");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level7, "GOAP.Synthetic.Level7");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level8, "GOAP.Synthetic.Level8");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level9, "GOAP.Synthetic.Level9");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level10, "GOAP.Synthetic.Level10");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level11, "GOAP.Synthetic.Level11");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level12, "GOAP.Synthetic.Level12");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level13, "GOAP.Synthetic.Level13");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level14, "GOAP.Synthetic.Level14");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_GOAP_Synthetic_Level15, "GOAP.Synthetic.Level15");
+
+namespace GOAPSyntheticDomain
+{
+	static const FNativeGameplayTag* LevelTags[] =
+	{
+		&TAG_GOAP_Synthetic_Level0, &TAG_GOAP_Synthetic_Level1, &TAG_GOAP_Synthetic_Level2,
+		&TAG_GOAP_Synthetic_Level3, &TAG_GOAP_Synthetic_Level4, &TAG_GOAP_Synthetic_Level5,
+		&TAG_GOAP_Synthetic_Level6, &TAG_GOAP_Synthetic_Level7, &TAG_GOAP_Synthetic_Level8,
+		&TAG_GOAP_Synthetic_Level9, &TAG_GOAP_Synthetic_Level10, &TAG_GOAP_Synthetic_Level11,
+		&TAG_GOAP_Synthetic_Level12, &TAG_GOAP_Synthetic_Level13, &TAG_GOAP_Synthetic_Level14,
+		&TAG_GOAP_Synthetic_Level15
+	};
+	static_assert(UE_ARRAY_COUNT(LevelTags) == FGOAPSyntheticDomainSettings::MaxPlanDepth + 1,
+		"Each level needs its tag.");
+
+	/** Return true if given value is bool payload with true value. */
+	static bool IsTrue(const FGOAPWorldStateValue& Value)
+	{
+		const UGOAPWorldStatePayloadBool* BoolPayload = Cast<UGOAPWorldStatePayloadBool>(Value.Payload);
+		return BoolPayload && BoolPayload->Value;
+	}
+}
+
+/// FGOAPSyntheticDomainSettings
+FString FGOAPSyntheticDomainSettings::ToString() const
+{
+	return FString::Printf(TEXT("A%d_M%d_D%d"), ActionsNum, MemoryActorsNum, PlanDepth);
+}
+
+/// UGOAPSyntheticAtom
+void UGOAPSyntheticAtom::InitializeSyntheticAtom(const FGameplayTag& Tag, bool bInBoolValue, float InValue)
+{
+	WorldStateAtomTag = Tag;
+	bBoolValue = bInBoolValue;
+	Value = InValue;
+	UpdateWorldStateAtomData();
+}
+
+void UGOAPSyntheticAtom::SetValue(float InValue)
+{
+	if(Value == InValue)
+		return;
+
+	Value = InValue;
+	UpdateWorldStateAtomData();
+	NotifyWorldStateChanged();
+}
+
+void UGOAPSyntheticAtom::UpdateWorldStateAtomData_Implementation()
+{
+	if(bBoolValue)
+	{
+		UGOAPWorldStatePayloadBool::SetPayloadValue(GetWorldStateValueRef(), Value != 0.0f);
+	}
+	else
+	{
+		UGOAPWorldStatePayloadFloat::SetPayloadValue(GetWorldStateValueRef(), Value);
+	}
+}
+
+/// UGOAPSyntheticAction
+void UGOAPSyntheticAction::InitializeSyntheticAction(int32 InProducedLevel, int32 InCost)
+{
+	ProducedLevel = InProducedLevel;
+	Cost = InCost;
+	UGOAPWorldStatePayloadBool::SetPayloadValue(TrueValue, true);
+}
+
+bool UGOAPSyntheticAction::CanChangeWorldState_Implementation(FGOAPWorldStateData DesiredWorldState,
+	AActor* AgentActor)
+{
+	return DesiredWorldState.WorldStateKey.WorldStateDataTag.MatchesTagExact(
+			FGOAPSyntheticDomain::GetLevelTag(ProducedLevel)) &&
+		GOAPSyntheticDomain::IsTrue(DesiredWorldState.WorldStateValue) &&
+		Cast<AGOAPSyntheticActor>(DesiredWorldState.WorldStateKey.WorldStateActor);
+}
+
+TArray<FGOAPWorldStateData> UGOAPSyntheticAction::GetWorldStatePreconditions_Implementation(
+	FGOAPWorldStateData ForDesiredWorldState, AActor* AgentActor)
+{
+	const FGOAPWorldStateKey PreconditionKey(ForDesiredWorldState.WorldStateKey.WorldStateActor,
+		FGOAPSyntheticDomain::GetLevelTag(ProducedLevel - 1));
+	return { FGOAPWorldStateData(PreconditionKey, TrueValue) };
+}
+
+int32 UGOAPSyntheticAction::GetActionCost_Implementation(FGOAPWorldStateData DesiredWorldState, AActor* AgentActor,
+	const TArray<FGOAPWorldStateData>& WithCurrentWorldState)
+{
+	return Cost;
+}
+
+bool UGOAPSyntheticAction::GetActionEffectWithContextActor_Implementation(AActor* AgentActor, AActor* TargetActor,
+	FGOAPWorldStateData& EffectWorldState)
+{
+	if(!Cast<AGOAPSyntheticActor>(TargetActor))
+		return false;
+
+	EffectWorldState = FGOAPWorldStateData(
+		FGOAPWorldStateKey(TargetActor, FGOAPSyntheticDomain::GetLevelTag(ProducedLevel)), TrueValue);
+	return true;
+}
+
+/// UGOAPSyntheticGoal
+UGOAPSyntheticGoal::UGOAPSyntheticGoal()
+{
+	ScoringMode = EGOAPGoalScoringMode::Utility;
+	
+	FGOAPUtilityConsideration NeedConsideration;
+	NeedConsideration.WorldStateTag = FGOAPSyntheticDomain::GetNeedTag();
+	UtilityConsiderations.Add(NeedConsideration);
+
+	// goal depends on levels of its target actor
+	for(int32 Level = 0; Level <= FGOAPSyntheticDomainSettings::MaxPlanDepth; ++Level)
+	{
+		RelevantWorldStateTags.AddTag(FGOAPSyntheticDomain::GetLevelTag(Level));
+	}
+	bSkipWhenSatisfied = true;
+}
+
+UGOAPSyntheticGoal* UGOAPSyntheticGoal::CreateForAgent(AGOAPSyntheticAgent* Agent)
+{
+	UGOAPSyntheticGoal* Goal = NewObject<UGOAPSyntheticGoal>(Agent);
+	Goal->AgentActor = TScriptInterface<IGOAPAgent>(Agent);
+	return Goal;
+}
+
+void UGOAPSyntheticGoal::UpdateDesiredWorldState_Implementation()
+{
+	const AGOAPSyntheticAgent* Agent = Cast<AGOAPSyntheticAgent>(AgentActor.GetObject());
+	if(!Agent)
+		return;
+
+	DesiredWorldState.WorldStateKey = FGOAPWorldStateKey(Agent->GetTargetActor(),
+		FGOAPSyntheticDomain::GetLevelTag(Agent->GetTopLevel()));
+	UGOAPWorldStatePayloadBool::SetPayloadValue(DesiredWorldState.WorldStateValue, true);
+}
+
+/// AGOAPSyntheticActor
+AGOAPSyntheticActor::AGOAPSyntheticActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	
+	WorldStateProvider = CreateDefaultSubobject<UGOAPWorldStateProvider>(TEXT("WorldStateProvider"));
+}
+
+void AGOAPSyntheticActor::InitializeLevels(int32 PlanDepth)
+{
+	for(int32 Level = 0; Level <= PlanDepth; ++Level)
+	{
+		UGOAPSyntheticAtom* Atom = Cast<UGOAPSyntheticAtom>(
+			WorldStateProvider->AddWorldStateAtom(UGOAPSyntheticAtom::StaticClass()));
+		Atom->InitializeSyntheticAtom(FGOAPSyntheticDomain::GetLevelTag(Level), true, Level == 0 ? 1.0f : 0.0f);
+		LevelAtoms.Add(Atom);
+	}
+}
+
+void AGOAPSyntheticActor::SetLevel(int32 Level, bool bMet)
+{
+	if(LevelAtoms.IsValidIndex(Level))
+	{
+		LevelAtoms[Level]->SetValue(bMet ? 1.0f : 0.0f);
+	}
+}
+
+void AGOAPSyntheticActor::ResetLevels()
+{
+	for(int32 Level = 0; Level < LevelAtoms.Num(); ++Level)
+	{
+		SetLevel(Level, Level == 0);
+	}
+}
+
+/// AGOAPSyntheticAgent
+AGOAPSyntheticAgent::AGOAPSyntheticAgent()
+{
+	Planner = CreateDefaultSubobject<UGOAPPlanner>(TEXT("Planner"));
+	MemoryComponent = CreateDefaultSubobject<UGOAPMemoryComponent>(TEXT("MemoryComponent"));
+	ActionsExecutor = CreateDefaultSubobject<UGOAPSyntheticActionsExecutor>(TEXT("ActionsExecutor"));
+}
+
+void AGOAPSyntheticAgent::InitializeAgent(const TArray<UObject*>& Actions, const FGOAPSyntheticDomainSettings& Settings)
+{
+	TopLevel = Settings.PlanDepth;
+	
+	NeedAtom = Cast<UGOAPSyntheticAtom>(WorldStateProvider->AddWorldStateAtom(UGOAPSyntheticAtom::StaticClass()));
+	NeedAtom->InitializeSyntheticAtom(FGOAPSyntheticDomain::GetNeedTag(), false, 1.0f);
+
+	ActionsExecutor->ActionDuration = Settings.ActionDuration;
+	Planner->SetGoalsEvaluationMode(Settings.GoalsEvaluationMode);
+	Planner->SetUseScheduler(Settings.bUseScheduler);
+	Planner->InitializePlanner(MemoryComponent, ActionsExecutor, Actions);
+	Planner->AddGoal(UGOAPSyntheticGoal::StaticClass());
+}
+
+void AGOAPSyntheticAgent::SetNeed(float Need)
+{
+	if(NeedAtom)
+	{
+		NeedAtom->SetValue(FMath::Clamp(Need, 0.0f, 1.0f));
+	}
+}
+
+/// UGOAPSyntheticActionsExecutor
+UGOAPSyntheticActionsExecutor::UGOAPSyntheticActionsExecutor()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UGOAPSyntheticActionsExecutor::TickComponent(float DeltaTime, ELevelTick TickType,
+	FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if(!ActiveActionClass)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+	
+	RemainingTime -= DeltaTime;
+	if(RemainingTime > 0.0f)
+		return;
+
+	const UObject* FinishedAction = ActiveActionClass->GetDefaultObject();
+	ActiveActionClass = nullptr;
+	SetComponentTickEnabled(false);
+
+	const bool bSuccess = FMath::FRand() >= FailureChance;
+	if(bSuccess)
+	{
+		// apply effect of currently executed plan step - it is the data action was planned to achieve
+		const AGOAPSyntheticAgent* Agent = Cast<AGOAPSyntheticAgent>(GetOwner());
+		const UGOAPPlanner* Planner = Agent ? IGOAPAgent::Execute_GetGOAPPlanner(GetOwner()) : nullptr;
+		if(Planner && Planner->GetExecutingPlan().IsValidIndex(Planner->GetExecutingPlanActionIndex()))
+		{
+			const FGOAPWorldStateData& TargetData =
+				Planner->GetExecutingPlan()[Planner->GetExecutingPlanActionIndex()].TargetData;
+			if(const AGOAPSyntheticActor* TargetActor = Cast<AGOAPSyntheticActor>(TargetData.WorldStateKey.WorldStateActor))
+			{
+				UGOAPSyntheticAtom* Atom = Cast<UGOAPSyntheticAtom>(
+					TargetActor->GetWorldStateProvider()->GetWorldStateAtom(TargetData.WorldStateKey.WorldStateDataTag));
+				if(Atom)
+				{
+					Atom->SetValue(GOAPSyntheticDomain::IsTrue(TargetData.WorldStateValue) ? 1.0f : 0.0f);
+				}
+			}
+		}
+	}
+	
+	OnActionEnded.Broadcast(FinishedAction, bSuccess);
+}
+
+void UGOAPSyntheticActionsExecutor::CancelAction_Implementation(UObject* Action)
+{
+	if(!ActiveActionClass || !Action || Action->GetClass() != ActiveActionClass)
+		return;
+
+	// like ability system, report canceled action as ended unsuccessfully
+	ActiveActionClass = nullptr;
+	SetComponentTickEnabled(false);
+	OnActionEnded.Broadcast(Action, false);
+}
+
+UObject* UGOAPSyntheticActionsExecutor::GetActiveAction_Implementation()
+{
+	return ActiveActionClass ? ActiveActionClass->GetDefaultObject() : nullptr;
+}
+
+bool UGOAPSyntheticActionsExecutor::TryActivateActionByClass_Implementation(TSubclassOf<UObject> ActionClass)
+{
+	if(ActiveActionClass || !IsValid(ActionClass))
+		return false;
+
+	ActiveActionClass = ActionClass;
+	RemainingTime = ActionDuration;
+	SetComponentTickEnabled(true);
+	return true;
+}
+
+/// FGOAPSyntheticDomain
+FGameplayTag FGOAPSyntheticDomain::GetLevelTag(int32 Level)
+{
+	check(Level >= 0 && Level <= FGOAPSyntheticDomainSettings::MaxPlanDepth);
+	return GOAPSyntheticDomain::LevelTags[Level]->GetTag();
+}
+
+FGameplayTag FGOAPSyntheticDomain::GetNeedTag()
+{
+	return TAG_GOAP_Synthetic_Need.GetTag();
+}
+
+UWorld* FGOAPSyntheticDomain::CreateWorld(const FName& WorldName)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, WorldName);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+	return World;
+}
+
+void FGOAPSyntheticDomain::DestroyWorld(UWorld* World)
+{
+	if(!World)
+		return;
+	
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+}
+
+void FGOAPSyntheticDomain::Build(UWorld* World, const FGOAPSyntheticDomainSettings& InSettings, int32 AgentsNum)
+{
+	check(World);
+	
+	Settings = InSettings;
+	Settings.PlanDepth = FMath::Clamp(Settings.PlanDepth, 1, FGOAPSyntheticDomainSettings::MaxPlanDepth);
+	// at least one action per level is needed to make goal achievable
+	Settings.ActionsNum = FMath::Max(Settings.ActionsNum, Settings.PlanDepth);
+	Settings.MemoryActorsNum = FMath::Max(Settings.MemoryActorsNum, 1);
+	Settings.MaxActionCost = FMath::Max(Settings.MaxActionCost, Settings.MinActionCost);
+
+	FRandomStream Random(Settings.Seed);
+
+	// memory actors
+	for(int32 Index = 0; Index < Settings.MemoryActorsNum; ++Index)
+	{
+		AGOAPSyntheticActor* Actor = World->SpawnActor<AGOAPSyntheticActor>();
+		Actor->InitializeLevels(Settings.PlanDepth);
+		MemoryActors.Add(Actor);
+	}
+
+	// actions are evenly distributed over levels
+	for(int32 Index = 0; Index < Settings.ActionsNum; ++Index)
+	{
+		UGOAPSyntheticAction* Action = NewObject<UGOAPSyntheticAction>(World);
+		Action->InitializeSyntheticAction(1 + Index % Settings.PlanDepth,
+			Random.RandRange(Settings.MinActionCost, Settings.MaxActionCost));
+		Actions.Add(Action);
+	}
+
+	// agents
+	for(int32 Index = 0; Index < AgentsNum; ++Index)
+	{
+		AGOAPSyntheticAgent* Agent = World->SpawnActor<AGOAPSyntheticAgent>();
+		Agent->InitializeLevels(Settings.PlanDepth);
+		for(AGOAPSyntheticActor* MemoryActor : MemoryActors)
+		{
+			IGOAPAgent::Execute_GetGOAPMemoryComponent(Agent)->RegisterActorInMemory(MemoryActor);
+		}
+		Agent->SetTargetActor(MemoryActors[Index % MemoryActors.Num()]);
+		Agent->InitializeAgent(Actions, Settings);
+		Agents.Add(Agent);
+	}
+}
+
+void FGOAPSyntheticDomain::ResetWorldState()
+{
+	for(AGOAPSyntheticActor* Actor : MemoryActors)
+	{
+		Actor->ResetLevels();
+	}
+	for(AGOAPSyntheticAgent* Agent : Agents)
+	{
+		Agent->ResetLevels();
+	}
+}
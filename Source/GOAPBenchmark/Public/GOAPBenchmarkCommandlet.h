@@ -0,0 +1,68 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GOAPSyntheticDomain.h"
+#include "GOAPBenchmarkCommandlet.generated.h"
+
+class UGOAPSolver;
+
+/**
+ * Result of benchmarking one solver on one synthetic domain.
+ */
+struct FGOAPBenchmarkResult
+{
+	FString Scenario;
+	FString Solver;
+	int32 Iterations = 0;
+	/** Search wall times in milliseconds. */
+	double MedianTimeMs = 0.0;
+	double MeanTimeMs = 0.0;
+	double MinTimeMs = 0.0;
+	int32 NodesExpanded = 0;
+	int32 NodesGenerated = 0;
+	/** Nodes expanded again by iterations of iterative deepening search. */
+	int32 NodesReexpanded = 0;
+	int32 PlanLength = 0;
+	int32 PlanCost = 0;
+	/** Average number of UObjects (mostly world state payloads) created per search. */
+	double ObjectsPerSearch = 0.0;
+	/** Growth of used physical memory during all iterations, in bytes. */
+	int64 MemoryDelta = 0;
+};
+
+/**
+ * Headless benchmark of GOAP solvers on generated synthetic domains. Writes results as JSON/CSV and optionally
+ * compares them against baseline JSON (returns non zero exit code if any scenario is slower than baseline).
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=GOAPBenchmark -nullrhi [-Actions=8 -Actors=4 -Depth=3] [-Iterations=20]
+ *	[-Seed=0] [-CostMin=1 -CostMax=10] [-Solvers=Forward,Backward] [-Output=<json>] [-Csv=<csv>]
+ *	[-Baseline=<json>] [-Tolerance=0.15]
+ */
+UCLASS()
+class GOAPBENCHMARK_API UGOAPBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	/** Run given solver on synthetic domain built from given settings. */
+	FGOAPBenchmarkResult RunScenario(const FGOAPSyntheticDomainSettings& Settings, TSubclassOf<UGOAPSolver> SolverClass,
+		int32 Iterations) const;
+
+	/** Write results to JSON file. */
+	static bool WriteJson(const TArray<FGOAPBenchmarkResult>& Results, const FString& FilePath);
+	/** Write results to CSV file. */
+	static bool WriteCsv(const TArray<FGOAPBenchmarkResult>& Results, const FString& FilePath);
+	/** Compare results against baseline JSON file. Return number of regressions. */
+	static int32 CompareWithBaseline(const TArray<FGOAPBenchmarkResult>& Results, const FString& FilePath,
+		double Tolerance);
+};
@@ -0,0 +1,31 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GOAPReplayCommandlet.generated.h"
+
+/**
+ * Replays recorded planning problems (see GOAP.Recording.Enable) without live world and reports search times, so
+ * solver changes can be profiled, compared and bisected on real captured cases.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=GOAPReplay -nullrhi -Recording=<file or directory> [-Solvers=Forward,Backward]
+ *	[-Iterations=20]
+ */
+UCLASS()
+class GOAPBENCHMARK_API UGOAPReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	/** Replay single recording with given solvers (recorded solver if empty). Return false if recording can't be loaded. */
+	bool ReplayFile(const FString& FilePath, const TArray<UClass*>& SolversClasses, int32 Iterations) const;
+};
@@ -0,0 +1,49 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GOAPSyntheticDomain.h"
+#include "GOAPSoakCommandlet.generated.h"
+
+struct FGOAPSearchStats;
+class UGOAPSolver;
+
+/**
+ * Headless soak test: thousands of synthetic agents planning and executing mock actions in world ticked with fixed
+ * frame rate, while scripted world changes (memory actors resets, needs and targets changes) force replanning.
+ * Reports planning latency percentiles, replans per second, world tick time and peak memory. When CSV profiler is
+ * compiled in, per frame values are also captured to Saved/Profiling/CSV.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=GOAPSoak -nullrhi [-Agents=1000] [-Actions=8 -Actors=16 -Depth=3]
+ *	[-Duration=60] [-FPS=30] [-ChangesPerSecond=100] [-Seed=0] [-UseScheduler] [-EventDriven] [-Csv=<name>]
+ */
+UCLASS()
+class GOAPBENCHMARK_API UGOAPSoakCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPSoakCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	/** Apply single random world change. */
+	void ApplyRandomChange(FGOAPSyntheticDomain& Domain, FRandomStream& Random) const;
+
+	/** Gather time of finished search. */
+	void OnSearchFinished(const UGOAPSolver* Solver, const FGOAPSearchStats& Stats);
+
+	/** Return given percentile (in range <0,1>) of sorted values. */
+	static double GetPercentile(const TArray<double>& SortedValues, double Percentile);
+
+	/** Times of all searches in milliseconds. */
+	TArray<double> SearchTimes;
+	/** Number of searches and longest search time in current frame. */
+	int32 FrameSearchesNum = 0;
+	double FrameMaxSearchTime = 0.0;
+};
@@ -0,0 +1,258 @@
+// Copyright Wiktor Wilga (wilgawiktor@gmail.com)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GOAPAction.h"
+#include "GOAPActionsExecutor.h"
+#include "GOAPAgent.h"
+#include "GOAPGoal.h"
+#include "GOAPPlanner.h"
+#include "GOAPWorldStateAtom.h"
+#include "GOAPSyntheticDomain.generated.h"
+
+class UGOAPWorldStateProvider;
+class UGOAPSyntheticActionsExecutor;
+
+/**
+ * Parameters of generated GOAP domain. Domain consists of layered actions: action of level L achieves "level L" state
+ * on any memory actor and requires "level L-1" state on the same actor. Initially only level 0 is met on all actors,
+ * so plan achieving level PlanDepth has exactly PlanDepth actions.
+ */
+struct GOAPBENCHMARK_API FGOAPSyntheticDomainSettings
+{
+	/** Max supported plan depth (number of level tags). */
+	static constexpr int32 MaxPlanDepth = 15;
+
+	/** Number of actions; they are distributed evenly over levels (branching factor is ActionsNum / PlanDepth). */
+	int32 ActionsNum = 8;
+	/** Number of actors in agent's memory. */
+	int32 MemoryActorsNum = 4;
+	/** Length of plan achieving the goal. */
+	int32 PlanDepth = 3;
+	/** Actions costs are random values in range <MinActionCost,MaxActionCost>. */
+	int32 MinActionCost = 1;
+	int32 MaxActionCost = 10;
+	/** Seed of random generator used to generate actions costs. */
+	int32 Seed = 0;
+
+	/** Agents' planners configuration. */
+	EGOAPGoalsEvaluationMode GoalsEvaluationMode = EGOAPGoalsEvaluationMode::Polling;
+	bool bUseScheduler = false;
+	/** Duration of each action performed by mock executor, in seconds. */
+	float ActionDuration = 0.5f;
+
+	/** Return short description of settings (used as scenario name in reports). */
+	FString ToString() const;
+};
+
+/**
+ * Native atom storing single value, exposed as bool (level atoms) or float (need atom) payload.
+ */
+UCLASS()
+class GOAPBENCHMARK_API UGOAPSyntheticAtom : public UGOAPWorldStateAtom
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Set tag, payload type and initial value of atom. */
+	void InitializeSyntheticAtom(const FGameplayTag& Tag, bool bInBoolValue, float InValue);
+	/** Change atom value and notify about the change. */
+	void SetValue(float InValue);
+	FORCEINLINE float GetValue() const { return Value; }
+
+	virtual void UpdateWorldStateAtomData_Implementation() override;
+
+private:
+
+	/** Current value. */
+	float Value = 0.0f;
+	/** True if value is exposed as bool payload. */
+	bool bBoolValue = true;
+};
+
+/**
+ * Native action of synthetic domain: achieves ProducedLevel on any actor, requires ProducedLevel-1 on the same actor.
+ */
+UCLASS()
+class GOAPBENCHMARK_API UGOAPSyntheticAction : public UObject, public IGOAPAction
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Set action parameters. */
+	void InitializeSyntheticAction(int32 InProducedLevel, int32 InCost);
+
+	virtual bool CanChangeWorldState_Implementation(FGOAPWorldStateData DesiredWorldState, AActor* AgentActor) override;
+	virtual TArray<FGOAPWorldStateData> GetWorldStatePreconditions_Implementation(FGOAPWorldStateData ForDesiredWorldState,
+		AActor* AgentActor) override;
+	virtual void SetActionTargetData_Implementation(FGOAPWorldStateData TargetData) override {}
+	virtual int32 GetActionCost_Implementation(FGOAPWorldStateData DesiredWorldState, AActor* AgentActor,
+		const TArray<FGOAPWorldStateData>& WithCurrentWorldState) override;
+	virtual bool GetActionEffectWithContextActor_Implementation(AActor* AgentActor, AActor* TargetActor,
+		FGOAPWorldStateData& EffectWorldState) override;
+	virtual bool CanBeCanceled_Implementation() override { return true; }
+
+private:
+
+	/** Level achieved by this action. */
+	int32 ProducedLevel = 1;
+	/** Cost of action. */
+	int32 Cost = 1;
+	/** Shared "true" value used for effects and preconditions. */
+	UPROPERTY()
+	FGOAPWorldStateValue TrueValue;
+};
+
+/**
+ * Goal of synthetic domain: achieve top level on agent's target actor. Scored natively from agent's need atom.
+ */
+UCLASS()
+class GOAPBENCHMARK_API UGOAPSyntheticGoal : public UGOAPGoal
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPSyntheticGoal();
+
+	/** Create goal for given agent outside of planner (e.g. to call solvers directly). */
+	static UGOAPSyntheticGoal* CreateForAgent(class AGOAPSyntheticAgent* Agent);
+
+	virtual void UpdateDesiredWorldState_Implementation() override;
+};
+
+/**
+ * Actor providing synthetic domain world state.
+ */
+UCLASS()
+class GOAPBENCHMARK_API AGOAPSyntheticActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	AGOAPSyntheticActor();
+
+	/** Create level atoms (level 0 met, other levels not met). */
+	void InitializeLevels(int32 PlanDepth);
+	/** Set value of level atom. */
+	void SetLevel(int32 Level, bool bMet);
+	/** Reset levels to initial state. */
+	void ResetLevels();
+
+	FORCEINLINE UGOAPWorldStateProvider* GetWorldStateProvider() const { return WorldStateProvider; }
+
+protected:
+
+	UPROPERTY()
+	UGOAPWorldStateProvider* WorldStateProvider;
+	
+	/** Level atoms, index is level. */
+	UPROPERTY()
+	TArray<UGOAPSyntheticAtom*> LevelAtoms;
+};
+
+/**
+ * Agent of synthetic domain.
+ */
+UCLASS()
+class GOAPBENCHMARK_API AGOAPSyntheticAgent : public AGOAPSyntheticActor, public IGOAPAgent
+{
+	GENERATED_BODY()
+
+public:
+
+	AGOAPSyntheticAgent();
+
+	virtual UGOAPPlanner* GetGOAPPlanner_Implementation() override { return Planner; }
+	virtual UGOAPMemoryComponent* GetGOAPMemoryComponent_Implementation() override { return MemoryComponent; }
+	FORCEINLINE UGOAPSyntheticActionsExecutor* GetActionsExecutor() const { return ActionsExecutor; }
+
+	/** Create need atom, configure planner and initialize it with given actions. */
+	void InitializeAgent(const TArray<UObject*>& Actions, const FGOAPSyntheticDomainSettings& Settings);
+
+	/** Set actor which agent wants to bring to top level. */
+	void SetTargetActor(AActor* InTargetActor) { TargetActor = InTargetActor; }
+	FORCEINLINE AActor* GetTargetActor() const { return TargetActor; }
+	FORCEINLINE int32 GetTopLevel() const { return TopLevel; }
+	/** Set agent's need (in range <0,1>), which is score of synthetic goal. */
+	void SetNeed(float Need);
+
+protected:
+
+	UPROPERTY()
+	UGOAPPlanner* Planner;
+	UPROPERTY()
+	UGOAPMemoryComponent* MemoryComponent;
+	UPROPERTY()
+	UGOAPSyntheticActionsExecutor* ActionsExecutor;
+	UPROPERTY()
+	UGOAPSyntheticAtom* NeedAtom;
+	
+	UPROPERTY()
+	AActor* TargetActor = nullptr;
+	int32 TopLevel = 1;
+};
+
+/**
+ * Mock actions executor: every action lasts ActionDuration and then applies its effect (planned target data) to world.
+ */
+UCLASS()
+class GOAPBENCHMARK_API UGOAPSyntheticActionsExecutor : public UActorComponent, public IGOAPActionsExecutor
+{
+	GENERATED_BODY()
+
+public:
+
+	UGOAPSyntheticActionsExecutor();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	virtual void CancelAction_Implementation(UObject* Action) override;
+	virtual UObject* GetActiveAction_Implementation() override;
+	virtual bool TryActivateActionByClass_Implementation(TSubclassOf<UObject> ActionClass) override;
+
+	/** Duration of each action in seconds. */
+	float ActionDuration = 0.5f;
+	/** Chance (in range <0,1>) that action fails. */
+	float FailureChance = 0.0f;
+
+private:
+
+	/** Class of currently performed action; nullptr if none. */
+	UPROPERTY()
+	UClass* ActiveActionClass = nullptr;
+	/** Time left to finish current action. */
+	float RemainingTime = 0.0f;
+};
+
+/**
+ * Generated synthetic GOAP domain spawned in given world.
+ */
+struct GOAPBENCHMARK_API FGOAPSyntheticDomain
+{
+	/** Return tag of given level state. */
+	static FGameplayTag GetLevelTag(int32 Level);
+	/** Return tag of agent's need. */
+	static FGameplayTag GetNeedTag();
+
+	/** Create world which can be used without running game (e.g. in commandlets). */
+	static UWorld* CreateWorld(const FName& WorldName);
+	/** Destroy world created by CreateWorld. */
+	static void DestroyWorld(UWorld* World);
+
+	/** Spawn memory actors, generate actions and spawn given number of agents knowing all memory actors. */
+	void Build(UWorld* World, const FGOAPSyntheticDomainSettings& InSettings, int32 AgentsNum = 1);
+	/** Reset world state of all actors to initial one. */
+	void ResetWorldState();
+
+	FGOAPSyntheticDomainSettings Settings;
+	TArray<AGOAPSyntheticAgent*> Agents;
+	TArray<AGOAPSyntheticActor*> MemoryActors;
+	/** Actions shared by all agents. */
+	TArray<UObject*> Actions;
+};